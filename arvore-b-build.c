@@ -8,13 +8,18 @@
  */
 
 #include "arvore-b.h"
+#include "filtro-bloom.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 
 #define INVALIDO -1
 
+// Lista de páginas livres vazia: bytes originais do lixo do cabeçalho
+#define TOPO_LIVRES_VAZIO "$$$$"
+
 
 /**
  * @brief Inicializa o cabeçalho da árvore-B
@@ -32,19 +37,11 @@ void inicializaCabecalhoArvoreB(FILE *fp) {
     cab.noRaiz = -1;
     cab.proxRRN = 0;
     cab.nroNos = 0;
-    memset(cab.lixo, '$', 31);
-    
-    if (fseek(fp, 0, SEEK_SET) != 0) return;
-    
-    if (fwrite(&cab.status, sizeof(char), 1, fp) != 1 ||
-        fwrite(&cab.noRaiz, sizeof(int), 1, fp) != 1 ||
-        fwrite(&cab.proxRRN, sizeof(int), 1, fp) != 1 ||
-        fwrite(&cab.nroNos, sizeof(int), 1, fp) != 1 ||
-        fwrite(&cab.lixo, sizeof(char), 31, fp) != 31) {
-        return;
-    }
+    cab.topoLivres = INVALIDO;
+    cab.filtroDesatualizado = FILTRO_EM_DIA;
+    memset(cab.lixo, '$', 26);
     
-    fflush(fp);
+    escreverCabecalhoArvoreB(fp, &cab);
 }
 
 /**
@@ -86,7 +83,14 @@ void escreverCabecalhoArvoreB(FILE *fp, CabecalhoArvoreB *cab) {
     fwrite(&cab->noRaiz, sizeof(int), 1, fp);
     fwrite(&cab->proxRRN, sizeof(int), 1, fp);
     fwrite(&cab->nroNos, sizeof(int), 1, fp);
-    fwrite(&cab->lixo, sizeof(char), 31, fp);
+    if (cab->topoLivres == INVALIDO) {
+        // Lista vazia mantém o lixo original, compatível com índices antigos
+        fwrite(TOPO_LIVRES_VAZIO, sizeof(char), 4, fp);
+    } else {
+        fwrite(&cab->topoLivres, sizeof(int), 1, fp);
+    }
+    fwrite(&cab->filtroDesatualizado, sizeof(char), 1, fp);
+    fwrite(&cab->lixo, sizeof(char), 26, fp);
     fflush(fp);
 }
 
@@ -104,6 +108,7 @@ void lerCabecalhoArvoreB(FILE *fp, CabecalhoArvoreB *cab) {
     
     // Salva a posição atual do ponteiro do arquivo
     long posicaoOriginal = ftell(fp);
+    char topo[4];
     
     // Vai para o início do arquivo para ler o cabeçalho
     if (fseek(fp, 0, SEEK_SET) != 0) {
@@ -117,13 +122,21 @@ void lerCabecalhoArvoreB(FILE *fp, CabecalhoArvoreB *cab) {
         fread(&cab->noRaiz, sizeof(int), 1, fp) != 1 ||
         fread(&cab->proxRRN, sizeof(int), 1, fp) != 1 ||
         fread(&cab->nroNos, sizeof(int), 1, fp) != 1 ||
-        fread(&cab->lixo, sizeof(char), 31, fp) != 31) {
+        fread(topo, sizeof(char), 4, fp) != 4 ||
+        fread(&cab->filtroDesatualizado, sizeof(char), 1, fp) != 1 ||
+        fread(&cab->lixo, sizeof(char), 26, fp) != 26) {
         // Em caso de erro, inicializa com valores padrão
         cab->status = '0';
         cab->noRaiz = -1;
         cab->proxRRN = 0;
         cab->nroNos = 0;
-        memset(cab->lixo, '$', 31);
+        cab->topoLivres = INVALIDO;
+        cab->filtroDesatualizado = FILTRO_EM_DIA;
+        memset(cab->lixo, '$', 26);
+    } else if (memcmp(topo, TOPO_LIVRES_VAZIO, 4) == 0) {
+        cab->topoLivres = INVALIDO;
+    } else {
+        memcpy(&cab->topoLivres, topo, sizeof(int));
     }
     
     // Restaura a posição original do ponteiro do arquivo
@@ -204,12 +217,290 @@ void lerPaginaArvoreB(FILE *fp, int rrn, PaginaArvoreB *pag) {
 }
 
 
+/**
+ * @brief Obtém um RRN para uma nova página
+ * 
+ * Desempilha a primeira página da lista de livres, cujo ponteiro P1
+ * guarda o RRN da próxima página livre. Com a lista vazia, a página é
+ * acrescentada ao final do arquivo (proxRRN).
+ * 
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @return RRN da página alocada
+ */
+int alocarPaginaArvoreB(FILE *fp, CabecalhoArvoreB *cab) {
+    if (cab->topoLivres != INVALIDO) {
+        PaginaArvoreB livre;
+        lerPaginaArvoreB(fp, cab->topoLivres, &livre);
+        if (livre.tipoNo == PAGINA_LIVRE) {
+            int rrn = cab->topoLivres;
+            cab->topoLivres = livre.ponteiros[0];
+            return rrn;
+        }
+        // Lista corrompida: descarta e volta a crescer o arquivo
+        cab->topoLivres = INVALIDO;
+    }
+    return cab->proxRRN++;
+}
+
+/**
+ * @brief Transforma uma página em memória em página livre
+ * 
+ * A página passa a ter tipoNo PAGINA_LIVRE e P1 apontando para a antiga
+ * primeira página livre; o topo da lista passa a ser o RRN informado.
+ * 
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param pag Página a ser liberada (gravada por quem chama)
+ * @param rrn RRN da página
+ */
+void liberarPaginaArvoreB(CabecalhoArvoreB *cab, PaginaArvoreB *pag, int rrn) {
+    inicializaPagina(pag, PAGINA_LIVRE);
+    pag->ponteiros[0] = cab->topoLivres;
+    pag->rrn = rrn;
+    cab->topoLivres = rrn;
+}
+
+/**
+ * @brief Par (chave, byte offset) usado na ordenação do lote
+ */
+typedef struct {
+    int id;
+    long long pr;
+} EntradaLote;
+
+static int compararEntradaLote(const void *a, const void *b) {
+    const EntradaLote *x = a, *y = b;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+/**
+ * @brief Grava as páginas alteradas do caminho e o esvazia
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param caminho Caminho mantido em memória
+ * @param rrns RRN de cada página do caminho
+ */
+static void descarregarCaminho(FILE *fp, CaminhoArvoreB *caminho, int rrns[]) {
+    for (int nivel = 0; nivel < caminho->altura; nivel++) {
+        if (caminho->sujas[nivel]) {
+            escreverPaginaArvoreB(fp, rrns[nivel], &caminho->paginas[nivel]);
+            caminho->sujas[nivel] = false;
+        }
+    }
+    caminho->altura = 0;
+}
+
+/**
+ * @brief Desce da raiz até a folha de id, registrando o caminho e seus limites
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param caminho Caminho a ser preenchido
+ * @param rrns RRN de cada página do caminho
+ * @param id Chave que guia a descida
+ */
+static void fixarCaminho(FILE *fp, CabecalhoArvoreB *cab, CaminhoArvoreB *caminho, int rrns[], int id) {
+    caminho->altura = 0;
+
+    long long inf = LLONG_MIN, sup = LLONG_MAX;
+    int rrn = cab->noRaiz;
+    while (rrn != INVALIDO && caminho->altura < ALTURA_MAX) {
+        int nivel = caminho->altura++;
+        PaginaArvoreB *pag = &caminho->paginas[nivel];
+        lerPaginaArvoreB(fp, rrn, pag);
+        rrns[nivel] = rrn;
+        caminho->sujas[nivel] = false;
+        caminho->limiteInf[nivel] = inf;
+        caminho->limiteSup[nivel] = sup;
+
+        if (pag->tipoNo == -1) break;
+
+        int i = 0;
+        while (i < pag->nroChaves && id >= pag->chaves[i]) i++;
+        caminho->indices[nivel] = i;
+        if (i > 0) inf = pag->chaves[i - 1];
+        if (i < pag->nroChaves) sup = pag->chaves[i];
+        rrn = pag->ponteiros[i];
+    }
+}
+
+/**
+ * @brief Insere (chave, pr, filho direito) no nível indicado do caminho fixado
+ *
+ * Divisão de página cheia: a primeira chave fica na página original, a do
+ * meio sobe e a terceira vai para a nova página. Após cada divisão continua
+ * fixada a metade onde cairia uma chave maior que a inserida (a próxima de
+ * um lote ordenado), e a outra metade é gravada imediatamente por sair do
+ * caminho.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param caminho Caminho fixado
+ * @param rrns RRN de cada página do caminho
+ * @param id Chave a inserir
+ * @param pr Byte offset da chave
+ */
+static void inserirNoCaminho(FILE *fp, CabecalhoArvoreB *cab, CaminhoArvoreB *caminho, int rrns[], int id, long long pr) {
+    int nivel = caminho->altura - 1;
+    int chave = id;
+    long long prChave = pr;
+    int ponteiroDir = INVALIDO;
+    bool fixadoDireita = false; // Metade fixada no nível de baixo é a nova página
+
+    while (nivel >= 0) {
+        PaginaArvoreB *pag = &caminho->paginas[nivel];
+        bool folha = (pag->tipoNo == -1);
+
+        if (pag->nroChaves < MAX_CHAVES) {
+            int pos;
+            for (pos = pag->nroChaves - 1; pos >= 0 && pag->chaves[pos] > chave; pos--) {
+                pag->chaves[pos + 1] = pag->chaves[pos];
+                pag->pr[pos + 1] = pag->pr[pos];
+                if (!folha) pag->ponteiros[pos + 2] = pag->ponteiros[pos + 1];
+            }
+            pag->chaves[pos + 1] = chave;
+            pag->pr[pos + 1] = prChave;
+            if (!folha) pag->ponteiros[pos + 2] = ponteiroDir;
+            pag->nroChaves++;
+            caminho->sujas[nivel] = true;
+
+            // O filho fixado no nível de baixo passa a ser o da direita da chave inserida
+            if (!folha) {
+                caminho->indices[nivel] = fixadoDireita ? pos + 2 : pos + 1;
+            }
+            return;
+        }
+
+        // Página cheia: monta arrays temporários com a nova chave
+        int tempChaves[MAX_CHAVES + 1];
+        long long tempPr[MAX_CHAVES + 1];
+        int tempPonteiros[MAX_PONTEIROS + 1];
+        for (int j = 0; j < MAX_CHAVES; j++) {
+            tempChaves[j] = pag->chaves[j];
+            tempPr[j] = pag->pr[j];
+        }
+        for (int j = 0; j < MAX_PONTEIROS; j++) {
+            tempPonteiros[j] = pag->ponteiros[j];
+        }
+        int pos;
+        for (pos = MAX_CHAVES - 1; pos >= 0 && tempChaves[pos] > chave; pos--) {
+            tempChaves[pos + 1] = tempChaves[pos];
+            tempPr[pos + 1] = tempPr[pos];
+            tempPonteiros[pos + 2] = tempPonteiros[pos + 1];
+        }
+        pos++;
+        tempChaves[pos] = chave;
+        tempPr[pos] = prChave;
+        tempPonteiros[pos + 1] = ponteiroDir;
+
+        PaginaArvoreB nova;
+        inicializaPagina(&nova, folha ? -1 : 1);
+        nova.chaves[0] = tempChaves[2];
+        nova.pr[0] = tempPr[2];
+        nova.nroChaves = 1;
+        if (!folha) {
+            nova.ponteiros[0] = tempPonteiros[2];
+            nova.ponteiros[1] = tempPonteiros[3];
+        }
+
+        pag->chaves[0] = tempChaves[0];
+        pag->pr[0] = tempPr[0];
+        for (int j = 1; j < MAX_CHAVES; j++) {
+            pag->chaves[j] = -1;
+            pag->pr[j] = -1;
+        }
+        if (!folha) {
+            pag->ponteiros[0] = tempPonteiros[0];
+            pag->ponteiros[1] = tempPonteiros[1];
+            for (int j = 2; j < MAX_PONTEIROS; j++) {
+                pag->ponteiros[j] = INVALIDO;
+            }
+        }
+        pag->nroChaves = 1;
+
+        // A antiga raiz deixa de ser raiz
+        if (nivel == 0 && pag->tipoNo == 0) {
+            pag->tipoNo = (pag->ponteiros[0] != INVALIDO) ? 1 : -1;
+        }
+
+        int rrnNova = alocarPaginaArvoreB(fp, cab);
+        cab->nroNos++;
+
+        // Decide qual metade continua no caminho
+        bool direita;
+        if (folha) {
+            direita = (pos >= 1); // A chave inserida não ficou na metade esquerda
+        } else {
+            direita = fixadoDireita ? (pos + 1 >= 2) : (pos >= 2);
+        }
+
+        if (direita) {
+            escreverPaginaArvoreB(fp, rrns[nivel], pag);
+            *pag = nova;
+            rrns[nivel] = rrnNova;
+            caminho->limiteInf[nivel] = tempChaves[1];
+            if (!folha) caminho->indices[nivel] = (fixadoDireita ? pos + 1 : pos) - 2;
+        } else {
+            escreverPaginaArvoreB(fp, rrnNova, &nova);
+            caminho->limiteSup[nivel] = tempChaves[1];
+            if (!folha) caminho->indices[nivel] = fixadoDireita ? pos + 1 : pos;
+        }
+        caminho->sujas[nivel] = true;
+
+        chave = tempChaves[1];
+        prChave = tempPr[1];
+        ponteiroDir = rrnNova;
+        fixadoDireita = direita;
+        nivel--;
+    }
+
+    // A raiz foi dividida: nova raiz no topo do caminho
+    int rrnAntigaRaiz = cab->noRaiz;
+    int h = caminho->altura;
+    if (h >= ALTURA_MAX) {
+        // Caminho não comporta mais um nível; grava e abandona o caminho
+        descarregarCaminho(fp, caminho, rrns);
+        h = 0;
+    }
+    for (int j = h; j > 0; j--) {
+        caminho->paginas[j] = caminho->paginas[j - 1];
+        caminho->indices[j] = caminho->indices[j - 1];
+        caminho->sujas[j] = caminho->sujas[j - 1];
+        caminho->limiteInf[j] = caminho->limiteInf[j - 1];
+        caminho->limiteSup[j] = caminho->limiteSup[j - 1];
+        rrns[j] = rrns[j - 1];
+    }
+
+    PaginaArvoreB *novaRaiz = &caminho->paginas[0];
+    inicializaPagina(novaRaiz, 0);
+    novaRaiz->chaves[0] = chave;
+    novaRaiz->pr[0] = prChave;
+    novaRaiz->ponteiros[0] = rrnAntigaRaiz;
+    novaRaiz->ponteiros[1] = ponteiroDir;
+    novaRaiz->nroChaves = 1;
+
+    int rrnRaiz = alocarPaginaArvoreB(fp, cab);
+    rrns[0] = rrnRaiz;
+    caminho->indices[0] = fixadoDireita ? 1 : 0;
+    caminho->sujas[0] = true;
+    caminho->limiteInf[0] = LLONG_MIN;
+    caminho->limiteSup[0] = LLONG_MAX;
+    caminho->altura = (h == 0) ? 0 : h + 1;
+
+    if (h == 0) {
+        escreverPaginaArvoreB(fp, rrnRaiz, novaRaiz);
+    }
+
+    cab->noRaiz = rrnRaiz;
+    cab->nroNos++;
+}
+
 /**
  * @brief Função principal de inserção na árvore-B
  * 
- * Coordena a inserção de uma nova chave na árvore-B, tratando tanto
- * o caso de árvore vazia quanto inserções em árvores existentes.
- * Gerencia splits e criação de nova raiz quando necessário.
+ * Lê o cabeçalho, delega a inserção para inserirComCabecalho e
+ * regrava o cabeçalho atualizado, marcando o filtro de Bloom do índice
+ * como desatualizado.
  * 
  * @param btreeFile Ponteiro para o arquivo da árvore-B
  * @param id ID do registro (chave)
@@ -219,57 +510,56 @@ void btree_insert(FILE *btreeFile, int id, long long byteOffset) {
     CabecalhoArvoreB cab;
     lerCabecalhoArvoreB(btreeFile, &cab);
 
-    if (cab.noRaiz == -1) {
+    inserirComCabecalho(btreeFile, &cab, id, byteOffset);
+
+    // Inserção fora de uma sessão não atualiza o filtro de Bloom
+    cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+    escreverCabecalhoArvoreB(btreeFile, &cab);
+}
+
+/**
+ * @brief Insere uma chave usando um cabeçalho já carregado em memória
+ * 
+ * Inserção iterativa: a descida registra as páginas visitadas e o índice
+ * do filho seguido em cada nível; os splits são resolvidos na subida com
+ * essas páginas em memória, inclusive a correção do tipo da antiga raiz,
+ * sem reler nenhuma página. Apenas o cabeçalho em memória é alterado;
+ * quem chama decide quando gravá-lo.
+ * 
+ * @param btreeFile Ponteiro para o arquivo da árvore-B
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ */
+void inserirComCabecalho(FILE *btreeFile, CabecalhoArvoreB *cab, int id, long long byteOffset) {
+    if (cab->noRaiz == -1) {
         // Primeira inserção - cria a raiz
         PaginaArvoreB nova;
         inicializaPagina(&nova, -1); // Nó folha (que também é raiz inicial)
         nova.chaves[0] = id;
         nova.pr[0] = byteOffset;
         nova.nroChaves = 1;
-        escreverPaginaArvoreB(btreeFile, cab.proxRRN, &nova);
-        cab.noRaiz = cab.proxRRN;
-        cab.proxRRN++;
-        cab.nroNos++;
-        escreverCabecalhoArvoreB(btreeFile, &cab);
+        int rrnRaiz = alocarPaginaArvoreB(btreeFile, cab);
+        escreverPaginaArvoreB(btreeFile, rrnRaiz, &nova);
+        cab->noRaiz = rrnRaiz;
+        cab->nroNos++;
         return;
     }
 
-    // Inserção recursiva
-    ResultadoSplit resultado = inserirRecursivo(btreeFile, &cab, cab.noRaiz, id, byteOffset);
+    CaminhoArvoreB caminho;
+    int rrns[ALTURA_MAX];
 
-    if (resultado.houveSplit) {
-        // Quando há split da raiz, a antiga raiz precisa ter tipo atualizado
-        // Lê a antiga raiz para saber seu tipo atual
-        PaginaArvoreB antigaRaiz;
-        lerPaginaArvoreB(btreeFile, resultado.ponteiroEsq, &antigaRaiz);
-        
-        // Atualiza o tipo da antiga raiz baseado em seu conteúdo
-        if (antigaRaiz.tipoNo == 0) {
-            // Era raiz, agora precisa ser classificada pelo seu conteúdo
-            if (antigaRaiz.ponteiros[0] != INVALIDO) {
-                antigaRaiz.tipoNo = 1; // Intermediária
-            } else {
-                antigaRaiz.tipoNo = -1; // Folha
-            }
-            escreverPaginaArvoreB(btreeFile, resultado.ponteiroEsq, &antigaRaiz);
-        }
-        
-        // Cria nova raiz para acomodar o split
-        PaginaArvoreB novaRaiz;
-        inicializaPagina(&novaRaiz, 0); // Nova raiz
-        novaRaiz.chaves[0] = resultado.chavePromovida;
-        novaRaiz.pr[0] = resultado.prPromovido;
-        novaRaiz.ponteiros[0] = resultado.ponteiroEsq;
-        novaRaiz.ponteiros[1] = resultado.ponteiroDir;
-        novaRaiz.nroChaves = 1;
-
-        escreverPaginaArvoreB(btreeFile, cab.proxRRN, &novaRaiz);
-        cab.noRaiz = cab.proxRRN;
-        cab.proxRRN++;
-        cab.nroNos++;
+    // Descida: cada página do caminho é lida uma única vez
+    fixarCaminho(btreeFile, cab, &caminho, rrns, id);
+    if (caminho.altura == 0 || caminho.paginas[caminho.altura - 1].tipoNo != -1) {
+        return; // Erro - ponteiro inválido no caminho
     }
 
-    escreverCabecalhoArvoreB(btreeFile, &cab);
+    // Subida: splits resolvidos com as páginas já em memória
+    inserirNoCaminho(btreeFile, cab, &caminho, rrns, id, byteOffset);
+
+    // Grava apenas as páginas alteradas
+    descarregarCaminho(btreeFile, &caminho, rrns);
 }
 
 
@@ -296,211 +586,6 @@ void insereOrdenadoNaPagina(PaginaArvoreB *pag, int id, long long pr) {
     pag->nroChaves++;
 }
 
-/**
- * @brief Função recursiva para inserção na árvore-B
- * 
- * Implementa a lógica recursiva de inserção, tratando casos de:
- * - Inserção em nó folha com espaço disponível
- * - Split de nó folha quando cheio
- * - Inserção em nó interno e propagação de splits
- * - Split de nó interno quando necessário
- * 
- * @param fp Ponteiro para o arquivo
- * @param cab Ponteiro para o cabeçalho
- * @param rrnAtual RRN do nó atual
- * @param id ID do registro a ser inserido
- * @param pr Byte offset do registro
- * @return Resultado da operação de split
- */
-ResultadoSplit inserirRecursivo(FILE *fp, CabecalhoArvoreB *cab, int rrnAtual, int id, long long pr) {
-    ResultadoSplit resultado = {false, 0, 0, INVALIDO, INVALIDO};
-    PaginaArvoreB pagina;
-    
-    lerPaginaArvoreB(fp, rrnAtual, &pagina);
-    
-    // Caso 1: Nó folha
-    if (pagina.tipoNo == -1) {
-        if (pagina.nroChaves < MAX_CHAVES) {
-            // Tem espaço, insere diretamente
-            insereOrdenadoNaPagina(&pagina, id, pr);
-            escreverPaginaArvoreB(fp, rrnAtual, &pagina);
-            return resultado; // Sem split
-        } else {
-            // Folha cheia, precisa dividir (split)
-            int tempChaves[MAX_CHAVES + 1];
-            long long tempPr[MAX_CHAVES + 1];
-            
-            // Copia chaves existentes
-            for (int i = 0; i < MAX_CHAVES; i++) {
-                tempChaves[i] = pagina.chaves[i];
-                tempPr[i] = pagina.pr[i];
-            }
-            
-            // Insere nova chave ordenadamente
-            int pos = MAX_CHAVES;
-            while (pos > 0 && tempChaves[pos - 1] > id) {
-                tempChaves[pos] = tempChaves[pos - 1];
-                tempPr[pos] = tempPr[pos - 1];
-                pos--;
-            }
-            tempChaves[pos] = id;
-            tempPr[pos] = pr;
-            
-            // Cria nova folha para a direita
-            PaginaArvoreB novaFolha;
-            inicializaPagina(&novaFolha, -1); // Mantém como folha
-            
-            // Distribui as chaves: primeira fica na folha original
-            pagina.chaves[0] = tempChaves[0];
-            pagina.pr[0] = tempPr[0];
-            // Limpa posições não utilizadas
-            for (int i = 1; i < MAX_CHAVES; i++) {
-                pagina.chaves[i] = -1;
-                pagina.pr[i] = -1;
-            }
-            pagina.nroChaves = 1;
-            
-            // Terceira chave vai para nova folha
-            novaFolha.chaves[0] = tempChaves[2];
-            novaFolha.pr[0] = tempPr[2];
-            // Limpa posições não utilizadas
-            for (int i = 1; i < MAX_CHAVES; i++) {
-                novaFolha.chaves[i] = -1;
-                novaFolha.pr[i] = -1;
-            }
-            novaFolha.nroChaves = 1;
-            
-            // Escreve as páginas atualizadas
-            escreverPaginaArvoreB(fp, rrnAtual, &pagina);
-            escreverPaginaArvoreB(fp, cab->proxRRN, &novaFolha);
-            
-            // Prepara resultado para promoção (chave do meio sobe)
-            resultado.houveSplit = true;
-            resultado.chavePromovida = tempChaves[1]; // Chave do meio
-            resultado.prPromovido = tempPr[1]; // Preserva o byte offset
-            resultado.ponteiroEsq = rrnAtual;
-            resultado.ponteiroDir = cab->proxRRN;
-            
-            cab->proxRRN++;
-            cab->nroNos++;
-            
-            return resultado;
-        }
-    } else {
-        // Caso 2: Nó interno - encontra filho correto para inserção
-        int i;
-        for (i = 0; i < pagina.nroChaves; i++) {
-            if (id < pagina.chaves[i]) {
-                break;
-            }
-        }
-        
-        int filhoRRN = pagina.ponteiros[i];
-        if (filhoRRN == INVALIDO) {
-            return resultado; // Erro - ponteiro inválido
-        }
-        
-        // Chama recursivamente para o filho apropriado
-        ResultadoSplit resultadoFilho = inserirRecursivo(fp, cab, filhoRRN, id, pr);
-        
-        if (!resultadoFilho.houveSplit) {
-            return resultado; // Não houve split no filho
-        }
-        
-        // Houve split no filho, precisa inserir chave promovida
-        if (pagina.nroChaves < MAX_CHAVES) {
-            // Tem espaço no nó atual para a chave promovida
-            // Insere a chave promovida ordenadamente
-            int pos;
-            for (pos = pagina.nroChaves - 1; pos >= 0 && pagina.chaves[pos] > resultadoFilho.chavePromovida; pos--) {
-                pagina.chaves[pos + 1] = pagina.chaves[pos];
-                pagina.pr[pos + 1] = pagina.pr[pos];
-                pagina.ponteiros[pos + 2] = pagina.ponteiros[pos + 1];
-            }
-            
-            pagina.chaves[pos + 1] = resultadoFilho.chavePromovida;
-            pagina.pr[pos + 1] = resultadoFilho.prPromovido; // Preserva o byte offset
-            pagina.ponteiros[pos + 1] = resultadoFilho.ponteiroEsq;
-            pagina.ponteiros[pos + 2] = resultadoFilho.ponteiroDir;
-            pagina.nroChaves++;
-            
-            escreverPaginaArvoreB(fp, rrnAtual, &pagina);
-            return resultado; // Sem split
-        } else {
-            // Nó interno cheio, precisa dividir (split)
-            int tempChaves[MAX_CHAVES + 1];
-            long long tempPr[MAX_CHAVES + 1];
-            int tempPonteiros[MAX_PONTEIROS + 1];
-            
-            // Copia dados existentes para arrays temporários
-            for (int j = 0; j < MAX_CHAVES; j++) {
-                tempChaves[j] = pagina.chaves[j];
-                tempPr[j] = pagina.pr[j];
-            }
-            for (int j = 0; j < MAX_PONTEIROS; j++) {
-                tempPonteiros[j] = pagina.ponteiros[j];
-            }
-            
-            // Insere chave promovida ordenadamente nos arrays temporários
-            int pos;
-            for (pos = MAX_CHAVES - 1; pos >= 0 && tempChaves[pos] > resultadoFilho.chavePromovida; pos--) {
-                tempChaves[pos + 1] = tempChaves[pos];
-                tempPr[pos + 1] = tempPr[pos];
-                tempPonteiros[pos + 2] = tempPonteiros[pos + 1];
-            }
-            
-            tempChaves[pos + 1] = resultadoFilho.chavePromovida;
-            tempPr[pos + 1] = resultadoFilho.prPromovido; // Preserva o byte offset
-            tempPonteiros[pos + 1] = resultadoFilho.ponteiroEsq;
-            tempPonteiros[pos + 2] = resultadoFilho.ponteiroDir;
-            
-            // Cria novo nó interno para a direita
-            PaginaArvoreB novoInterno;
-            inicializaPagina(&novoInterno, 1); // Marca como nó intermediário
-            
-            // Distribui as chaves: primeira fica no nó original
-            pagina.chaves[0] = tempChaves[0];
-            pagina.pr[0] = tempPr[0]; // Preserva o byte offset
-            pagina.ponteiros[0] = tempPonteiros[0];
-            pagina.ponteiros[1] = tempPonteiros[1];
-            // Limpa posições não utilizadas
-            for (int i = 1; i < MAX_CHAVES; i++) {
-                pagina.chaves[i] = -1;
-                pagina.pr[i] = -1;
-            }
-            for (int i = 2; i < MAX_PONTEIROS; i++) {
-                pagina.ponteiros[i] = INVALIDO;
-            }
-            pagina.nroChaves = 1;
-            
-            // Terceira chave vai para novo nó
-            novoInterno.chaves[0] = tempChaves[2];
-            novoInterno.pr[0] = tempPr[2]; // Preserva o byte offset
-            novoInterno.ponteiros[0] = tempPonteiros[2];
-            novoInterno.ponteiros[1] = tempPonteiros[3];
-            novoInterno.nroChaves = 1;
-            
-            // Escreve as páginas atualizadas
-            escreverPaginaArvoreB(fp, rrnAtual, &pagina);
-            escreverPaginaArvoreB(fp, cab->proxRRN, &novoInterno);
-            
-            // Prepara resultado para promoção (chave do meio sobe)
-            resultado.houveSplit = true;
-            resultado.chavePromovida = tempChaves[1];
-            resultado.prPromovido = tempPr[1]; // Preserva o byte offset da chave do meio
-            resultado.ponteiroEsq = rrnAtual;
-            resultado.ponteiroDir = cab->proxRRN;
-            
-            cab->proxRRN++;
-            cab->nroNos++;
-            
-            return resultado;
-        }
-    }
-}
-
-
-
 /**
  * @brief Busca uma chave na árvore-B
  * 
@@ -520,9 +605,24 @@ long long btree_search(FILE *fp, int id) {
         return -1;
     }
     
-    if (cab.noRaiz == -1) return -1;
+    return buscarComCabecalho(fp, &cab, id);
+}
 
-    int rrn = cab.noRaiz;
+/**
+ * @brief Busca uma chave a partir de um cabeçalho já carregado em memória
+ * 
+ * Não verifica o status do arquivo: é usada também por sessões, que
+ * mantêm o índice marcado como inconsistente no disco enquanto abertas.
+ * 
+ * @param fp Ponteiro para o arquivo da árvore-B
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param id ID do registro a ser buscado
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long buscarComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int id) {
+    if (cab->noRaiz == -1) return -1;
+
+    int rrn = cab->noRaiz;
     while (1) {
         PaginaArvoreB pag;
         lerPaginaArvoreB(fp, rrn, &pag);
@@ -546,3 +646,73 @@ long long btree_search(FILE *fp, int id) {
     return -1;
 }
 
+
+
+/**
+ * @brief Insere um lote de chaves reaproveitando o caminho raiz-folha
+ * 
+ * Ordena o lote e mantém fixado em memória o caminho até a folha corrente.
+ * Enquanto a próxima chave cair no intervalo dessa folha, ela é inserida
+ * sem nova descida; divisões sobem pelo caminho já carregado. Páginas só
+ * são gravadas quando saem do caminho ou ao final do lote, de modo que
+ * IDs crescentes custam cerca de uma escrita de folha por página preenchida.
+ * O resultado é a mesma árvore que inserções individuais na ordem crescente.
+ * Cada chave entra também no filtro de Bloom da sessão.
+ * 
+ * @param sessao Sessão aberta
+ * @param ids IDs dos registros (não precisam estar ordenados)
+ * @param offsets Byte offsets correspondentes
+ * @param n Número de chaves do lote
+ */
+void btree_insert_batch(SessaoArvoreB *sessao, const int ids[], const long long offsets[], int n) {
+    if (!sessao || n <= 0) return;
+
+    EntradaLote *lote = malloc(sizeof(EntradaLote) * n);
+    if (!lote) return;
+    for (int i = 0; i < n; i++) {
+        lote[i].id = ids[i];
+        lote[i].pr = offsets[i];
+    }
+    qsort(lote, n, sizeof(EntradaLote), compararEntradaLote);
+
+    FILE *fp = sessao->fp;
+    CabecalhoArvoreB *cab = &sessao->cab;
+    CaminhoArvoreB *caminho = malloc(sizeof(CaminhoArvoreB));
+    int rrns[ALTURA_MAX];
+    if (!caminho) {
+        free(lote);
+        return;
+    }
+    caminho->altura = 0;
+
+    for (int i = 0; i < n; i++) {
+        int id = lote[i].id;
+
+        bloom_adicionar(sessao->filtro, id);
+
+        if (cab->noRaiz == INVALIDO) {
+            inserirComCabecalho(fp, cab, id, lote[i].pr);
+            continue;
+        }
+
+        int folha = caminho->altura - 1;
+        if (caminho->altura == 0 ||
+            !(caminho->limiteInf[folha] < id && id < caminho->limiteSup[folha])) {
+            // Chave fora da folha fixada: grava o caminho e desce de novo
+            descarregarCaminho(fp, caminho, rrns);
+            fixarCaminho(fp, cab, caminho, rrns, id);
+            if (caminho->altura == 0 || caminho->paginas[caminho->altura - 1].tipoNo != -1) {
+                // Árvore inconsistente: recorre à inserção comum
+                caminho->altura = 0;
+                inserirComCabecalho(fp, cab, id, lote[i].pr);
+                continue;
+            }
+        }
+
+        inserirNoCaminho(fp, cab, caminho, rrns, id, lote[i].pr);
+    }
+
+    descarregarCaminho(fp, caminho, rrns);
+    free(caminho);
+    free(lote);
+}
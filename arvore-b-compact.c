@@ -0,0 +1,389 @@
+/**
+ * @file arvore-b-compact.c
+ * @brief Compactação da árvore-B em ordem de chave
+ *
+ * Reconstrói um índice consistente em um arquivo novo: as chaves são
+ * lidas em ordem, a árvore é montada de baixo para cima com o fator de
+ * preenchimento pedido e as páginas são gravadas em ordem de largura
+ * (nível a nível) ou de van Emde Boas, de forma que uma descida visite
+ * páginas próximas no arquivo. O arquivo novo substitui o antigo com
+ * rename(), que é atômico.
+ */
+
+#include "arvore-b.h"
+#include "filtro-bloom.h"
+#include "wal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#define INVALIDO -1
+
+/**
+ * @brief Nó da árvore montada em memória durante a compactação
+ */
+typedef struct {
+    int nroChaves;
+    int chaves[MAX_CHAVES];
+    long long pr[MAX_CHAVES];
+    int filhos[MAX_PONTEIROS];   // Índices em nos[] (-1 em folhas)
+} NoCompactacao;
+
+/**
+ * @brief Árvore montada em memória
+ */
+typedef struct {
+    NoCompactacao *nos;
+    int nroNos;
+    int altura;                  // Número de níveis
+    int inicioNivel[ALTURA_MAX]; // Primeiro nó de cada nível (0 = folhas)
+    int fimNivel[ALTURA_MAX];    // Um após o último nó de cada nível
+} ArvoreCompactacao;
+
+/**
+ * @brief Percurso em ordem limitado a [lo, hi], com controle de profundidade
+ */
+static int coletarEmOrdem(FILE *fp, int rrn, int profundidade, int lo, int hi, int *chaves, long long *pr, int n, int capacidade) {
+    if (rrn == INVALIDO) return n;
+    if (profundidade >= ALTURA_MAX) return -1;
+
+    PaginaArvoreB pag;
+    lerPaginaArvoreB(fp, rrn, &pag);
+    if (pag.nroChaves < 0 || pag.nroChaves > MAX_CHAVES || pag.tipoNo == PAGINA_LIVRE) return -1;
+
+    bool folha = (pag.tipoNo == -1 || pag.ponteiros[0] == INVALIDO);
+    for (int i = 0; i <= pag.nroChaves; i++) {
+        // Filho i guarda as chaves entre chaves[i - 1] e chaves[i]
+        bool cruza = (i == 0 || pag.chaves[i - 1] < hi) &&
+                     (i == pag.nroChaves || pag.chaves[i] > lo);
+        if (!folha && cruza) {
+            n = coletarEmOrdem(fp, pag.ponteiros[i], profundidade + 1, lo, hi, chaves, pr, n, capacidade);
+            if (n < 0) return -1;
+        }
+        if (i == pag.nroChaves) break;
+        if (pag.chaves[i] < lo || pag.chaves[i] > hi) continue;
+        if (n >= capacidade) return -1;
+        chaves[n] = pag.chaves[i];
+        pr[n] = pag.pr[i];
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Acrescenta, em ordem crescente, as chaves de [lo, hi] da subárvore de raiz rrn
+ *
+ * Subárvores cujo intervalo de chaves não cruza [lo, hi] não são lidas.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param rrn RRN da raiz da subárvore
+ * @param lo Menor chave coletada
+ * @param hi Maior chave coletada
+ * @param chaves Vetor que recebe as chaves
+ * @param pr Vetor que recebe os byte offsets
+ * @param n Número de chaves já presentes nos vetores
+ * @param capacidade Capacidade dos vetores
+ * @return Novo número de chaves nos vetores ou -1 em caso de inconsistência
+ */
+int coletarChavesArvoreB(FILE *fp, int rrn, int lo, int hi, int *chaves, long long *pr, int n, int capacidade) {
+    return coletarEmOrdem(fp, rrn, 0, lo, hi, chaves, pr, n, capacidade);
+}
+
+/**
+ * @brief Monta a árvore de baixo para cima a partir das chaves ordenadas
+ *
+ * Cada nível recebe M entradas e as divide em P nós separados por uma
+ * chave, que sobe para o nível de cima. P é escolhido para que cada nó
+ * tenha cerca de chavesPorNo chaves, sem nunca passar de MAX_CHAVES nem
+ * ficar vazio; as chaves restantes são distribuídas por igual. Como os
+ * P - 1 separadores formam o nível de cima, ele tem exatamente P filhos.
+ *
+ * @return true se a árvore foi montada
+ */
+static bool montarArvore(ArvoreCompactacao *arv, int *chaves, long long *pr, int n, int chavesPorNo) {
+    // Limite folgado: cada nó guarda ao menos uma chave
+    arv->nos = malloc(sizeof(NoCompactacao) * (n > 0 ? n : 1));
+    if (!arv->nos) return false;
+    arv->nroNos = 0;
+    arv->altura = 0;
+
+    int m = n;
+    int *filhosNivel = NULL; // Nós do nível de baixo, na ordem das chaves
+    while (m > 0) {
+        if (arv->altura >= ALTURA_MAX) {
+            free(filhosNivel);
+            return false;
+        }
+
+        int p = (m + 1 + chavesPorNo) / (chavesPorNo + 1);   // ceil((m + 1) / (f + 1))
+        if (p > (m + 1) / 2) p = (m + 1) / 2;                // Nenhum nó vazio
+        if (p < 1) p = 1;
+        int nasFolhas = m - (p - 1);
+        int base = nasFolhas / p, extras = nasFolhas % p;
+
+        int nivel = arv->altura++;
+        arv->inicioNivel[nivel] = arv->nroNos;
+
+        int lido = 0, separadores = 0, filho = 0;
+        for (int i = 0; i < p; i++) {
+            NoCompactacao *no = &arv->nos[arv->nroNos++];
+            no->nroChaves = base + (i < extras ? 1 : 0);
+            for (int j = 0; j < MAX_PONTEIROS; j++) no->filhos[j] = INVALIDO;
+            for (int j = 0; j < MAX_CHAVES; j++) {
+                no->chaves[j] = -1;
+                no->pr[j] = -1;
+            }
+            for (int j = 0; j < no->nroChaves; j++) {
+                if (filhosNivel) no->filhos[j] = filhosNivel[filho++];
+                no->chaves[j] = chaves[lido];
+                no->pr[j] = pr[lido];
+                lido++;
+            }
+            if (filhosNivel) no->filhos[no->nroChaves] = filhosNivel[filho++];
+
+            // Separador entre este nó e o próximo sobe para o nível de cima
+            if (i < p - 1) {
+                chaves[separadores] = chaves[lido];
+                pr[separadores] = pr[lido];
+                separadores++;
+                lido++;
+            }
+        }
+        arv->fimNivel[nivel] = arv->nroNos;
+
+        free(filhosNivel);
+        filhosNivel = NULL;
+        if (p == 1) break;
+
+        filhosNivel = malloc(sizeof(int) * p);
+        if (!filhosNivel) return false;
+        for (int i = 0; i < p; i++) filhosNivel[i] = arv->inicioNivel[nivel] + i;
+        m = separadores;
+    }
+    free(filhosNivel);
+    return true;
+}
+
+/**
+ * @brief Acrescenta à ordem os nós que estão a `distancia` níveis abaixo de no
+ */
+static void coletarNaProfundidade(ArvoreCompactacao *arv, int no, int distancia, int *saida, int *n) {
+    if (distancia == 0) {
+        saida[(*n)++] = no;
+        return;
+    }
+    NoCompactacao *atual = &arv->nos[no];
+    for (int i = 0; i <= atual->nroChaves; i++) {
+        if (atual->filhos[i] != INVALIDO) {
+            coletarNaProfundidade(arv, atual->filhos[i], distancia - 1, saida, n);
+        }
+    }
+}
+
+/**
+ * @brief Ordem de van Emde Boas da subárvore de raiz no com `altura` níveis
+ *
+ * Grava primeiro a metade superior da subárvore e depois, da esquerda
+ * para a direita, cada subárvore pendurada abaixo dela, recursivamente.
+ * As raízes das subárvores de baixo ficam no início de area, e as chamadas
+ * internas usam o restante; como cada nível guarda nós distintos, uma área
+ * de nroNos posições basta para a recursão inteira.
+ */
+static void ordemVanEmdeBoas(ArvoreCompactacao *arv, int no, int altura, int *ordem, int *n, int *area) {
+    if (altura == 1) {
+        ordem[(*n)++] = no;
+        return;
+    }
+    int topo = altura / 2;
+    int base = altura - topo;
+    ordemVanEmdeBoas(arv, no, topo, ordem, n, area);
+
+    int k = 0;
+    coletarNaProfundidade(arv, no, topo, area, &k);
+    for (int i = 0; i < k; i++) {
+        ordemVanEmdeBoas(arv, area[i], base, ordem, n, area + k);
+    }
+}
+
+/**
+ * @brief Grava a árvore montada a partir do RRN 0, na ordem pedida
+ *
+ * Atualiza noRaiz, proxRRN, nroNos e topoLivres no cabeçalho em memória;
+ * não grava o cabeçalho.
+ *
+ * @return true se todas as páginas foram gravadas
+ */
+static bool gravarArvore(ArvoreCompactacao *arv, FILE *fp, CabecalhoArvoreB *cab, int layout) {
+    int *ordem = malloc(sizeof(int) * (arv->nroNos > 0 ? arv->nroNos : 1));
+    int *rrnDe = malloc(sizeof(int) * (arv->nroNos > 0 ? arv->nroNos : 1));
+    if (!ordem || !rrnDe) {
+        free(ordem);
+        free(rrnDe);
+        return false;
+    }
+
+    int n = 0;
+    if (arv->nroNos > 0) {
+        int raiz = arv->nroNos - 1;
+        if (layout == LAYOUT_VAN_EMDE_BOAS) {
+            // rrnDe ainda não está em uso: serve de área de trabalho da recursão
+            ordemVanEmdeBoas(arv, raiz, arv->altura, ordem, &n, rrnDe);
+        } else {
+            // Largura: da raiz às folhas, cada nível da esquerda para a direita
+            for (int nivel = arv->altura - 1; nivel >= 0; nivel--) {
+                for (int i = arv->inicioNivel[nivel]; i < arv->fimNivel[nivel]; i++) {
+                    ordem[n++] = i;
+                }
+            }
+        }
+    }
+
+    bool ok = (n == arv->nroNos);
+    for (int i = 0; ok && i < n; i++) rrnDe[ordem[i]] = i;
+
+    for (int i = 0; ok && i < n; i++) {
+        NoCompactacao *no = &arv->nos[ordem[i]];
+        bool folha = (no->filhos[0] == INVALIDO);
+
+        PaginaArvoreB pag;
+        inicializaPagina(&pag, folha ? -1 : 1);
+        if (ordem[i] == arv->nroNos - 1 && !folha) pag.tipoNo = 0;
+        pag.nroChaves = no->nroChaves;
+        for (int j = 0; j < no->nroChaves; j++) {
+            pag.chaves[j] = no->chaves[j];
+            pag.pr[j] = no->pr[j];
+        }
+        if (!folha) {
+            for (int j = 0; j <= no->nroChaves; j++) {
+                pag.ponteiros[j] = rrnDe[no->filhos[j]];
+            }
+        }
+        escreverPaginaArvoreB(fp, i, &pag);
+    }
+
+    if (ok) {
+        cab->noRaiz = (n > 0) ? rrnDe[arv->nroNos - 1] : INVALIDO;
+        cab->proxRRN = n;
+        cab->nroNos = n;
+        cab->topoLivres = INVALIDO;
+    }
+
+    free(ordem);
+    free(rrnDe);
+    return ok;
+}
+
+/**
+ * @brief Regrava todo o índice a partir de chaves já ordenadas
+ *
+ * A árvore é montada de baixo para cima e gravada a partir do RRN 0 no
+ * arquivo informado, que pode ser o próprio índice; nesse caso, as páginas
+ * antigas além do novo proxRRN ficam a cargo de quem chama. Os vetores de entrada são usados como área
+ * de trabalho e ficam alterados.
+ *
+ * @param fp Ponteiro para o arquivo de destino
+ * @param cab Cabeçalho em memória (noRaiz, proxRRN, nroNos e topoLivres são atualizados)
+ * @param chaves Chaves em ordem crescente
+ * @param pr Byte offsets correspondentes
+ * @param n Número de chaves
+ * @param fatorPreenchimento Porcentagem de ocupação das páginas (1 a 100)
+ * @param layout LAYOUT_LARGURA ou LAYOUT_VAN_EMDE_BOAS (outro valor: nada é gravado)
+ * @return 1 se a árvore foi regravada, 0 caso contrário
+ */
+int reconstruirArvoreB(FILE *fp, CabecalhoArvoreB *cab, int *chaves, long long *pr, int n, int fatorPreenchimento, int layout) {
+    if (layout != LAYOUT_LARGURA && layout != LAYOUT_VAN_EMDE_BOAS) return 0;
+    if (fatorPreenchimento < 1) fatorPreenchimento = 1;
+    if (fatorPreenchimento > 100) fatorPreenchimento = 100;
+    int chavesPorNo = (MAX_CHAVES * fatorPreenchimento + 99) / 100;
+    if (chavesPorNo < 1) chavesPorNo = 1;
+
+    ArvoreCompactacao arv;
+    bool ok = montarArvore(&arv, chaves, pr, n, chavesPorNo) &&
+              gravarArvore(&arv, fp, cab, layout);
+    free(arv.nos);
+    return ok ? 1 : 0;
+}
+
+/**
+ * @brief Reescreve o índice em ordem de chave e o substitui atomicamente
+ *
+ * O índice precisa estar consistente (status '1'). As chaves são lidas
+ * por um percurso em ordem, a árvore é montada em memória e gravada em
+ * "<índice>.tmp", que só então substitui o original com rename(). Leitores
+ * que já tinham o arquivo antigo aberto continuam vendo uma árvore válida.
+ * Páginas livres não são copiadas: o novo arquivo tem exatamente nroNos
+ * páginas. Um filtro de Bloom em dia é regravado com a assinatura do
+ * novo cabeçalho antes da troca.
+ *
+ * @param btreeFilename Nome do arquivo de índice
+ * @param fatorPreenchimento Porcentagem de ocupação das páginas (1 a 100)
+ * @param layout LAYOUT_LARGURA ou LAYOUT_VAN_EMDE_BOAS
+ * @return 1 se o índice foi compactado, 0 em caso de falha, -1 se o layout for desconhecido
+ */
+int btree_compact(const char *btreeFilename, int fatorPreenchimento, int layout) {
+    if (layout != LAYOUT_LARGURA && layout != LAYOUT_VAN_EMDE_BOAS) return -1;
+
+    FILE *fp = wal_fopen(btreeFilename, "rb");
+    if (!fp) return 0;
+
+    CabecalhoArvoreB cab;
+    lerCabecalhoArvoreB(fp, &cab);
+    if (cab.status != '1' || cab.nroNos < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    int capacidade = cab.nroNos * MAX_CHAVES;
+    int *chaves = malloc(sizeof(int) * (capacidade > 0 ? capacidade : 1));
+    long long *pr = malloc(sizeof(long long) * (capacidade > 0 ? capacidade : 1));
+    if (!chaves || !pr) {
+        free(chaves);
+        free(pr);
+        fclose(fp);
+        return 0;
+    }
+
+    int n = coletarChavesArvoreB(fp, cab.noRaiz, INT_MIN, INT_MAX, chaves, pr, 0, capacidade);
+    fclose(fp);
+    if (n < 0) {
+        free(chaves);
+        free(pr);
+        return 0;
+    }
+
+    // O conjunto de chaves não muda: um filtro em dia continua válido
+    FiltroBloom *filtro = bloom_carregar(btreeFilename, &cab);
+
+    char *temporario = malloc(strlen(btreeFilename) + 5);
+    FILE *novo = NULL;
+    if (temporario) {
+        sprintf(temporario, "%s.tmp", btreeFilename);
+        novo = fopen(temporario, "wb+");
+    }
+
+    bool ok = false;
+    if (novo) {
+        inicializaCabecalhoArvoreB(novo);
+        lerCabecalhoArvoreB(novo, &cab);
+        ok = reconstruirArvoreB(novo, &cab, chaves, pr, n, fatorPreenchimento, layout);
+        if (ok) {
+            cab.status = '1';
+            cab.filtroDesatualizado = FILTRO_EM_DIA;
+            if (!bloom_salvar(filtro, btreeFilename, &cab)) {
+                cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+            }
+            escreverCabecalhoArvoreB(novo, &cab);
+        }
+        if (fclose(novo) != 0) ok = false;
+        if (ok && rename(temporario, btreeFilename) != 0) ok = false;
+        if (!ok) remove(temporario);
+    }
+
+    bloom_liberar(filtro);
+    free(chaves);
+    free(pr);
+    free(temporario);
+    return ok ? 1 : 0;
+}
@@ -1,59 +1,94 @@
+/**
+ * @file arvore-b-remove.c
+ * @brief Implementação da remoção na árvore-B
+ *
+ * A remoção desce uma única vez da raiz até a folha, mantendo em memória
+ * as páginas do caminho e os irmãos consultados. Redistribuições e fusões
+ * são feitas sobre essas cópias, e cada página alterada é gravada uma única
+ * vez ao final da operação.
+ *
+ * Páginas absorvidas em fusões e a raiz eliminada na redução de altura
+ * entram na lista de páginas livres do cabeçalho, para reuso em splits.
+ */
+
 #include "arvore-b.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 
 #define INVALIDO -1
 
-// Função para encontrar a chave sucessora em nó folha
-int encontrarSucessora(FILE *fp, int rrn, int *chaveSuccessora, long long *prSuccessor) {  // CORRIGIDO: tipos trocados
-    PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrn, &pag);
-    
-    // Se é folha, retorna a primeira chave
-    if (pag.tipoNo == -1) {
-        if (pag.nroChaves > 0) {
-            *chaveSuccessora = pag.chaves[0];
-            *prSuccessor = pag.pr[0];
-            return rrn;
+// Caminho (ALTURA_MAX) + até dois irmãos por nível
+#define MAX_PAGINAS_CACHE (3 * ALTURA_MAX)
+
+/**
+ * @brief Página mantida em memória durante uma remoção
+ */
+typedef struct {
+    int rrn;              // RRN da página
+    PaginaArvoreB pag;    // Conteúdo da página
+    bool suja;            // Alterada e ainda não gravada
+} PaginaEmCache;
+
+/**
+ * @brief Conjunto de páginas lidas durante uma remoção
+ */
+typedef struct {
+    PaginaEmCache itens[MAX_PAGINAS_CACHE];
+    int n;
+} CacheRemocao;
+
+/**
+ * @brief Obtém uma página do cache, lendo do arquivo apenas na primeira vez
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cache Cache da operação
+ * @param rrn RRN da página
+ * @return Entrada do cache ou NULL se o cache estiver cheio
+ */
+static PaginaEmCache *obterPagina(FILE *fp, CacheRemocao *cache, int rrn) {
+    for (int i = 0; i < cache->n; i++) {
+        if (cache->itens[i].rrn == rrn) {
+            return &cache->itens[i];
         }
-        return -1;
-    }
-    
-    // Se não é folha, vai para o primeiro filho
-    if (pag.ponteiros[0] != INVALIDO) {
-        return encontrarSucessora(fp, pag.ponteiros[0], chaveSuccessora, prSuccessor);
     }
-    
-    return -1;
+    if (cache->n >= MAX_PAGINAS_CACHE) return NULL;
+
+    PaginaEmCache *item = &cache->itens[cache->n++];
+    item->rrn = rrn;
+    item->suja = false;
+    lerPaginaArvoreB(fp, rrn, &item->pag);
+    return item;
 }
 
-// Função para encontrar a chave predecessor em nó folha
-int encontrarPredecessor(FILE *fp, int rrn, int *chavePred, long long *prPred) {  // CORRIGIDO: tipos trocados
-    PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrn, &pag);
-    
-    // Se é folha, retorna a última chave
-    if (pag.tipoNo == -1) {
-        if (pag.nroChaves > 0) {
-            *chavePred = pag.chaves[pag.nroChaves - 1];
-            *prPred = pag.pr[pag.nroChaves - 1];
-            return rrn;
+/**
+ * @brief Grava uma única vez cada página alterada do cache
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cache Cache da operação
+ */
+static void gravarCache(FILE *fp, CacheRemocao *cache) {
+    for (int i = 0; i < cache->n; i++) {
+        if (cache->itens[i].suja) {
+            escreverPaginaArvoreB(fp, cache->itens[i].rrn, &cache->itens[i].pag);
+            cache->itens[i].suja = false;
         }
-        return -1;
-    }
-    
-    // Se não é folha, vai para o último filho
-    if (pag.ponteiros[pag.nroChaves] != INVALIDO) {
-        return encontrarPredecessor(fp, pag.ponteiros[pag.nroChaves], chavePred, prPred);
     }
-    
-    return -1;
+}
+
+/**
+ * @brief Indica se a página é folha
+ *
+ * Considera também raízes antigas que ficaram com tipoNo 0 sem filhos.
+ */
+static bool ehFolha(PaginaArvoreB *pag) {
+    return pag->tipoNo == -1 || pag->ponteiros[0] == INVALIDO;
 }
 
 // Função para encontrar índice de uma chave no nó
-int buscarIndiceChave(PaginaArvoreB *pag, int chave) {  // CORRIGIDO: int chave
+int buscarIndiceChave(PaginaArvoreB *pag, int chave) {
     int idx = 0;
     while (idx < pag->nroChaves && pag->chaves[idx] < chave) {
         idx++;
@@ -61,398 +96,669 @@ int buscarIndiceChave(PaginaArvoreB *pag, int chave) {  // CORRIGIDO: int chave
     return idx;
 }
 
-// Função para remover chave de nó folha
-void removerDeFolha(FILE *fp, int rrnNo, int idx) {
-    PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrnNo, &pag);
-    
-    // Move chaves e pr para a esquerda
-    for (int i = idx + 1; i < pag.nroChaves; i++) {
-        pag.chaves[i - 1] = pag.chaves[i];
-        pag.pr[i - 1] = pag.pr[i];
+// Função para remover a chave idx de uma página em memória
+void removerDaPagina(PaginaArvoreB *pag, int idx) {
+    for (int i = idx + 1; i < pag->nroChaves; i++) {
+        pag->chaves[i - 1] = pag->chaves[i];
+        pag->pr[i - 1] = pag->pr[i];
     }
-    
+
     // Limpa a última posição
-    pag.chaves[pag.nroChaves - 1] = -1;
-    pag.pr[pag.nroChaves - 1] = -1;
-    pag.nroChaves--;
-    
-    escreverPaginaArvoreB(fp, rrnNo, &pag);
+    pag->chaves[pag->nroChaves - 1] = -1;
+    pag->pr[pag->nroChaves - 1] = -1;
+    pag->nroChaves--;
 }
 
-// Função para pegar chave do irmão anterior
-void tomarDoAnterior(FILE *fp, int paiRRN, int idx) {
-    PaginaArvoreB pai, filho, irmao;
-    lerPaginaArvoreB(fp, paiRRN, &pai);
-    lerPaginaArvoreB(fp, pai.ponteiros[idx], &filho);
-    lerPaginaArvoreB(fp, pai.ponteiros[idx - 1], &irmao);
-    
+// Função para pegar chave do irmão anterior (páginas em memória)
+void tomarDoAnterior(PaginaArvoreB *pai, int idx, PaginaArvoreB *filho, PaginaArvoreB *irmao) {
+    bool interno = !ehFolha(filho);
+
     // Move chaves do filho para a direita
-    for (int i = filho.nroChaves; i > 0; i--) {
-        filho.chaves[i] = filho.chaves[i - 1];
-        filho.pr[i] = filho.pr[i - 1];
+    for (int i = filho->nroChaves; i > 0; i--) {
+        filho->chaves[i] = filho->chaves[i - 1];
+        filho->pr[i] = filho->pr[i - 1];
     }
-    
+
     // Move ponteiros do filho para a direita (se não for folha)
-    if (filho.tipoNo != -1) {
-        for (int i = filho.nroChaves + 1; i > 0; i--) {
-            filho.ponteiros[i] = filho.ponteiros[i - 1];
+    if (interno) {
+        for (int i = filho->nroChaves + 1; i > 0; i--) {
+            filho->ponteiros[i] = filho->ponteiros[i - 1];
         }
+        filho->ponteiros[0] = irmao->ponteiros[irmao->nroChaves];
+        irmao->ponteiros[irmao->nroChaves] = INVALIDO;
     }
-    
+
     // Move chave do pai para o filho
-    filho.chaves[0] = pai.chaves[idx - 1];
-    filho.pr[0] = pai.pr[idx - 1]; // PRESERVA o pr original
-    
-    // Move último ponteiro do irmão para o filho (se não for folha)
-    if (filho.tipoNo != -1) {
-        filho.ponteiros[0] = irmao.ponteiros[irmao.nroChaves];
-    }
-    
+    filho->chaves[0] = pai->chaves[idx - 1];
+    filho->pr[0] = pai->pr[idx - 1];
+    filho->nroChaves++;
+
     // Move última chave do irmão para o pai
-    pai.chaves[idx - 1] = irmao.chaves[irmao.nroChaves - 1];
-    pai.pr[idx - 1] = irmao.pr[irmao.nroChaves - 1]; // PRESERVA o pr original
-    
+    pai->chaves[idx - 1] = irmao->chaves[irmao->nroChaves - 1];
+    pai->pr[idx - 1] = irmao->pr[irmao->nroChaves - 1];
+
     // Limpa última posição do irmão
-    irmao.chaves[irmao.nroChaves - 1] = -1;
-    irmao.pr[irmao.nroChaves - 1] = -1;
-    if (irmao.tipoNo != -1) {
-        irmao.ponteiros[irmao.nroChaves] = INVALIDO;
-    }
-    
-    // Atualiza contadores
-    irmao.nroChaves--;
-    filho.nroChaves++;
-    
-    // Escreve páginas atualizadas
-    escreverPaginaArvoreB(fp, paiRRN, &pai);
-    escreverPaginaArvoreB(fp, pai.ponteiros[idx], &filho);
-    escreverPaginaArvoreB(fp, pai.ponteiros[idx - 1], &irmao);
+    irmao->chaves[irmao->nroChaves - 1] = -1;
+    irmao->pr[irmao->nroChaves - 1] = -1;
+    irmao->nroChaves--;
 }
 
-// Função para pegar chave do próximo irmão
-void tomarDoProximo(FILE *fp, int paiRRN, int idx) {
-    PaginaArvoreB pai, filho, irmao;
-    lerPaginaArvoreB(fp, paiRRN, &pai);
-    lerPaginaArvoreB(fp, pai.ponteiros[idx], &filho);
-    lerPaginaArvoreB(fp, pai.ponteiros[idx + 1], &irmao);
-    
+// Função para pegar chave do próximo irmão (páginas em memória)
+void tomarDoProximo(PaginaArvoreB *pai, int idx, PaginaArvoreB *filho, PaginaArvoreB *irmao) {
+    bool interno = !ehFolha(filho);
+
     // Move chave do pai para o filho
-    filho.chaves[filho.nroChaves] = pai.chaves[idx];
-    filho.pr[filho.nroChaves] = pai.pr[idx]; // PRESERVA o pr original
-    
+    filho->chaves[filho->nroChaves] = pai->chaves[idx];
+    filho->pr[filho->nroChaves] = pai->pr[idx];
+
     // Move primeiro ponteiro do irmão para o filho (se não for folha)
-    if (filho.tipoNo != -1) {
-        filho.ponteiros[filho.nroChaves + 1] = irmao.ponteiros[0];
+    if (interno) {
+        filho->ponteiros[filho->nroChaves + 1] = irmao->ponteiros[0];
     }
-    
-    filho.nroChaves++;
-    
+    filho->nroChaves++;
+
     // Move primeira chave do irmão para o pai
-    pai.chaves[idx] = irmao.chaves[0];
-    pai.pr[idx] = irmao.pr[0]; // PRESERVA o pr original
-    
+    pai->chaves[idx] = irmao->chaves[0];
+    pai->pr[idx] = irmao->pr[0];
+
+    // Move ponteiros do irmão para a esquerda (se não for folha)
+    if (interno) {
+        for (int i = 1; i <= irmao->nroChaves; i++) {
+            irmao->ponteiros[i - 1] = irmao->ponteiros[i];
+        }
+        irmao->ponteiros[irmao->nroChaves] = INVALIDO;
+    }
+
     // Move chaves do irmão para a esquerda
-    for (int i = 1; i < irmao.nroChaves; i++) {
-        irmao.chaves[i - 1] = irmao.chaves[i];
-        irmao.pr[i - 1] = irmao.pr[i];
+    removerDaPagina(irmao, 0);
+}
+
+// Função para fundir o filho idx + 1 (direita) no filho idx (esquerda)
+void fundir(CabecalhoArvoreB *cab, PaginaArvoreB *pai, int idx, PaginaArvoreB *esq, PaginaArvoreB *dir) {
+    bool interno = !ehFolha(esq);
+
+    // Chave separadora desce do pai
+    esq->chaves[esq->nroChaves] = pai->chaves[idx];
+    esq->pr[esq->nroChaves] = pai->pr[idx];
+    esq->nroChaves++;
+
+    // Copia chaves e ponteiros do irmão da direita
+    int base = esq->nroChaves;
+    for (int i = 0; i < dir->nroChaves; i++) {
+        esq->chaves[base + i] = dir->chaves[i];
+        esq->pr[base + i] = dir->pr[i];
     }
-    
-    // Move ponteiros do irmão para a esquerda (se não for folha)
-    if (irmao.tipoNo != -1) {
-        for (int i = 1; i <= irmao.nroChaves; i++) {
-            irmao.ponteiros[i - 1] = irmao.ponteiros[i];
+    if (interno) {
+        for (int i = 0; i <= dir->nroChaves; i++) {
+            esq->ponteiros[base + i] = dir->ponteiros[i];
         }
     }
-    
-    // Limpa última posição do irmão
-    irmao.chaves[irmao.nroChaves - 1] = -1;
-    irmao.pr[irmao.nroChaves - 1] = -1;
-    if (irmao.tipoNo != -1) {
-        irmao.ponteiros[irmao.nroChaves] = INVALIDO;
+    esq->nroChaves += dir->nroChaves;
+
+    // Remove a chave separadora e o ponteiro para o irmão da direita
+    for (int i = idx + 2; i <= pai->nroChaves; i++) {
+        pai->ponteiros[i - 1] = pai->ponteiros[i];
     }
-    
-    irmao.nroChaves--;
-    
-    // Escreve páginas atualizadas
-    escreverPaginaArvoreB(fp, paiRRN, &pai);
-    escreverPaginaArvoreB(fp, pai.ponteiros[idx], &filho);
-    escreverPaginaArvoreB(fp, pai.ponteiros[idx + 1], &irmao);
+    pai->ponteiros[pai->nroChaves] = INVALIDO;
+    removerDaPagina(pai, idx);
+
+    cab->nroNos--; // Diminui número de nós
 }
 
-// Função para fundir dois nós
-void fundir(FILE *fp, CabecalhoArvoreB *cab, int paiRRN, int idx) {
-    PaginaArvoreB pai, filho, irmao;
-    lerPaginaArvoreB(fp, paiRRN, &pai);
-    lerPaginaArvoreB(fp, pai.ponteiros[idx], &filho);
-    lerPaginaArvoreB(fp, pai.ponteiros[idx + 1], &irmao);
-    
-    if (filho.tipoNo == -1 && irmao.tipoNo == -1) {
-        // Fusão de nós folha: apenas copia as chaves do irmão para o filho
-        for (int i = 0; i < irmao.nroChaves; i++) {
-            filho.chaves[filho.nroChaves] = irmao.chaves[i];
-            filho.pr[filho.nroChaves] = irmao.pr[i]; // PRESERVA o pr original
-            filho.nroChaves++;
+/**
+ * @brief Remove uma chave usando um cabeçalho já carregado em memória
+ *
+ * Desce uma única vez: se a chave está em nó interno, a descida continua
+ * até a folha do predecessor, que substitui a chave removida. Em seguida
+ * os níveis com underflow são corrigidos de baixo para cima, usando as
+ * páginas do caminho já em memória e lendo cada irmão no máximo uma vez.
+ * Ao final, cada página alterada é gravada uma única vez.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param chave Chave a ser removida
+ * @return 1 se removida, 0 se não encontrada
+ */
+int removerComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int chave) {
+    if (cab->noRaiz == INVALIDO) return 0;
+
+    CacheRemocao *cache = malloc(sizeof(CacheRemocao));
+    if (!cache) return 0;
+    cache->n = 0;
+
+    PaginaEmCache *caminho[ALTURA_MAX];
+    int indices[ALTURA_MAX];
+    int nivel = 0;
+    int nivelChave = -1, idxChave = -1;
+
+    // Descida única até a chave (ou até a folha do predecessor)
+    int rrn = cab->noRaiz;
+    while (1) {
+        PaginaEmCache *atual = obterPagina(fp, cache, rrn);
+        if (!atual || nivel >= ALTURA_MAX) {
+            free(cache);
+            return 0;
         }
-        
-        // Limpa posições não utilizadas
-        for (int i = filho.nroChaves; i < MAX_CHAVES; i++) {
-            filho.chaves[i] = -1;
-            filho.pr[i] = -1;
+        caminho[nivel] = atual;
+        PaginaArvoreB *pag = &atual->pag;
+
+        int idx;
+        if (nivelChave == -1) {
+            idx = buscarIndiceChave(pag, chave);
+            if (idx < pag->nroChaves && pag->chaves[idx] == chave) {
+                nivelChave = nivel;
+                idxChave = idx;
+                if (ehFolha(pag)) break;
+                // Chave em nó interno: segue para o predecessor
+            } else if (ehFolha(pag)) {
+                free(cache);
+                return 0; // Chave não encontrada
+            }
+        } else {
+            // Descendo pela direita até o predecessor
+            if (ehFolha(pag)) break;
+            idx = pag->nroChaves;
         }
-    } else {
-        // Fusão de nós internos: move chave do pai para o filho
-        filho.chaves[filho.nroChaves] = pai.chaves[idx];
-        filho.pr[filho.nroChaves] = pai.pr[idx]; // PRESERVA o pr da chave do pai
-        filho.nroChaves++;
-        
-        // Copia chaves do irmão para o filho
-        for (int i = 0; i < irmao.nroChaves; i++) {
-            filho.chaves[filho.nroChaves] = irmao.chaves[i];
-            filho.pr[filho.nroChaves] = irmao.pr[i]; // PRESERVA o pr original
-            filho.nroChaves++;
+
+        indices[nivel] = idx;
+        rrn = pag->ponteiros[idx];
+        if (rrn == INVALIDO) {
+            free(cache);
+            return 0;
         }
-        
-        // Copia ponteiros do irmão para o filho
-        for (int i = 0; i <= irmao.nroChaves; i++) {
-            filho.ponteiros[filho.nroChaves - irmao.nroChaves + i] = irmao.ponteiros[i];
+        nivel++;
+    }
+
+    int nivelFolha = nivel;
+    PaginaArvoreB *folha = &caminho[nivelFolha]->pag;
+
+    if (nivelChave == nivelFolha) {
+        // Caso 1: remoção em folha
+        removerDaPagina(folha, idxChave);
+    } else {
+        // Caso 2: substitui pela predecessora (última chave da folha)
+        PaginaArvoreB *interno = &caminho[nivelChave]->pag;
+        interno->chaves[idxChave] = folha->chaves[folha->nroChaves - 1];
+        interno->pr[idxChave] = folha->pr[folha->nroChaves - 1];
+        caminho[nivelChave]->suja = true;
+        removerDaPagina(folha, folha->nroChaves - 1);
+    }
+    caminho[nivelFolha]->suja = true;
+
+    // Correção de underflow de baixo para cima
+    for (nivel = nivelFolha; nivel > 0; nivel--) {
+        PaginaEmCache *filho = caminho[nivel];
+        if (filho->pag.nroChaves >= MIN_CHAVES_NAO_RAIZ) break;
+
+        PaginaEmCache *pai = caminho[nivel - 1];
+        int idx = indices[nivel - 1];
+
+        // Tenta redistribuir com irmão anterior
+        PaginaEmCache *irmaoEsq = NULL;
+        if (idx > 0) {
+            irmaoEsq = obterPagina(fp, cache, pai->pag.ponteiros[idx - 1]);
+            if (irmaoEsq && irmaoEsq->pag.nroChaves > MIN_CHAVES_NAO_RAIZ) {
+                tomarDoAnterior(&pai->pag, idx, &filho->pag, &irmaoEsq->pag);
+                pai->suja = filho->suja = irmaoEsq->suja = true;
+                break;
+            }
         }
-        
-        // Limpa posições não utilizadas
-        for (int i = filho.nroChaves; i < MAX_CHAVES; i++) {
-            filho.chaves[i] = -1;
-            filho.pr[i] = -1;
+
+        // Tenta redistribuir com irmão posterior
+        PaginaEmCache *irmaoDir = NULL;
+        if (idx < pai->pag.nroChaves) {
+            irmaoDir = obterPagina(fp, cache, pai->pag.ponteiros[idx + 1]);
+            if (irmaoDir && irmaoDir->pag.nroChaves > MIN_CHAVES_NAO_RAIZ) {
+                tomarDoProximo(&pai->pag, idx, &filho->pag, &irmaoDir->pag);
+                pai->suja = filho->suja = irmaoDir->suja = true;
+                break;
+            }
         }
-        for (int i = filho.nroChaves + 1; i < MAX_PONTEIROS; i++) {
-            filho.ponteiros[i] = INVALIDO;
+
+        // Não conseguiu redistribuir, precisa fazer concatenação
+        if (irmaoDir) {
+            fundir(cab, &pai->pag, idx, &filho->pag, &irmaoDir->pag);
+            filho->suja = true;
+            // Página absorvida vai para a lista de páginas livres
+            liberarPaginaArvoreB(cab, &irmaoDir->pag, irmaoDir->rrn);
+            irmaoDir->suja = true;
+        } else if (irmaoEsq) {
+            fundir(cab, &pai->pag, idx - 1, &irmaoEsq->pag, &filho->pag);
+            irmaoEsq->suja = true;
+            liberarPaginaArvoreB(cab, &filho->pag, filho->rrn);
+            filho->suja = true;
+        } else {
+            break; // Caminho inconsistente
         }
+        pai->suja = true;
     }
-    
-    // Remove chave do pai e ajusta ponteiros
-    for (int i = idx + 1; i < pai.nroChaves; i++) {
-        pai.chaves[i - 1] = pai.chaves[i];
-        pai.pr[i - 1] = pai.pr[i];
+
+    // Redução de altura: raiz sem chaves promove seu único filho
+    PaginaEmCache *raiz = caminho[0];
+    if (raiz->pag.nroChaves == 0) {
+        if (!ehFolha(&raiz->pag)) {
+            PaginaEmCache *novaRaiz = obterPagina(fp, cache, raiz->pag.ponteiros[0]);
+            if (novaRaiz) {
+                cab->noRaiz = novaRaiz->rrn;
+                novaRaiz->pag.tipoNo = ehFolha(&novaRaiz->pag) ? -1 : 0;
+                novaRaiz->suja = true;
+                liberarPaginaArvoreB(cab, &raiz->pag, raiz->rrn);
+                raiz->suja = true;
+                cab->nroNos--;
+            }
+        } else {
+            // Árvore ficou completamente vazia
+            cab->noRaiz = INVALIDO;
+            cab->nroNos = 0;
+            liberarPaginaArvoreB(cab, &raiz->pag, raiz->rrn);
+            raiz->suja = true;
+        }
     }
-    for (int i = idx + 2; i <= pai.nroChaves; i++) {
-        pai.ponteiros[i - 1] = pai.ponteiros[i];
+
+    gravarCache(fp, cache);
+    free(cache);
+    return 1;
+}
+
+/**
+ * @brief Altura da árvore, descendo pelo filho mais à esquerda
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @return Número de níveis (0 se a árvore estiver vazia)
+ */
+static int alturaArvoreB(FILE *fp, CabecalhoArvoreB *cab) {
+    int altura = 0;
+    int rrn = cab->noRaiz;
+    while (rrn != INVALIDO && altura < ALTURA_MAX) {
+        PaginaArvoreB pag;
+        lerPaginaArvoreB(fp, rrn, &pag);
+        altura++;
+        if (ehFolha(&pag)) break;
+        rrn = pag.ponteiros[0];
     }
-    
-    // Limpa última posição do pai
-    pai.chaves[pai.nroChaves - 1] = -1;
-    pai.pr[pai.nroChaves - 1] = -1;
-    pai.ponteiros[pai.nroChaves] = INVALIDO;
-    pai.nroChaves--;
-    
-    // Escreve páginas atualizadas
-    escreverPaginaArvoreB(fp, paiRRN, &pai);
-    escreverPaginaArvoreB(fp, pai.ponteiros[idx], &filho);
-    
-    cab->nroNos--; // Diminui número de nós
+    return altura;
 }
 
-// Função auxiliar para remover sucessora de forma direta (sempre em folha)
-void removerSucessoraSimples(FILE *fp, int rrnNo, int chave) {  // CORRIGIDO: int chave
+// ================= REMOÇÃO EM BLOCO =================
+
+// Limites abertos de chave além de qualquer int
+#define LIMITE_INFERIOR ((long long)INT_MIN - 1)
+#define LIMITE_SUPERIOR ((long long)INT_MAX + 1)
+
+/**
+ * @brief Subárvore resultante de uma poda ou de uma junção
+ */
+typedef struct {
+    int rrn;        // RRN da raiz (INVALIDO se vazia)
+    int altura;     // Número de níveis (0 se vazia)
+} Subarvore;
+
+/**
+ * @brief Intervalo fechado de chaves a remover
+ */
+typedef struct {
+    int lo;
+    int hi;
+} IntervaloRemocao;
+
+/**
+ * @brief Destino opcional das chaves removidas, na ordem em que saem da árvore
+ */
+typedef struct {
+    int *chaves;    // Vetor com espaço para todas as chaves que podem sair
+    int n;          // Chaves já anotadas
+} ColetaRemocao;
+
+/**
+ * @brief Obtém uma página nova, contada em nroNos
+ */
+static int novaPagina(FILE *fp, CabecalhoArvoreB *cab) {
+    cab->nroNos++;
+    return alocarPaginaArvoreB(fp, cab);
+}
+
+/**
+ * @brief Devolve uma página à lista de livres, descontando-a de nroNos
+ */
+static void devolverPagina(FILE *fp, CabecalhoArvoreB *cab, int rrn) {
+    PaginaArvoreB livre;
+    liberarPaginaArvoreB(cab, &livre, rrn);
+    escreverPaginaArvoreB(fp, rrn, &livre);
+    cab->nroNos--;
+}
+
+/**
+ * @brief Grava uma página com as chaves e filhos dados (tipoNo intermediário ou folha)
+ */
+static void gravarNo(FILE *fp, int rrn, const int chaves[], const long long pr[], const int filhos[], int n, bool folha) {
     PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrnNo, &pag);
-    
-    // Se é folha, remove diretamente
-    if (pag.tipoNo == -1) {
-        for (int i = 0; i < pag.nroChaves; i++) {
-            if (pag.chaves[i] == chave) {
-                // Remove a chave
-                for (int j = i; j < pag.nroChaves - 1; j++) {
-                    pag.chaves[j] = pag.chaves[j + 1];
-                    pag.pr[j] = pag.pr[j + 1];
-                }
-                // Limpa última posição
-                pag.chaves[pag.nroChaves - 1] = -1;
-                pag.pr[pag.nroChaves - 1] = -1;
-                pag.nroChaves--;
-                escreverPaginaArvoreB(fp, rrnNo, &pag);
-                return;
-            }
-        }
-    } else {
-        // Se não é folha, continua procurando pelo primeiro filho (esquerda)
-        if (pag.ponteiros[0] != INVALIDO) {
-            removerSucessoraSimples(fp, pag.ponteiros[0], chave);
-        }
+    inicializaPagina(&pag, folha ? -1 : 1);
+    pag.nroChaves = n;
+    for (int i = 0; i < n; i++) {
+        pag.chaves[i] = chaves[i];
+        pag.pr[i] = pr[i];
     }
+    for (int i = 0; !folha && i <= n; i++) pag.ponteiros[i] = filhos[i];
+    escreverPaginaArvoreB(fp, rrn, &pag);
 }
 
-// Função auxiliar para remover predecessora de forma direta (sempre em folha)
-void removerPredecessoraSimples(FILE *fp, int rrnNo, int chave) {  // CORRIGIDO: int chave
-    PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrnNo, &pag);
-    
-    // Se é folha, remove diretamente
-    if (pag.tipoNo == -1) {
-        for (int i = 0; i < pag.nroChaves; i++) {
-            if (pag.chaves[i] == chave) {
-                // Remove a chave
-                for (int j = i; j < pag.nroChaves - 1; j++) {
-                    pag.chaves[j] = pag.chaves[j + 1];
-                    pag.pr[j] = pag.pr[j + 1];
-                }
-                // Limpa última posição
-                pag.chaves[pag.nroChaves - 1] = -1;
-                pag.pr[pag.nroChaves - 1] = -1;
-                pag.nroChaves--;
-                escreverPaginaArvoreB(fp, rrnNo, &pag);
-                return;
+/**
+ * @brief Pendura (chave, filho) na borda de uma subárvore, no nível de altura alvo
+ *
+ * Desce pela borda direita (ou esquerda) até o nível alvo e acrescenta a
+ * chave na ponta da página, com o filho do lado de fora. Estouros são
+ * divididos e sobem pela mesma borda, como em uma inserção.
+ *
+ * @param raiz Subárvore que recebe a chave
+ * @param alvo Altura do nível que recebe a chave (1 = folhas)
+ * @param filho RRN da subárvore pendurada (INVALIDO nas folhas)
+ * @param direita true para a borda direita, false para a esquerda
+ */
+static Subarvore pendurarNaBorda(FILE *fp, CabecalhoArvoreB *cab, Subarvore raiz, int alvo,
+                                 int chave, long long pr, int filho, bool direita) {
+    int rrns[ALTURA_MAX];
+    PaginaArvoreB pags[ALTURA_MAX];
+    int niveis = 0;
+    int rrn = raiz.rrn;
+    for (int altura = raiz.altura; altura >= alvo && niveis < ALTURA_MAX; altura--) {
+        rrns[niveis] = rrn;
+        lerPaginaArvoreB(fp, rrn, &pags[niveis]);
+        rrn = pags[niveis].ponteiros[direita ? pags[niveis].nroChaves : 0];
+        niveis++;
+    }
+
+    // Chave e filho a acrescentar na ponta de cada nível, de baixo para cima
+    for (int nivel = niveis - 1; nivel >= 0; nivel--) {
+        PaginaArvoreB *pag = &pags[nivel];
+        bool folha = (nivel == niveis - 1) && alvo == 1;
+        int chaves[MAX_CHAVES + 1], filhos[MAX_PONTEIROS + 1];
+        long long prs[MAX_CHAVES + 1];
+        int n = pag->nroChaves;
+
+        if (direita) {
+            for (int i = 0; i < n; i++) {
+                chaves[i] = pag->chaves[i];
+                prs[i] = pag->pr[i];
             }
+            for (int i = 0; i <= n; i++) filhos[i] = pag->ponteiros[i];
+            chaves[n] = chave;
+            prs[n] = pr;
+            filhos[n + 1] = filho;
+        } else {
+            chaves[0] = chave;
+            prs[0] = pr;
+            filhos[0] = filho;
+            for (int i = 0; i < n; i++) {
+                chaves[i + 1] = pag->chaves[i];
+                prs[i + 1] = pag->pr[i];
+            }
+            for (int i = 0; i <= n; i++) filhos[i + 1] = pag->ponteiros[i];
         }
-    } else {
-        // Se não é folha, continua procurando pelo último filho (direita)
-        if (pag.ponteiros[pag.nroChaves] != INVALIDO) {
-            removerPredecessoraSimples(fp, pag.ponteiros[pag.nroChaves], chave);
+        n++;
+
+        if (n <= MAX_CHAVES) {
+            gravarNo(fp, rrns[nivel], chaves, prs, filhos, n, folha);
+            return raiz;
         }
+
+        // Estouro: a chave do meio sobe; a página original fica com a metade do lado de dentro
+        int meio = n / 2;
+        int rrnNova = novaPagina(fp, cab);
+        int rrnEsq = direita ? rrns[nivel] : rrnNova;
+        int rrnDir = direita ? rrnNova : rrns[nivel];
+        gravarNo(fp, rrnEsq, chaves, prs, filhos, meio, folha);
+        gravarNo(fp, rrnDir, chaves + meio + 1, prs + meio + 1, filhos + meio + 1, n - meio - 1, folha);
+
+        chave = chaves[meio];
+        pr = prs[meio];
+        filho = rrnNova;
     }
+
+    // A raiz se dividiu: a árvore ganha um nível
+    int filhos[2] = {direita ? raiz.rrn : filho, direita ? filho : raiz.rrn};
+    Subarvore nova = {novaPagina(fp, cab), raiz.altura + 1};
+    gravarNo(fp, nova.rrn, &chave, &pr, filhos, 1, false);
+    return nova;
 }
 
-// Função para remover de nó interno com correção
-void removerDeInterno(FILE *fp, CabecalhoArvoreB *cab, int rrnNo, int idx) {
+/**
+ * @brief Junta a, a chave e b, com as chaves de a menores que ela e as de b maiores
+ *
+ * A subárvore mais baixa (ou só a chave, se ela for vazia) é pendurada na
+ * borda da mais alta; cada uma das duas continua válida, então basta
+ * corrigir os estouros dessa borda. Custa um acesso por nível de diferença
+ * de altura.
+ */
+static Subarvore juntar(FILE *fp, CabecalhoArvoreB *cab, Subarvore a, int chave, long long pr, Subarvore b) {
+    if (a.altura == b.altura) {
+        int filhos[2] = {a.rrn, b.rrn};
+        Subarvore nova = {novaPagina(fp, cab), a.altura + 1};
+        gravarNo(fp, nova.rrn, &chave, &pr, filhos, 1, a.altura == 0);
+        return nova;
+    }
+    if (a.altura > b.altura) return pendurarNaBorda(fp, cab, a, b.altura + 1, chave, pr, b.rrn, true);
+    return pendurarNaBorda(fp, cab, b, a.altura + 1, chave, pr, a.rrn, false);
+}
+
+static int podarSubarvore(FILE *fp, CabecalhoArvoreB *cab, int rrn, int altura, long long limInf, long long limSup,
+                          const IntervaloRemocao *iv, int nIv, ColetaRemocao *coleta, Subarvore *resultado);
+
+/**
+ * @brief Junta duas subárvores sem chave entre elas, usando como separadora a maior chave de a
+ */
+static Subarvore juntarSemChave(FILE *fp, CabecalhoArvoreB *cab, Subarvore a, Subarvore b) {
     PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrnNo, &pag);
-    
-    int chaveOriginal = pag.chaves[idx];  // CORRIGIDO: int
-    
-    // Estratégia 1: PRIMEIRO tenta usar predecessor
-    if (pag.ponteiros[idx] != INVALIDO) {
-        PaginaArvoreB subarvoreEsq;
-        lerPaginaArvoreB(fp, pag.ponteiros[idx], &subarvoreEsq);
-        
-        if (subarvoreEsq.nroChaves >= 2) {
-            int chavePred;              // CORRIGIDO: int
-            long long prPred;           // CORRIGIDO: long long
-            int rrnPred = encontrarPredecessor(fp, pag.ponteiros[idx], &chavePred, &prPred);
-            
-            if (rrnPred != -1) {
-                // PRIMEIRO: Substitui a chave no nó interno
-                pag.chaves[idx] = chavePred;
-                pag.pr[idx] = prPred; // PRESERVA o pr do predecessor
-                escreverPaginaArvoreB(fp, rrnNo, &pag);
-                
-                // DEPOIS: Remove o predecessor de sua posição original
-                removerPredecessoraSimples(fp, pag.ponteiros[idx], chavePred);
-                return;
-            }
-        }
+    int rrn = a.rrn;
+    for (int altura = a.altura; altura > 0; altura--) {
+        lerPaginaArvoreB(fp, rrn, &pag);
+        rrn = pag.ponteiros[pag.nroChaves];
     }
-    
-    // Estratégia 2: Se predecessor causaria underflow, tenta sucessor
-    if (pag.ponteiros[idx + 1] != INVALIDO) {
-        PaginaArvoreB subarvoreDir;
-        lerPaginaArvoreB(fp, pag.ponteiros[idx + 1], &subarvoreDir);
-        
-        if (subarvoreDir.nroChaves >= 2) {
-            int chaveSucc;              // CORRIGIDO: int
-            long long prSucc;           // CORRIGIDO: long long
-            int rrnSucc = encontrarSucessora(fp, pag.ponteiros[idx + 1], &chaveSucc, &prSucc);
-            
-            if (rrnSucc != -1) {
-                // PRIMEIRO: Substitui a chave no nó interno
-                pag.chaves[idx] = chaveSucc;
-                pag.pr[idx] = prSucc; // PRESERVA o pr do sucessor
-                escreverPaginaArvoreB(fp, rrnNo, &pag);
-                
-                // DEPOIS: Remove o sucessor de sua posição original
-                removerSucessoraSimples(fp, pag.ponteiros[idx + 1], chaveSucc);
-                return;
-            }
-        }
+    int chave = pag.chaves[pag.nroChaves - 1];
+    long long pr = pag.pr[pag.nroChaves - 1];
+
+    IntervaloRemocao maior = {chave, chave};
+    Subarvore resto;
+    podarSubarvore(fp, cab, a.rrn, a.altura, LIMITE_INFERIOR, LIMITE_SUPERIOR, &maior, 1, NULL, &resto);
+    return juntar(fp, cab, resto, chave, pr, b);
+}
+
+/**
+ * @brief Libera todas as páginas de uma subárvore inteiramente removida
+ * @return Número de chaves que ela guardava
+ */
+static int descartarSubarvore(FILE *fp, CabecalhoArvoreB *cab, int rrn, int altura, ColetaRemocao *coleta) {
+    if (rrn == INVALIDO || altura <= 0) return 0;
+    PaginaArvoreB pag;
+    lerPaginaArvoreB(fp, rrn, &pag);
+    int chaves = pag.nroChaves;
+    for (int i = 0; i <= pag.nroChaves; i++) {
+        if (altura > 1) chaves += descartarSubarvore(fp, cab, pag.ponteiros[i], altura - 1, coleta);
+        if (coleta && i < pag.nroChaves) coleta->chaves[coleta->n++] = pag.chaves[i];
     }
-    
-    // Estratégia 3: Precisa fazer concatenação antes de remover
-    if (pag.ponteiros[idx] != INVALIDO && pag.ponteiros[idx + 1] != INVALIDO) {
-        // Funde a subárvore esquerda with a direita
-        fundir(fp, cab, rrnNo, idx);
-        
-        // Agora remove recursivamente da subárvore fundida
-        remover(fp, cab, pag.ponteiros[idx], chaveOriginal);
-        return;
+    devolverPagina(fp, cab, rrn);
+    return chaves;
+}
+
+/**
+ * @brief Indica se a chave está em algum dos intervalos
+ */
+static bool chaveRemovida(int chave, const IntervaloRemocao *iv, int nIv) {
+    for (int i = 0; i < nIv && iv[i].lo <= chave; i++) {
+        if (chave <= iv[i].hi) return true;
     }
-    
-    printf("Erro: não foi possível processar remoção em nó interno.\n");
+    return false;
 }
 
-// Função para verificar se um nó precisa de ajuste após remoção
-int verificarUnderflow(FILE *fp, int rrn, int rrnRaiz) {
-    if (rrn == rrnRaiz) return 0; // Raiz pode ter qualquer número de chaves ≥ 0
-    
+/**
+ * @brief Remove de uma subárvore as chaves dos intervalos
+ *
+ * Subárvores sem chaves a remover ficam como estão, e as inteiramente
+ * contidas em um intervalo são descartadas sem passar por rebalanceamento.
+ * Só as páginas que cruzam a borda de um intervalo são refeitas: o que
+ * sobra delas (subárvores intactas, subárvores podadas e chaves mantidas)
+ * é reunido da esquerda para a direita com juntar, que corrige a altura
+ * de cada pedaço uma única vez.
+ *
+ * @param rrn Raiz da subárvore
+ * @param altura Altura da subárvore
+ * @param limInf Limite inferior (exclusivo) das chaves da subárvore
+ * @param limSup Limite superior (exclusivo) das chaves da subárvore
+ * @param iv Intervalos a remover, ordenados e disjuntos
+ * @param nIv Número de intervalos
+ * @param coleta Recebe as chaves removidas (NULL se não interessarem)
+ * @param resultado Recebe a subárvore que sobra (vazia se nada sobrar)
+ * @return Número de chaves removidas
+ */
+static int podarSubarvore(FILE *fp, CabecalhoArvoreB *cab, int rrn, int altura, long long limInf, long long limSup,
+                          const IntervaloRemocao *iv, int nIv, ColetaRemocao *coleta, Subarvore *resultado) {
+    // Só interessam os intervalos que cruzam (limInf, limSup)
+    while (nIv > 0 && iv[0].hi <= limInf) {
+        iv++;
+        nIv--;
+    }
+    int cruzam = 0;
+    while (cruzam < nIv && iv[cruzam].lo < limSup) cruzam++;
+    nIv = cruzam;
+
+    resultado->rrn = rrn;
+    resultado->altura = altura;
+    if (nIv == 0 || rrn == INVALIDO) return 0;
+
+    if (iv[0].lo <= limInf + 1 && iv[0].hi >= limSup - 1) {
+        resultado->rrn = INVALIDO;
+        resultado->altura = 0;
+        return descartarSubarvore(fp, cab, rrn, altura, coleta);
+    }
+
+    // A página é refeita a partir dos pedaços; seu RRN volta à lista de livres e é o primeiro reaproveitado
     PaginaArvoreB pag;
     lerPaginaArvoreB(fp, rrn, &pag);
-    
-    // ✅ Fórmula genérica: nós não-raiz devem ter pelo menos ⌈m/2⌉ - 1 chaves
-    return (pag.nroChaves < MIN_CHAVES_NAO_RAIZ);
-}
+    devolverPagina(fp, cab, rrn);
 
-// Função para tratar underflow em um filho
-void tratarUnderflow(FILE *fp, CabecalhoArvoreB *cab, int paiRRN, int indiceFilho) {
-    PaginaArvoreB pai;
-    lerPaginaArvoreB(fp, paiRRN, &pai);
-    
-    // Tenta redistribuir com irmão anterior
-    if (indiceFilho > 0) {
-        PaginaArvoreB irmaoEsq;
-        lerPaginaArvoreB(fp, pai.ponteiros[indiceFilho - 1], &irmaoEsq);
-        
-        // ✅ Irmão deve ter mais que o mínimo para poder doar
-        if (irmaoEsq.nroChaves > MIN_CHAVES_NAO_RAIZ) {
-            tomarDoAnterior(fp, paiRRN, indiceFilho);
-            return;
+    Subarvore acumulada = {INVALIDO, 0};
+    Subarvore vazia = {INVALIDO, 0};
+    bool pendente = false;
+    int chavePendente = 0;
+    long long prPendente = -1;
+    int removidas = 0;
+
+    for (int i = 0; i <= pag.nroChaves; i++) {
+        if (altura > 1) {
+            long long inf = (i == 0) ? limInf : pag.chaves[i - 1];
+            long long sup = (i == pag.nroChaves) ? limSup : pag.chaves[i];
+            Subarvore filho;
+            removidas += podarSubarvore(fp, cab, pag.ponteiros[i], altura - 1, inf, sup, iv, nIv, coleta, &filho);
+
+            if (filho.altura > 0) {
+                if (pendente) {
+                    acumulada = juntar(fp, cab, acumulada, chavePendente, prPendente, filho);
+                    pendente = false;
+                } else if (acumulada.altura == 0) {
+                    acumulada = filho;
+                } else {
+                    acumulada = juntarSemChave(fp, cab, acumulada, filho);
+                }
+            }
         }
-    }
-    
-    // Tenta redistribuir com irmão posterior
-    if (indiceFilho < pai.nroChaves) {
-        PaginaArvoreB irmaoDir;
-        lerPaginaArvoreB(fp, pai.ponteiros[indiceFilho + 1], &irmaoDir);
-        
-        // ✅ Mesmo critério para irmão direito
-        if (irmaoDir.nroChaves > MIN_CHAVES_NAO_RAIZ) {
-            tomarDoProximo(fp, paiRRN, indiceFilho);
-            return;
+        if (i == pag.nroChaves) break;
+
+        if (chaveRemovida(pag.chaves[i], iv, nIv)) {
+            if (coleta) coleta->chaves[coleta->n++] = pag.chaves[i];
+            removidas++;
+            continue;
         }
+        if (pendente) acumulada = juntar(fp, cab, acumulada, chavePendente, prPendente, vazia);
+        pendente = true;
+        chavePendente = pag.chaves[i];
+        prPendente = pag.pr[i];
     }
-    
-    // Não conseguiu redistribuir, precisa fazer concatenação
-    if (indiceFilho < pai.nroChaves) {
-        // Concatena com irmão da direita
-        fundir(fp, cab, paiRRN, indiceFilho);
+    if (pendente) acumulada = juntar(fp, cab, acumulada, chavePendente, prPendente, vazia);
+
+    *resultado = acumulada;
+    return removidas;
+}
+
+/**
+ * @brief Remove as chaves de um conjunto de intervalos usando um cabeçalho em memória
+ *
+ * Ao final, a raiz recebe o tipoNo de raiz (ou de folha, se for a única página).
+ *
+ * @return Número de chaves removidas
+ */
+static int removerIntervalos(FILE *fp, CabecalhoArvoreB *cab, const IntervaloRemocao *iv, int nIv, ColetaRemocao *coleta) {
+    if (cab->noRaiz == INVALIDO || nIv <= 0) return 0;
+
+    Subarvore raiz;
+    int removidas = podarSubarvore(fp, cab, cab->noRaiz, alturaArvoreB(fp, cab),
+                                   LIMITE_INFERIOR, LIMITE_SUPERIOR, iv, nIv, coleta, &raiz);
+    if (removidas == 0) return 0;
+
+    cab->noRaiz = raiz.rrn;
+    if (raiz.rrn == INVALIDO) {
+        cab->nroNos = 0;
     } else {
-        // Concatena com irmão da esquerda
-        fundir(fp, cab, paiRRN, indiceFilho - 1);
+        PaginaArvoreB pag;
+        lerPaginaArvoreB(fp, raiz.rrn, &pag);
+        pag.tipoNo = (raiz.altura == 1) ? -1 : 0;
+        escreverPaginaArvoreB(fp, raiz.rrn, &pag);
     }
+    return removidas;
 }
 
-// FUNÇÃO PRINCIPAL DE REMOÇÃO (ÚNICA VERSÃO)
-void remover(FILE *fp, CabecalhoArvoreB *cab, int rrnNo, int chave) {  // CORRIGIDO: int chave
-    PaginaArvoreB pag;
-    lerPaginaArvoreB(fp, rrnNo, &pag);
-    
-    int idx = buscarIndiceChave(&pag, chave);
-    
-    if (idx < pag.nroChaves && pag.chaves[idx] == chave) {
-        if (pag.tipoNo == -1) {
-            // Caso 1: Remoção em folha
-            removerDeFolha(fp, rrnNo, idx);
+/**
+ * @brief Remove todas as chaves de [lo, hi] usando um cabeçalho já carregado em memória
+ *
+ * Subárvores inteiramente dentro do intervalo são descartadas e suas
+ * páginas vão para a lista de livres; só os dois caminhos de borda (o de
+ * lo e o de hi) são rebalanceados. O custo é proporcional às páginas
+ * removidas mais as dos caminhos de borda, e não ao tamanho da árvore.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param lo Menor chave do intervalo
+ * @param hi Maior chave do intervalo
+ * @return Número de chaves removidas
+ */
+int removerIntervaloComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int lo, int hi) {
+    if (lo > hi) return 0;
+    IntervaloRemocao intervalo = {lo, hi};
+    return removerIntervalos(fp, cab, &intervalo, 1, NULL);
+}
+
+/**
+ * @brief Remove um conjunto ordenado de chaves usando um cabeçalho já carregado em memória
+ *
+ * IDs consecutivos viram um único intervalo, e todos os intervalos são
+ * removidos em uma só poda: cada página afetada é refeita uma vez, por
+ * mais chaves que perca, e as que ficam vazias vão para a lista de livres.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param ids Chaves a remover, em ordem crescente e sem repetição
+ * @param k Número de chaves
+ * @param removidas Recebe as chaves que estavam na árvore (NULL se não interessarem; espaço para k)
+ * @return Número de chaves removidas, ou -1 se faltar memória (a árvore fica intacta)
+ */
+int removerVariasComCabecalho(FILE *fp, CabecalhoArvoreB *cab, const int ids[], int k, int removidas[]) {
+    if (k <= 0 || cab->noRaiz == INVALIDO) return 0;
+
+    IntervaloRemocao *intervalos = malloc(sizeof(IntervaloRemocao) * k);
+    if (!intervalos) return -1;
+
+    int nIv = 0;
+    for (int i = 0; i < k; i++) {
+        if (nIv > 0 && (long long)intervalos[nIv - 1].hi + 1 == ids[i]) {
+            intervalos[nIv - 1].hi = ids[i];
         } else {
-            // Caso 2: Remoção em nó interno
-            removerDeInterno(fp, cab, rrnNo, idx);
-        }
-    } else {
-        if (pag.tipoNo == -1) return; // Chave não encontrada
-        
-        // Encontra o filho correto e continua a busca
-        int indiceFilho = idx;
-        if (pag.ponteiros[indiceFilho] != INVALIDO) {
-            remover(fp, cab, pag.ponteiros[indiceFilho], chave);
-            
-            // APÓS a remoção recursiva, verifica se o filho precisa de ajuste
-            if (verificarUnderflow(fp, pag.ponteiros[indiceFilho], cab->noRaiz)) {
-                tratarUnderflow(fp, cab, rrnNo, indiceFilho);
-            }
+            intervalos[nIv].lo = ids[i];
+            intervalos[nIv].hi = ids[i];
+            nIv++;
         }
     }
+
+    ColetaRemocao coleta = {removidas, 0};
+    int total = removerIntervalos(fp, cab, intervalos, nIv, removidas ? &coleta : NULL);
+    free(intervalos);
+    return total;
 }
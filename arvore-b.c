@@ -10,6 +10,9 @@
 #include "arvore-b.h"
 #include "record.h"
 #include "utils.h"
+#include "wal.h"
+#include "header.h"
+#include "filtro-bloom.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,12 +27,14 @@
  * Esta função lê todos os registros válidos de um arquivo de dados
  * e constrói um índice árvore-B onde as chaves são os IDs dos registros
  * e os valores são os byte offsets dos registros no arquivo de dados.
+ * O cabeçalho fica em memória até o fim, e o filtro de Bloom do índice
+ * ("<índice>.bloom") é gerado junto.
  * 
  * @param dataFilename Nome do arquivo de dados
  * @param btreeFilename Nome do arquivo de índice a ser criado
  */
 void buildBTreeFromDataFile(const char *dataFilename, const char *btreeFilename) {
-    FILE *dataFile = fopen(dataFilename, "rb");
+    FILE *dataFile = wal_fopen(dataFilename, "rb");
     if (!dataFile) {
         printf("Falha no processamento do arquivo.\n");
         return;
@@ -49,19 +54,27 @@ void buildBTreeFromDataFile(const char *dataFilename, const char *btreeFilename)
         return;
     }
 
-    FILE *btreeFile = fopen(btreeFilename, "wb+");
+    FILE *btreeFile = wal_fopen(btreeFilename, "wb+");
     if (!btreeFile) {
         printf("Falha no processamento do arquivo.\n");
         fclose(dataFile);
         return;
     }
 
-    // Inicializa o cabeçalho da árvore-B
+    // Inicializa o cabeçalho da árvore-B, mantido em memória durante a construção
     inicializaCabecalhoArvoreB(btreeFile);
+    CabecalhoArvoreB cab;
+    lerCabecalhoArvoreB(btreeFile, &cab);
+
+    // Filtro de Bloom dimensionado pelo número de registros do arquivo de dados
+    Header dataHeader;
+    readHeader(dataFile, &dataHeader);
+    FiltroBloom *filtro = bloom_criar(dataHeader.nroRegArq);
 
     // Pula o cabeçalho do arquivo de dados (276 bytes)
     if (fseek(dataFile, 276, SEEK_SET) != 0) {
         printf("Falha no processamento do arquivo.\n");
+        bloom_liberar(filtro);
         fclose(dataFile);
         fclose(btreeFile);
         return;
@@ -92,7 +105,8 @@ void buildBTreeFromDataFile(const char *dataFilename, const char *btreeFilename)
         // Apenas registros não removidos são inseridos no índice
         if (record.removido == '0') {
             // Usa o offset salvo antes da leitura
-            btree_insert(btreeFile, record.id, recordOffset);
+            inserirComCabecalho(btreeFile, &cab, record.id, recordOffset);
+            bloom_adicionar(filtro, record.id);
             recordCount++;
         }
 
@@ -103,10 +117,20 @@ void buildBTreeFromDataFile(const char *dataFilename, const char *btreeFilename)
         if (record.defenseStrategy) free(record.defenseStrategy);
     }
 
-    // Marca o arquivo como consistente
-    CabecalhoArvoreB cab;
-    lerCabecalhoArvoreB(btreeFile, &cab);
+    // Filtro dimensionado para a quantidade final de chaves
+    if (bloom_sobrecarregado(filtro)) {
+        bloom_liberar(filtro);
+        filtro = bloom_reconstruir(btreeFile, &cab);
+    }
+
+    // O filtro é gravado antes de o índice ficar consistente
     cab.status = '1';
+    if (!bloom_salvar(filtro, btreeFilename, &cab)) {
+        cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+    }
+    bloom_liberar(filtro);
+
+    // Marca o arquivo como consistente
     escreverCabecalhoArvoreB(btreeFile, &cab);
 
     fclose(dataFile);
@@ -125,30 +149,48 @@ void buildBTreeFromDataFile(const char *dataFilename, const char *btreeFilename)
  */
 void printRecordFromBTree(const char *dataFilename, const char *btreeFilename, int id) {
     
-    FILE *btreeFile = fopen(btreeFilename, "rb");
+    FILE *btreeFile = wal_fopen(btreeFilename, "rb");
     if (!btreeFile) {
         printf("Falha no processamento do arquivo.\n");
         return;
     }
     
-    long long offset = btree_search(btreeFile, id);
+    // Filtro de Bloom em dia descarta IDs inexistentes sem descer na árvore
+    CabecalhoArvoreB cab;
+    lerCabecalhoArvoreB(btreeFile, &cab);
+    long long offset = -1;
+    if (bloom_consultar_arquivo(btreeFilename, &cab, id) != 0) {
+        offset = btree_search(btreeFile, id);
+    }
     fclose(btreeFile);
-    
+
+    printIndexedRecord(dataFilename, offset);
+}
+
+/**
+ * @brief Imprime o registro localizado por um índice
+ * 
+ * Lê e imprime o registro no byte offset devolvido pela busca no índice,
+ * ou a mensagem de registro inexistente se o offset for -1.
+ * 
+ * @param dataFilename Nome do arquivo de dados
+ * @param offset Byte offset do registro (-1 se não encontrado)
+ */
+void printIndexedRecord(const char *dataFilename, long long offset) {
     int found = 0; // Flag para rastrear se o registro foi encontrado
 
     if (offset == -1) {
         found = 0;
     } else {
-        FILE *dataFile = fopen(dataFilename, "rb");
+        FILE *dataFile = wal_fopen(dataFilename, "rb");
         if (!dataFile) {
             printf("Falha no processamento do arquivo.\n");
             return;
         }
 
-        fseek(dataFile, offset, SEEK_SET);
-
+        // O índice pode apontar para o esboço de um registro encaminhado
         Record record;
-        if (readRecord(dataFile, &record)) {
+        if (readRecordFollowing(dataFile, &offset, &record)) {
             printRecord(record);
             found = 1;
 
@@ -179,13 +221,15 @@ void printRecordFromBTree(const char *dataFilename, const char *btreeFilename, i
  * 
  * Esta função remove uma chave específica da árvore-B, mantendo
  * as propriedades da estrutura através de redistribuições e fusões
- * quando necessário.
+ * quando necessário. A remoção desce uma única vez e grava cada
+ * página alterada uma única vez; o cabeçalho só é regravado se a
+ * chave existia.
  * 
  * @param btreeFile Ponteiro para o arquivo da árvore-B aberto
  * @param id ID do registro a ser removido
  * @return 1 se removido com sucesso, 0 se não encontrado
  */
-int btree_remove(FILE *btreeFile, int id) {  // CORRIGIDO: int id
+int btree_remove(FILE *btreeFile, int id) {
     CabecalhoArvoreB cab;
     lerCabecalhoArvoreB(btreeFile, &cab);
     
@@ -193,41 +237,106 @@ int btree_remove(FILE *btreeFile, int id) {  // CORRIGIDO: int id
         return 0; // Árvore vazia
     }
     
-    // Busca primeiro para verificar se a chave existe
-    long long offset = btree_search(btreeFile, id);  // CORRIGIDO: int id
-    if (offset == -1) {
+    if (!removerComCabecalho(btreeFile, &cab, id)) {
         return 0; // Chave não encontrada
     }
     
-    // Executa a remoção
-    remover(btreeFile, &cab, cab.noRaiz, id);  // CORRIGIDO: int id
-    
-    // Verifica se a raiz ficou vazia (redução de altura)
-    PaginaArvoreB raiz;
-    lerPaginaArvoreB(btreeFile, cab.noRaiz, &raiz);
-    
-    if (raiz.nroChaves == 0 && raiz.tipoNo != -1) {
-        // Raiz ficou vazia, promove o único filho
-        if (raiz.ponteiros[0] != INVALIDO) {
-            int novaRaizRRN = raiz.ponteiros[0];
-            cab.noRaiz = novaRaizRRN;
-            
-            // Atualiza o tipo do novo nó raiz
-            PaginaArvoreB novaRaiz;
-            lerPaginaArvoreB(btreeFile, novaRaizRRN, &novaRaiz);
-            novaRaiz.tipoNo = 0; // Marca como raiz
-            escreverPaginaArvoreB(btreeFile, novaRaizRRN, &novaRaiz);
-            
-            cab.nroNos--;
-        } else {
-            // Árvore ficou completamente vazia
-            cab.noRaiz = -1;
-            cab.nroNos = 0;
+    // Remoção fora de uma sessão não atualiza o filtro de Bloom
+    cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+    escreverCabecalhoArvoreB(btreeFile, &cab);
+    return 1; // Sucesso
+}
+
+static int compararInt(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Cópia ordenada e sem repetições de um vetor de IDs
+ *
+ * @param ids IDs em qualquer ordem
+ * @param n Número de IDs
+ * @param k Recebe o número de IDs distintos
+ * @return Vetor alocado (liberar com free), ou NULL se faltar memória
+ */
+static int *ordenarSemRepeticao(const int ids[], int n, int *k) {
+    int *ordenados = malloc(sizeof(int) * n);
+    if (!ordenados) return NULL;
+    memcpy(ordenados, ids, sizeof(int) * n);
+    qsort(ordenados, n, sizeof(int), compararInt);
+
+    *k = 0;
+    for (int i = 0; i < n; i++) {
+        if (*k == 0 || ordenados[i] != ordenados[*k - 1]) {
+            ordenados[(*k)++] = ordenados[i];
         }
     }
-    
+    return ordenados;
+}
+
+/**
+ * @brief Remove um conjunto de chaves da árvore-B
+ * 
+ * As chaves são ordenadas e deduplicadas e saem todas em uma única poda
+ * (ver removerVariasComCabecalho). Como a poda regrava várias páginas, o
+ * índice precisa estar consistente e fica marcado como inconsistente até
+ * o cabeçalho final ser gravado.
+ * 
+ * @param btreeFile Ponteiro para o arquivo da árvore-B aberto
+ * @param ids IDs a serem removidos
+ * @param n Número de IDs
+ * @return Número de chaves removidas, ou -1 se o índice estiver inconsistente ou faltar memória
+ */
+int btree_remove_many(FILE *btreeFile, const int ids[], int n) {
+    CabecalhoArvoreB cab;
+    lerCabecalhoArvoreB(btreeFile, &cab);
+    if (cab.status != '1') return -1;
+    if (n <= 0) return 0;
+
+    int k;
+    int *ordenados = ordenarSemRepeticao(ids, n, &k);
+    if (!ordenados) return -1;
+
+    cab.status = '0';
     escreverCabecalhoArvoreB(btreeFile, &cab);
-    return 1; // Sucesso
+
+    int removidas = removerVariasComCabecalho(btreeFile, &cab, ordenados, k, NULL);
+    // Remoção fora de uma sessão não atualiza o filtro de Bloom
+    if (removidas > 0) cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+    cab.status = '1';
+    escreverCabecalhoArvoreB(btreeFile, &cab);
+
+    free(ordenados);
+    return removidas;
+}
+
+/**
+ * @brief Remove da árvore-B todas as chaves do intervalo [lo, hi]
+ * 
+ * Só o índice é alterado: os registros do arquivo de dados continuam
+ * ativos. Como em btree_remove_many, o índice precisa estar consistente
+ * e fica marcado como inconsistente enquanto as páginas são regravadas.
+ * 
+ * @param btreeFile Ponteiro para o arquivo da árvore-B aberto
+ * @param lo Menor ID do intervalo
+ * @param hi Maior ID do intervalo
+ * @return Número de chaves removidas, ou -1 se o índice estiver inconsistente
+ */
+int btree_remove_range(FILE *btreeFile, int lo, int hi) {
+    CabecalhoArvoreB cab;
+    lerCabecalhoArvoreB(btreeFile, &cab);
+    if (cab.status != '1') return -1;
+
+    cab.status = '0';
+    escreverCabecalhoArvoreB(btreeFile, &cab);
+
+    int removidas = removerIntervaloComCabecalho(btreeFile, &cab, lo, hi);
+    // Remoção fora de uma sessão não atualiza o filtro de Bloom
+    if (removidas > 0) cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+    cab.status = '1';
+    escreverCabecalhoArvoreB(btreeFile, &cab);
+    return removidas;
 }
 
 
@@ -241,7 +350,7 @@ int btree_remove(FILE *btreeFile, int id) {  // CORRIGIDO: int id
  * @param btreeFilename Nome do arquivo de índice
  */
 void printCabecalhoEPaginasArvoreB(const char *btreeFilename) {
-    FILE *fp = fopen(btreeFilename, "rb");
+    FILE *fp = wal_fopen(btreeFilename, "rb");
     if (!fp) {
         printf("Falha no processamento do arquivo.\n");
         return;
@@ -286,28 +395,21 @@ void printCabecalhoEPaginasArvoreB(const char *btreeFilename) {
  * 
  * Esta função adiciona uma entrada na árvore-B sem necessidade de buscar
  * no arquivo de dados, utilizando diretamente o ID e o offset fornecidos.
+ * Para inserir várias chaves, prefira abrir uma única sessão com btree_open.
  * 
  * @param btreeFile Nome do arquivo de índice da árvore-B.
  * @param id ID do registro a ser inserido no índice.
  * @param offset Byte offset do registro no arquivo de dados.
  */
 void insertBtreeEntry(const char *btreeFile, int id, long long offset) {
-    FILE *btreeFilePointer = fopen(btreeFile, "rb+");
-    if (!btreeFilePointer) {
+    SessaoArvoreB *sessao = btree_open(btreeFile);
+    if (!sessao) {
         printf("Falha no processamento do arquivo.\n");
         return;
     }
 
-    // Insere diretamente na árvore-B usando a função existente
-    btree_insert(btreeFilePointer, id, offset);
-
-    // Atualiza o status para consistente
-    CabecalhoArvoreB cab;
-    lerCabecalhoArvoreB(btreeFilePointer, &cab);
-    cab.status = '1';
-    escreverCabecalhoArvoreB(btreeFilePointer, &cab);
-
-    fclose(btreeFilePointer);
+    btree_session_insert(sessao, id, offset);
+    btree_close(sessao);
 }
 
 
@@ -332,9 +434,70 @@ int btree_update_offset(FILE *btreeFile, int id, long long newOffset) {
         return 0; // Falha
     }
     
-    if (cab.noRaiz == -1) return 0; // Árvore vazia
+    return atualizarOffsetComCabecalho(btreeFile, &cab, id, newOffset);
+}
+
+/**
+ * @brief Traduz em lote os byte offsets da árvore-B após a compactação do arquivo de dados
+ *
+ * Percorre as páginas em ordem de RRN (leitura sequencial, sem descidas)
+ * e regrava apenas as que tiveram algum offset alterado. As chaves não
+ * mudam, então o filtro de Bloom continua válido. Chaves cujo registro não
+ * está no mapa ficam com offset -1, como uma busca sem sucesso.
+ *
+ * @param btreeFile Ponteiro para o arquivo da árvore-B aberto
+ * @param antigos Offsets antigos, em ordem crescente
+ * @param novos Offsets novos correspondentes
+ * @param n Número de entradas do mapa
+ * @return Número de offsets alterados, -1 se o índice estiver inconsistente
+ */
+int btree_remap_offsets(FILE *btreeFile, const long long antigos[], const long long novos[], int n) {
+    CabecalhoArvoreB cab;
+    lerCabecalhoArvoreB(btreeFile, &cab);
+    if (cab.status != '1') return -1;
+
+    cab.status = '0';
+    escreverCabecalhoArvoreB(btreeFile, &cab);
 
-    int rrn = cab.noRaiz;
+    int alterados = 0;
+    for (int rrn = 0; rrn < cab.proxRRN; rrn++) {
+        PaginaArvoreB pag;
+        lerPaginaArvoreB(btreeFile, rrn, &pag);
+        if (pag.tipoNo == PAGINA_LIVRE || pag.nroChaves < 0 || pag.nroChaves > MAX_CHAVES) continue;
+
+        bool suja = false;
+        for (int i = 0; i < pag.nroChaves; i++) {
+            long long novo = remapearOffset(antigos, novos, n, pag.pr[i]);
+            if (novo != pag.pr[i]) {
+                pag.pr[i] = novo;
+                suja = true;
+                alterados++;
+            }
+        }
+        if (suja) escreverPaginaArvoreB(btreeFile, rrn, &pag);
+    }
+
+    cab.status = '1';
+    escreverCabecalhoArvoreB(btreeFile, &cab);
+    return alterados;
+}
+
+/**
+ * @brief Atualiza o byte offset de uma chave a partir de um cabeçalho em memória
+ * 
+ * Desce da raiz indicada no cabeçalho até a página que contém a chave e
+ * regrava apenas essa página. O cabeçalho não é lido nem gravado.
+ * 
+ * @param btreeFile Ponteiro para o arquivo da árvore-B aberto
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param id ID do registro cuja chave será atualizada
+ * @param newOffset Novo byte offset do registro
+ * @return 1 se atualizado com sucesso, 0 se não encontrado
+ */
+int atualizarOffsetComCabecalho(FILE *btreeFile, CabecalhoArvoreB *cab, int id, long long newOffset) {
+    if (cab->noRaiz == -1) return 0; // Árvore vazia
+
+    int rrn = cab->noRaiz;
     while (1) {
         PaginaArvoreB pag;
         lerPaginaArvoreB(btreeFile, rrn, &pag);
@@ -360,6 +523,229 @@ int btree_update_offset(FILE *btreeFile, int id, long long newOffset) {
 }
 
 
+/**
+ * @brief Abre uma sessão sobre o arquivo de índice
+ * 
+ * Abre o arquivo uma única vez, carrega o cabeçalho em memória e o marca
+ * como inconsistente no disco enquanto a sessão estiver aberta. Todas as
+ * inserções e atualizações de offset do lote devem passar pela sessão.
+ * O filtro de Bloom do índice é carregado ou, se ausente ou desatualizado,
+ * remontado com uma passada pela árvore.
+ * 
+ * @param btreeFilename Nome do arquivo de índice
+ * @return Sessão aberta ou NULL em caso de falha
+ */
+SessaoArvoreB *btree_open(const char *btreeFilename) {
+    if (!btreeFilename) return NULL;
+
+    FILE *fp = wal_fopen(btreeFilename, "rb+");
+    if (!fp) {
+        return NULL;
+    }
+
+    SessaoArvoreB *sessao = malloc(sizeof(SessaoArvoreB));
+    if (!sessao) {
+        fclose(fp);
+        return NULL;
+    }
+
+    sessao->fp = fp;
+    lerCabecalhoArvoreB(fp, &sessao->cab);
+
+    // Índice inconsistente não pode ser usado
+    if (sessao->cab.status != '1') {
+        fclose(fp);
+        free(sessao);
+        return NULL;
+    }
 
+    // Filtro ausente ou desatualizado é remontado a partir da árvore
+    sessao->nomeArquivo = malloc(strlen(btreeFilename) + 1);
+    if (sessao->nomeArquivo) strcpy(sessao->nomeArquivo, btreeFilename);
+    sessao->filtro = bloom_carregar(btreeFilename, &sessao->cab);
+    if (!sessao->filtro) {
+        sessao->filtro = bloom_reconstruir(fp, &sessao->cab);
+    }
+    sessao->cab.filtroDesatualizado = (sessao->filtro && sessao->nomeArquivo) ? FILTRO_EM_DIA : FILTRO_DESATUALIZADO;
+
+    // Marca o arquivo como inconsistente enquanto a sessão estiver aberta
+    sessao->cab.status = '0';
+    escreverCabecalhoArvoreB(fp, &sessao->cab);
+
+    return sessao;
+}
+
+/**
+ * @brief Insere uma chave usando o cabeçalho mantido pela sessão
+ * 
+ * @param sessao Sessão aberta
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ */
+void btree_session_insert(SessaoArvoreB *sessao, int id, long long byteOffset) {
+    if (!sessao) return;
+    inserirComCabecalho(sessao->fp, &sessao->cab, id, byteOffset);
+    bloom_adicionar(sessao->filtro, id);
+}
 
+/**
+ * @brief Atualiza o byte offset de uma chave usando a sessão
+ * 
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int btree_session_update_offset(SessaoArvoreB *sessao, int id, long long newOffset) {
+    if (!sessao) return 0;
+    return atualizarOffsetComCabecalho(sessao->fp, &sessao->cab, id, newOffset);
+}
 
+/**
+ * @brief Remove uma chave usando a sessão
+ * 
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int btree_session_remove(SessaoArvoreB *sessao, int id) {
+    if (!sessao) return 0;
+    if (!bloom_pode_conter(sessao->filtro, id)) return 0;
+    if (!removerComCabecalho(sessao->fp, &sessao->cab, id)) return 0;
+    bloom_remover(sessao->filtro, id);
+    return 1;
+}
+
+/**
+ * @brief Remove um conjunto de chaves usando a sessão
+ * 
+ * IDs descartados pelo filtro de Bloom nem chegam à árvore; os demais
+ * saem em uma única poda, e só as chaves que de fato estavam na árvore
+ * são retiradas do filtro. Sem memória para o lote, remove chave a chave.
+ * 
+ * @param sessao Sessão aberta
+ * @param ids IDs a serem removidos
+ * @param n Número de IDs
+ * @return Número de chaves removidas
+ */
+int btree_session_remove_many(SessaoArvoreB *sessao, const int ids[], int n) {
+    if (!sessao || n <= 0) return 0;
+
+    int k;
+    int *ordenados = ordenarSemRepeticao(ids, n, &k);
+    int *removidas = malloc(sizeof(int) * n);
+    if (!ordenados || !removidas) {
+        free(ordenados);
+        free(removidas);
+        int total = 0;
+        for (int i = 0; i < n; i++) total += btree_session_remove(sessao, ids[i]);
+        return total;
+    }
+
+    int candidatos = 0;
+    for (int i = 0; i < k; i++) {
+        if (bloom_pode_conter(sessao->filtro, ordenados[i])) ordenados[candidatos++] = ordenados[i];
+    }
+
+    int total = removerVariasComCabecalho(sessao->fp, &sessao->cab, ordenados, candidatos, removidas);
+    if (total < 0) {
+        total = 0;
+        for (int i = 0; i < candidatos; i++) total += btree_session_remove(sessao, ordenados[i]);
+    } else {
+        for (int i = 0; i < total; i++) bloom_remover(sessao->filtro, removidas[i]);
+    }
+
+    free(ordenados);
+    free(removidas);
+    return total;
+}
+
+/**
+ * @brief Busca uma chave usando a sessão
+ * 
+ * IDs descartados pelo filtro de Bloom custam apenas a consulta aos
+ * contadores em memória, sem leitura de páginas.
+ * 
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long btree_session_search(SessaoArvoreB *sessao, int id) {
+    if (!sessao) return -1;
+    if (!bloom_pode_conter(sessao->filtro, id)) return -1;
+    return buscarComCabecalho(sessao->fp, &sessao->cab, id);
+}
+
+/**
+ * @brief Byte offset da chave vizinha mais próxima de um ID, usando a sessão
+ * 
+ * Para um ID ausente, o antecessor e o sucessor em ordem estão no caminho
+ * da descida: são a maior chave menor e a menor chave maior vistas nele.
+ * Devolve o offset da mais próxima em ID (o antecessor, em caso de empate);
+ * se o próprio ID estiver na árvore, devolve o offset dele.
+ * 
+ * @param sessao Sessão aberta
+ * @param id ID de referência
+ * @return Byte offset da chave vizinha ou -1 se a árvore estiver vazia
+ */
+long long btree_session_search_neighbor(SessaoArvoreB *sessao, int id) {
+    if (!sessao || sessao->cab.noRaiz == -1) return -1;
+
+    long long antecessor = -1, sucessor = -1;
+    long long distAntecessor = 0, distSucessor = 0;
+    int rrn = sessao->cab.noRaiz;
+    while (rrn != INVALIDO) {
+        PaginaArvoreB pag;
+        lerPaginaArvoreB(sessao->fp, rrn, &pag);
+
+        int i = 0;
+        while (i < pag.nroChaves && pag.chaves[i] < id) i++;
+        if (i < pag.nroChaves && pag.chaves[i] == id) return pag.pr[i];
+
+        // Cada nível mais fundo só aproxima os vizinhos
+        if (i > 0) {
+            antecessor = pag.pr[i - 1];
+            distAntecessor = (long long)id - pag.chaves[i - 1];
+        }
+        if (i < pag.nroChaves) {
+            sucessor = pag.pr[i];
+            distSucessor = (long long)pag.chaves[i] - id;
+        }
+        rrn = pag.ponteiros[i];
+    }
+
+    if (antecessor == -1) return sucessor;
+    if (sucessor == -1) return antecessor;
+    return distAntecessor <= distSucessor ? antecessor : sucessor;
+}
+
+/**
+ * @brief Grava o cabeçalho como consistente e fecha a sessão
+ * 
+ * É o único ponto em que o cabeçalho é regravado durante um lote. O
+ * filtro de Bloom é gravado antes, para que um índice consistente nunca
+ * aponte para um filtro mais antigo que ele; se estiver sobrecarregado,
+ * é remontado maior. Dentro de um lote, o filtro vai pelo log junto com
+ * as páginas, e os dois chegam ao disco no mesmo checkpoint.
+ * 
+ * @param sessao Sessão aberta (liberada por esta função)
+ */
+void btree_close(SessaoArvoreB *sessao) {
+    if (!sessao) return;
+
+    sessao->cab.status = '1';
+    if (sessao->filtro && bloom_sobrecarregado(sessao->filtro)) {
+        bloom_liberar(sessao->filtro);
+        sessao->filtro = bloom_reconstruir(sessao->fp, &sessao->cab);
+    }
+    if (!sessao->filtro || !sessao->nomeArquivo ||
+        !bloom_salvar(sessao->filtro, sessao->nomeArquivo, &sessao->cab)) {
+        sessao->cab.filtroDesatualizado = FILTRO_DESATUALIZADO;
+    }
+    escreverCabecalhoArvoreB(sessao->fp, &sessao->cab);
+
+    fclose(sessao->fp);
+    bloom_liberar(sessao->filtro);
+    free(sessao->nomeArquivo);
+    free(sessao);
+}
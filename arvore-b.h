@@ -7,6 +7,9 @@
  * de ataques cibernéticos.
  */
 
+#ifndef ARVORE_B_H
+#define ARVORE_B_H
+
 #include <stdio.h>
 #include <stdbool.h>
 
@@ -15,6 +18,17 @@
 #define MAX_PONTEIROS ORDEM
 #define MIN_CHAVES_NAO_RAIZ ((ORDEM + 1) / 2 - 1)
 #define MIN_CHAVES_PARA_REDISTRIBUIR (MIN_CHAVES_NAO_RAIZ + 1)
+#define ALTURA_MAX 32
+
+#define PAGINA_LIVRE 2   // tipoNo de uma página na lista de páginas livres
+
+// Situação do filtro de Bloom "<índice>.bloom" em relação ao índice
+#define FILTRO_EM_DIA '$'          // Byte original do lixo: filtro ausente ou em dia
+#define FILTRO_DESATUALIZADO '1'   // Índice alterado por operação que não mantém o filtro
+
+// Ordem das páginas no arquivo gerado por btree_compact
+#define LAYOUT_LARGURA 0
+#define LAYOUT_VAN_EMDE_BOAS 1
 
 /**
  * @brief Estrutura do cabeçalho da árvore-B
@@ -24,14 +38,18 @@ typedef struct {
     int noRaiz;         // RRN do nó raiz (-1 se árvore vazia)
     int proxRRN;        // Próximo RRN disponível
     int nroNos;         // Número total de nós na árvore
-    char lixo[31];      // Preenchimento para completar 44 bytes
+    int topoLivres;     // RRN da primeira página livre (-1 se não houver; gravado como "$$$$")
+    char filtroDesatualizado; // FILTRO_EM_DIA ou FILTRO_DESATUALIZADO
+    char lixo[26];      // Preenchimento para completar 44 bytes
 } CabecalhoArvoreB;
 
+typedef struct FiltroBloom FiltroBloom;
+
 /**
  * @brief Estrutura de uma página (nó) da árvore-B
  */
 typedef struct PaginaArvoreB {
-    int tipoNo;                       // -1 (folha), 0 (raiz), 1 (intermediário)
+    int tipoNo;                       // -1 (folha), 0 (raiz), 1 (intermediário), 2 (livre)
     int nroChaves;                    // Número de chaves presentes no nó
     int ponteiros[MAX_PONTEIROS];     // RRN dos filhos
     int chaves[MAX_CHAVES];           // Chaves (IDs dos registros)
@@ -40,15 +58,35 @@ typedef struct PaginaArvoreB {
 } PaginaArvoreB;
 
 /**
- * @brief Estrutura para resultado de operação de split
+ * @brief Sessão aberta sobre um arquivo de índice árvore-B
+ *
+ * Mantém o arquivo aberto e o cabeçalho em memória durante um lote de
+ * operações. O cabeçalho é marcado como inconsistente na abertura e só
+ * é regravado (consistente) no fechamento da sessão. O filtro de Bloom
+ * do índice é mantido em memória e gravado no fechamento.
+ */
+typedef struct {
+    FILE *fp;                 // Arquivo de índice aberto em modo "rb+"
+    CabecalhoArvoreB cab;     // Cabeçalho mantido em memória
+    FiltroBloom *filtro;      // Filtro de Bloom mantido junto com o índice (NULL se indisponível)
+    char *nomeArquivo;        // Nome do índice, usado para gravar o filtro no fechamento
+} SessaoArvoreB;
+
+/**
+ * @brief Caminho raiz-folha mantido em memória
+ *
+ * Guarda as páginas visitadas em uma descida, o índice do filho seguido
+ * em cada nível e o intervalo aberto (limiteInf, limiteSup) de chaves que
+ * pertencem a cada página do caminho.
  */
 typedef struct {
-    bool houveSplit;          // Indica se houve divisão do nó
-    int chavePromovida;       // Chave promovida para o nível superior
-    long long prPromovido;    // Byte offset da chave promovida
-    int ponteiroEsq;          // RRN do nó à esquerda
-    int ponteiroDir;          // RRN do nó à direita
-} ResultadoSplit;
+    PaginaArvoreB paginas[ALTURA_MAX];   // Páginas do caminho (0 = raiz)
+    int indices[ALTURA_MAX];             // Índice do filho seguido em cada nível
+    bool sujas[ALTURA_MAX];              // Página alterada e ainda não gravada
+    long long limiteInf[ALTURA_MAX];     // Limite inferior (exclusivo) de cada nível
+    long long limiteSup[ALTURA_MAX];     // Limite superior (exclusivo) de cada nível
+    int altura;                          // Número de níveis válidos (0 = vazio)
+} CaminhoArvoreB;
 
 /**
  * @brief Estrutura para resultado de operação de remoção
@@ -75,6 +113,13 @@ void buildBTreeFromDataFile(const char *dataFilename, const char *btreeFilename)
  */
 void printRecordFromBTree(const char *btreeFilename, const char *dataFilename, int id);
 
+/**
+ * @brief Imprime o registro no byte offset encontrado por um índice
+ * @param dataFilename Nome do arquivo de dados
+ * @param offset Byte offset do registro (-1 imprime "Registro inexistente.")
+ */
+void printIndexedRecord(const char *dataFilename, long long offset);
+
 /**
  * @brief Imprime todas as páginas da árvore-B para debug
  * @param btreeFilename Nome do arquivo de índice
@@ -97,6 +142,24 @@ void btree_insert(FILE *btreeFile, int id, long long byteOffset);
  */
 int btree_remove(FILE *btreeFile, int id);
 
+/**
+ * @brief Remove um conjunto de chaves da árvore-B
+ * @param btreeFile Ponteiro para o arquivo da árvore-B
+ * @param ids IDs a serem removidos (em qualquer ordem, repetições são ignoradas)
+ * @param n Número de IDs
+ * @return Número de chaves removidas, ou -1 se o índice estiver inconsistente ou faltar memória
+ */
+int btree_remove_many(FILE *btreeFile, const int ids[], int n);
+
+/**
+ * @brief Remove da árvore-B todas as chaves do intervalo [lo, hi] (o arquivo de dados não é alterado)
+ * @param btreeFile Ponteiro para o arquivo da árvore-B
+ * @param lo Menor ID do intervalo
+ * @param hi Maior ID do intervalo
+ * @return Número de chaves removidas, ou -1 se o índice estiver inconsistente
+ */
+int btree_remove_range(FILE *btreeFile, int lo, int hi);
+
 /**
  * @brief Busca uma chave na árvore-B
  * @param fp Ponteiro para o arquivo da árvore-B
@@ -114,6 +177,16 @@ long long btree_search(FILE *fp, int id);
  */
 int btree_update_offset(FILE *btreeFile, int id, long long newOffset);
 
+/**
+ * @brief Traduz todos os byte offsets da árvore-B pelo mapa da compactação do arquivo de dados
+ * @param btreeFile Ponteiro para o arquivo da árvore-B
+ * @param antigos Offsets antigos, em ordem crescente
+ * @param novos Offsets novos correspondentes
+ * @param n Número de entradas do mapa
+ * @return Número de offsets alterados, -1 se o índice estiver inconsistente
+ */
+int btree_remap_offsets(FILE *btreeFile, const long long antigos[], const long long novos[], int n);
+
 /**
  * @brief Insere uma entrada diretamente na árvore-B
  * @param btreeFile Nome do arquivo de índice
@@ -122,6 +195,116 @@ int btree_update_offset(FILE *btreeFile, int id, long long newOffset);
  */
 void insertBtreeEntry(const char *btreeFile, int id, long long offset);
 
+/**
+ * @brief Reescreve o índice em ordem de chave e o substitui atomicamente
+ * @param btreeFilename Nome do arquivo de índice (precisa estar consistente)
+ * @param fatorPreenchimento Porcentagem de ocupação das páginas (1 a 100)
+ * @param layout LAYOUT_LARGURA ou LAYOUT_VAN_EMDE_BOAS
+ * @return 1 se o índice foi compactado, 0 em caso de falha, -1 se o layout for desconhecido
+ */
+int btree_compact(const char *btreeFilename, int fatorPreenchimento, int layout);
+
+/**
+ * @brief Coleta, em ordem crescente, as chaves de [lo, hi] de uma subárvore
+ * @param fp Ponteiro para o arquivo
+ * @param rrn RRN da raiz da subárvore
+ * @param lo Menor chave coletada
+ * @param hi Maior chave coletada
+ * @param chaves Vetor que recebe as chaves
+ * @param pr Vetor que recebe os byte offsets
+ * @param n Número de chaves já presentes nos vetores
+ * @param capacidade Capacidade dos vetores
+ * @return Novo número de chaves nos vetores ou -1 em caso de inconsistência
+ */
+int coletarChavesArvoreB(FILE *fp, int rrn, int lo, int hi, int *chaves, long long *pr, int n, int capacidade);
+
+/**
+ * @brief Regrava todo o índice, a partir do RRN 0, com chaves já ordenadas
+ * @param fp Ponteiro para o arquivo de destino
+ * @param cab Cabeçalho em memória (não é gravado)
+ * @param chaves Chaves em ordem crescente (alteradas)
+ * @param pr Byte offsets correspondentes (alterados)
+ * @param n Número de chaves
+ * @param fatorPreenchimento Porcentagem de ocupação das páginas (1 a 100)
+ * @param layout LAYOUT_LARGURA ou LAYOUT_VAN_EMDE_BOAS
+ * @return 1 se a árvore foi regravada, 0 caso contrário
+ */
+int reconstruirArvoreB(FILE *fp, CabecalhoArvoreB *cab, int *chaves, long long *pr, int n, int fatorPreenchimento, int layout);
+
+// ================= SESSÃO DE ÍNDICE =================
+
+/**
+ * @brief Abre uma sessão sobre o arquivo de índice
+ * @param btreeFilename Nome do arquivo de índice
+ * @return Sessão aberta ou NULL se o arquivo não existir ou estiver inconsistente
+ */
+SessaoArvoreB *btree_open(const char *btreeFilename);
+
+/**
+ * @brief Insere uma chave usando o cabeçalho mantido pela sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ */
+void btree_session_insert(SessaoArvoreB *sessao, int id, long long byteOffset);
+
+/**
+ * @brief Atualiza o byte offset de uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int btree_session_update_offset(SessaoArvoreB *sessao, int id, long long newOffset);
+
+/**
+ * @brief Insere um lote de chaves reaproveitando o caminho raiz-folha
+ * @param sessao Sessão aberta
+ * @param ids IDs dos registros (não precisam estar ordenados)
+ * @param offsets Byte offsets correspondentes
+ * @param n Número de chaves do lote
+ */
+void btree_insert_batch(SessaoArvoreB *sessao, const int ids[], const long long offsets[], int n);
+
+/**
+ * @brief Remove uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int btree_session_remove(SessaoArvoreB *sessao, int id);
+
+/**
+ * @brief Remove um conjunto de chaves usando a sessão, mantendo o filtro de Bloom
+ * @param sessao Sessão aberta
+ * @param ids IDs a serem removidos (em qualquer ordem, repetições são ignoradas)
+ * @param n Número de IDs
+ * @return Número de chaves removidas
+ */
+int btree_session_remove_many(SessaoArvoreB *sessao, const int ids[], int n);
+
+/**
+ * @brief Busca uma chave usando a sessão, consultando antes o filtro de Bloom
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long btree_session_search(SessaoArvoreB *sessao, int id);
+
+/**
+ * @brief Byte offset da chave mais próxima de um ID (o próprio ID, se presente)
+ * @param sessao Sessão aberta
+ * @param id ID de referência
+ * @return Byte offset da chave vizinha ou -1 se a árvore estiver vazia
+ */
+long long btree_session_search_neighbor(SessaoArvoreB *sessao, int id);
+
+/**
+ * @brief Grava o cabeçalho como consistente e fecha a sessão
+ * @param sessao Sessão aberta (liberada por esta função)
+ */
+void btree_close(SessaoArvoreB *sessao);
+
 // ================= FUNÇÕES DE I/O BÁSICAS =================
 
 /**
@@ -167,6 +350,29 @@ void escreverPaginaArvoreB(FILE *fp, int rrn, PaginaArvoreB *pag);
  */
 void lerPaginaArvoreB(FILE *fp, int rrn, PaginaArvoreB *pag);
 
+/**
+ * @brief Obtém um RRN para uma nova página
+ *
+ * Reaproveita a primeira página da lista de livres; se a lista estiver
+ * vazia, usa proxRRN. Altera apenas o cabeçalho em memória.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @return RRN da página alocada
+ */
+int alocarPaginaArvoreB(FILE *fp, CabecalhoArvoreB *cab);
+
+/**
+ * @brief Transforma uma página em memória em página livre e a empilha na lista
+ *
+ * Quem chama é responsável por gravar a página no RRN informado.
+ *
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param pag Página a ser liberada
+ * @param rrn RRN da página
+ */
+void liberarPaginaArvoreB(CabecalhoArvoreB *cab, PaginaArvoreB *pag, int rrn);
+
 // ================= FUNÇÕES DE INSERÇÃO =================
 
 /**
@@ -178,87 +384,77 @@ void lerPaginaArvoreB(FILE *fp, int rrn, PaginaArvoreB *pag);
 void insereOrdenadoNaPagina(PaginaArvoreB *pag, int id, long long pr);
 
 /**
- * @brief Função recursiva para inserção na árvore-B
+ * @brief Insere uma chave usando um cabeçalho já carregado em memória
+ *
+ * Não lê nem grava o cabeçalho; quem chama é responsável por persisti-lo.
+ *
  * @param fp Ponteiro para o arquivo
- * @param cab Ponteiro para o cabeçalho
- * @param rrnAtual RRN do nó atual
+ * @param cab Ponteiro para o cabeçalho em memória
  * @param id ID do registro a ser inserido
  * @param pr Byte offset do registro
- * @return Resultado da operação de split
  */
-ResultadoSplit inserirRecursivo(FILE *fp, CabecalhoArvoreB *cab, int rrnAtual, int id, long long pr);
+void inserirComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int id, long long pr);
 
+/**
+ * @brief Busca uma chave a partir de um cabeçalho em memória
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param id ID do registro a ser buscado
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long buscarComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int id);
 
+/**
+ * @brief Atualiza o byte offset de uma chave a partir de um cabeçalho em memória
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int atualizarOffsetComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int id, long long newOffset);
 
 
 
 
 
 
-// ================= FUNÇÕES DE REMOÇÃO =================
 
-/**
- * @brief Função principal para remoção recursiva
- * @param fp Ponteiro para o arquivo
- * @param cab Ponteiro para o cabeçalho
- * @param rrnNo RRN do nó atual
- * @param chave Chave a ser removida
- */
-void remover(FILE *fp, CabecalhoArvoreB *cab, int rrnNo, int chave);
 
-/**
- * @brief Remove sucessora simples (em nó folha)
- * @param fp Ponteiro para o arquivo
- * @param rrnNo RRN do nó
- * @param chave Chave a ser removida
- */
-void removerSucessoraSimples(FILE *fp, int rrnNo, int chave);
+// ================= FUNÇÕES DE REMOÇÃO =================
 
 /**
- * @brief Remove predecessora simples (em nó folha)
+ * @brief Remove uma chave usando um cabeçalho já carregado em memória
+ *
+ * Não lê nem grava o cabeçalho; quem chama é responsável por persisti-lo.
+ *
  * @param fp Ponteiro para o arquivo
- * @param rrnNo RRN do nó
+ * @param cab Ponteiro para o cabeçalho em memória
  * @param chave Chave a ser removida
+ * @return 1 se removida, 0 se não encontrada
  */
-void removerPredecessoraSimples(FILE *fp, int rrnNo, int chave);
-
-/**
- * @brief Trata underflow em um filho
- * @param fp Ponteiro para o arquivo
- * @param cab Ponteiro para o cabeçalho
- * @param paiRRN RRN do nó pai
- * @param indiceFilho Índice do filho com underflow
- */
-void tratarUnderflow(FILE *fp, CabecalhoArvoreB *cab, int paiRRN, int indiceFilho);
-
-/**
- * @brief Verifica se um nó tem underflow
- * @param fp Ponteiro para o arquivo
- * @param rrn RRN do nó
- * @param rrnRaiz RRN da raiz
- * @return 1 se tem underflow, 0 caso contrário
- */
-int verificarUnderflow(FILE *fp, int rrn, int rrnRaiz);
+int removerComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int chave);
 
 /**
- * @brief Encontra a chave sucessora
+ * @brief Remove um conjunto ordenado de chaves usando um cabeçalho em memória
  * @param fp Ponteiro para o arquivo
- * @param rrn RRN do nó
- * @param chaveSuccessora Ponteiro para armazenar a chave sucessora
- * @param prSuccessor Ponteiro para armazenar o PR sucessor
- * @return RRN do nó onde está a sucessora
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param ids Chaves a remover, em ordem crescente e sem repetição
+ * @param k Número de chaves
+ * @param removidas Recebe as chaves que estavam na árvore (NULL se não interessarem)
+ * @return Número de chaves removidas, ou -1 se faltar memória
  */
-int encontrarSucessora(FILE *fp, int rrn, int *chaveSuccessora, long long *prSuccessor);
+int removerVariasComCabecalho(FILE *fp, CabecalhoArvoreB *cab, const int ids[], int k, int removidas[]);
 
 /**
- * @brief Encontra a chave predecessora
+ * @brief Remove as chaves de [lo, hi] usando um cabeçalho em memória
  * @param fp Ponteiro para o arquivo
- * @param rrn RRN do nó
- * @param chavePred Ponteiro para armazenar a chave predecessora
- * @param prPred Ponteiro para armazenar o PR predecessor
- * @return RRN do nó onde está a predecessora
+ * @param cab Ponteiro para o cabeçalho em memória
+ * @param lo Menor chave do intervalo
+ * @param hi Maior chave do intervalo
+ * @return Número de chaves removidas
  */
-int encontrarPredecessor(FILE *fp, int rrn, int *chavePred, long long *prPred);
+int removerIntervaloComCabecalho(FILE *fp, CabecalhoArvoreB *cab, int lo, int hi);
 
 /**
  * @brief Busca o índice de uma chave em uma página
@@ -269,43 +465,38 @@ int encontrarPredecessor(FILE *fp, int rrn, int *chavePred, long long *prPred);
 int buscarIndiceChave(PaginaArvoreB *pag, int chave);
 
 /**
- * @brief Remove chave de nó folha
- * @param fp Ponteiro para o arquivo
- * @param rrnNo RRN do nó
+ * @brief Remove a chave de índice idx de uma página em memória
+ * @param pag Ponteiro para a página
  * @param idx Índice da chave a ser removida
  */
-void removerDeFolha(FILE *fp, int rrnNo, int idx);
+void removerDaPagina(PaginaArvoreB *pag, int idx);
 
 /**
- * @brief Toma uma chave do irmão anterior
- * @param fp Ponteiro para o arquivo
- * @param paiRRN RRN do nó pai
- * @param idx Índice do filho
+ * @brief Toma uma chave do irmão anterior (páginas em memória)
+ * @param pai Página pai
+ * @param idx Índice do filho com underflow
+ * @param filho Página do filho com underflow
+ * @param irmao Página do irmão anterior
  */
-void tomarDoAnterior(FILE *fp, int paiRRN, int idx);
+void tomarDoAnterior(PaginaArvoreB *pai, int idx, PaginaArvoreB *filho, PaginaArvoreB *irmao);
 
 /**
- * @brief Toma uma chave do próximo irmão
- * @param fp Ponteiro para o arquivo
- * @param paiRRN RRN do nó pai
- * @param idx Índice do filho
+ * @brief Toma uma chave do próximo irmão (páginas em memória)
+ * @param pai Página pai
+ * @param idx Índice do filho com underflow
+ * @param filho Página do filho com underflow
+ * @param irmao Página do próximo irmão
  */
-void tomarDoProximo(FILE *fp, int paiRRN, int idx);
+void tomarDoProximo(PaginaArvoreB *pai, int idx, PaginaArvoreB *filho, PaginaArvoreB *irmao);
 
 /**
- * @brief Funde dois nós irmãos
- * @param fp Ponteiro para o arquivo
+ * @brief Funde o filho idx + 1 no filho idx (páginas em memória)
  * @param cab Ponteiro para o cabeçalho
- * @param paiRRN RRN do nó pai
+ * @param pai Página pai
  * @param idx Índice do primeiro filho a ser fundido
+ * @param esq Página do filho idx (recebe as chaves)
+ * @param dir Página do filho idx + 1 (absorvida)
  */
-void fundir(FILE *fp, CabecalhoArvoreB *cab, int paiRRN, int idx);
+void fundir(CabecalhoArvoreB *cab, PaginaArvoreB *pai, int idx, PaginaArvoreB *esq, PaginaArvoreB *dir);
 
-/**
- * @brief Remove chave de nó interno
- * @param fp Ponteiro para o arquivo
- * @param cab Ponteiro para o cabeçalho
- * @param rrnNo RRN do nó
- * @param idx Índice da chave a ser removida
- */
-void removerDeInterno(FILE *fp, CabecalhoArvoreB *cab, int rrnNo, int idx);
+#endif // ARVORE_B_H
@@ -0,0 +1,675 @@
+/**
+ * @file arvore-bmais.c
+ * @brief Implementação da árvore-B+ com folhas encadeadas
+ *
+ * Este arquivo contém a construção, inserção, busca e percurso em ordem
+ * da árvore-B+. Todos os pares (chave, byte offset) ficam nas folhas, que
+ * formam uma lista duplamente encadeada; buscas por intervalo e percursos
+ * completos do índice são caminhadas sequenciais pelas folhas.
+ */
+
+#include "arvore-bmais.h"
+#include "record.h"
+#include "wal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define INVALIDO -1
+
+
+/**
+ * @brief Inicializa o cabeçalho da árvore-B+
+ *
+ * Escreve o cabeçalho inicial com status inconsistente e árvore vazia.
+ *
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ */
+void inicializaCabecalhoArvoreBMais(FILE *fp) {
+    if (!fp) return;
+
+    CabecalhoArvoreBMais cab;
+    cab.status = '0';
+    cab.noRaiz = -1;
+    cab.proxRRN = 0;
+    cab.nroNos = 0;
+    cab.primeiraFolha = -1;
+    memset(cab.lixo, '$', sizeof(cab.lixo));
+
+    escreverCabecalhoArvoreBMais(fp, &cab);
+}
+
+/**
+ * @brief Inicializa uma página da árvore-B+
+ *
+ * Limpa chaves, byte offsets, ponteiros e o encadeamento de folhas.
+ *
+ * @param pag Ponteiro para a página a ser inicializada
+ * @param tipoNo Tipo do nó (-1: folha, 1: interno)
+ */
+void inicializaPaginaBMais(PaginaArvoreBMais *pag, int tipoNo) {
+    pag->tipoNo = tipoNo;
+    pag->nroChaves = 0;
+    pag->anterior = INVALIDO;
+    pag->proximo = INVALIDO;
+
+    for (int i = 0; i < MAX_CHAVES_INTERNO_BMAIS; i++) {
+        pag->chaves[i] = -1;
+    }
+    for (int i = 0; i < MAX_CHAVES_FOLHA_BMAIS; i++) {
+        pag->pr[i] = -1;
+    }
+    for (int i = 0; i < MAX_PONTEIROS_BMAIS; i++) {
+        pag->ponteiros[i] = INVALIDO;
+    }
+}
+
+/**
+ * @brief Escreve o cabeçalho da árvore-B+ no arquivo
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para a estrutura do cabeçalho
+ */
+void escreverCabecalhoArvoreBMais(FILE *fp, CabecalhoArvoreBMais *cab) {
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&cab->status, sizeof(char), 1, fp);
+    fwrite(&cab->noRaiz, sizeof(int), 1, fp);
+    fwrite(&cab->proxRRN, sizeof(int), 1, fp);
+    fwrite(&cab->nroNos, sizeof(int), 1, fp);
+    fwrite(&cab->primeiraFolha, sizeof(int), 1, fp);
+    fwrite(&cab->lixo, sizeof(char), sizeof(cab->lixo), fp);
+    fflush(fp);
+}
+
+/**
+ * @brief Lê o cabeçalho da árvore-B+ do arquivo
+ *
+ * Em caso de erro na leitura, inicializa com os valores de árvore vazia.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para a estrutura do cabeçalho
+ */
+void lerCabecalhoArvoreBMais(FILE *fp, CabecalhoArvoreBMais *cab) {
+    if (!fp || !cab) return;
+
+    if (fseek(fp, 0, SEEK_SET) != 0 ||
+        fread(&cab->status, sizeof(char), 1, fp) != 1 ||
+        fread(&cab->noRaiz, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->proxRRN, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->nroNos, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->primeiraFolha, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->lixo, sizeof(char), sizeof(cab->lixo), fp) != sizeof(cab->lixo)) {
+        cab->status = '0';
+        cab->noRaiz = -1;
+        cab->proxRRN = 0;
+        cab->nroNos = 0;
+        cab->primeiraFolha = -1;
+        memset(cab->lixo, '$', sizeof(cab->lixo));
+    }
+}
+
+/**
+ * @brief Escreve uma página da árvore-B+ no arquivo
+ *
+ * Folha: TipoNo, nroChaves, anterior, proximo, C1, PR1, C2, PR2, lixo(4).
+ * Interno: TipoNo, nroChaves, P1, C1, P2, C2, P3, C3, P4, C4, P5.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param rrn RRN da página (posição relativa)
+ * @param pag Ponteiro para a página a ser escrita
+ */
+void escreverPaginaArvoreBMais(FILE *fp, int rrn, PaginaArvoreBMais *pag) {
+    if (!fp || !pag || rrn < 0) return;
+
+    long long offset = TAM_PAGINA_BMAIS + (long long)rrn * TAM_PAGINA_BMAIS;
+    if (fseek(fp, offset, SEEK_SET) != 0) return;
+
+    fwrite(&pag->tipoNo, sizeof(int), 1, fp);
+    fwrite(&pag->nroChaves, sizeof(int), 1, fp);
+
+    if (pag->tipoNo == FOLHA_BMAIS) {
+        fwrite(&pag->anterior, sizeof(int), 1, fp);
+        fwrite(&pag->proximo, sizeof(int), 1, fp);
+        for (int i = 0; i < MAX_CHAVES_FOLHA_BMAIS; i++) {
+            fwrite(&pag->chaves[i], sizeof(int), 1, fp);
+            fwrite(&pag->pr[i], sizeof(long long), 1, fp);
+        }
+        fwrite("$$$$", sizeof(char), 4, fp);
+    } else {
+        fwrite(&pag->ponteiros[0], sizeof(int), 1, fp);
+        for (int i = 0; i < MAX_CHAVES_INTERNO_BMAIS; i++) {
+            fwrite(&pag->chaves[i], sizeof(int), 1, fp);
+            fwrite(&pag->ponteiros[i + 1], sizeof(int), 1, fp);
+        }
+    }
+
+    fflush(fp);
+}
+
+/**
+ * @brief Lê uma página da árvore-B+ do arquivo
+ *
+ * Em caso de erro, inicializa a página como folha vazia.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param rrn RRN da página a ser lida
+ * @param pag Ponteiro para a página onde os dados serão carregados
+ */
+void lerPaginaArvoreBMais(FILE *fp, int rrn, PaginaArvoreBMais *pag) {
+    inicializaPaginaBMais(pag, FOLHA_BMAIS);
+    if (!fp || rrn < 0) return;
+
+    long long offset = TAM_PAGINA_BMAIS + (long long)rrn * TAM_PAGINA_BMAIS;
+    if (fseek(fp, offset, SEEK_SET) != 0) return;
+
+    if (fread(&pag->tipoNo, sizeof(int), 1, fp) != 1 ||
+        fread(&pag->nroChaves, sizeof(int), 1, fp) != 1) {
+        inicializaPaginaBMais(pag, FOLHA_BMAIS);
+        return;
+    }
+
+    int ok = 1;
+    if (pag->tipoNo == FOLHA_BMAIS) {
+        ok = fread(&pag->anterior, sizeof(int), 1, fp) == 1 &&
+             fread(&pag->proximo, sizeof(int), 1, fp) == 1;
+        for (int i = 0; ok && i < MAX_CHAVES_FOLHA_BMAIS; i++) {
+            ok = fread(&pag->chaves[i], sizeof(int), 1, fp) == 1 &&
+                 fread(&pag->pr[i], sizeof(long long), 1, fp) == 1;
+        }
+    } else {
+        ok = fread(&pag->ponteiros[0], sizeof(int), 1, fp) == 1;
+        for (int i = 0; ok && i < MAX_CHAVES_INTERNO_BMAIS; i++) {
+            ok = fread(&pag->chaves[i], sizeof(int), 1, fp) == 1 &&
+                 fread(&pag->ponteiros[i + 1], sizeof(int), 1, fp) == 1;
+        }
+    }
+
+    if (!ok) {
+        inicializaPaginaBMais(pag, FOLHA_BMAIS);
+    }
+}
+
+
+/**
+ * @brief Índice do filho a seguir em um nó interno
+ *
+ * Cada separador é a menor chave da subárvore à sua direita, então o
+ * filho escolhido é o número de separadores menores ou iguais a id.
+ */
+static int indiceFilhoBMais(PaginaArvoreBMais *pag, int id) {
+    int i = 0;
+    while (i < pag->nroChaves && pag->chaves[i] <= id) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Desce da raiz até a folha que deveria conter id
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ * @param id Chave procurada
+ * @param folha Página onde a folha encontrada será carregada
+ * @return RRN da folha ou -1 se a árvore estiver vazia
+ */
+static int descerAteFolhaBMais(FILE *fp, CabecalhoArvoreBMais *cab, int id, PaginaArvoreBMais *folha) {
+    int rrn = cab->noRaiz;
+    if (rrn == INVALIDO) return INVALIDO;
+
+    for (int nivel = 0; nivel < ALTURA_MAX_BMAIS; nivel++) {
+        lerPaginaArvoreBMais(fp, rrn, folha);
+        if (folha->tipoNo == FOLHA_BMAIS) {
+            return rrn;
+        }
+        rrn = folha->ponteiros[indiceFilhoBMais(folha, id)];
+        if (rrn == INVALIDO) return INVALIDO;
+    }
+    return INVALIDO;
+}
+
+
+/**
+ * @brief Insere uma chave na árvore-B+
+ *
+ * A descida guarda as páginas visitadas em uma pilha explícita. Se a folha
+ * estiver cheia ela é dividida, a menor chave da nova folha sobe como
+ * separador e as divisões seguintes são resolvidas subindo pela pilha,
+ * sem reler nenhuma página.
+ *
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ */
+void bplus_insert(FILE *fp, int id, long long byteOffset) {
+    CabecalhoArvoreBMais cab;
+    lerCabecalhoArvoreBMais(fp, &cab);
+
+    if (cab.noRaiz == INVALIDO) {
+        // Primeira inserção - a raiz é uma folha
+        PaginaArvoreBMais folha;
+        inicializaPaginaBMais(&folha, FOLHA_BMAIS);
+        folha.chaves[0] = id;
+        folha.pr[0] = byteOffset;
+        folha.nroChaves = 1;
+        escreverPaginaArvoreBMais(fp, cab.proxRRN, &folha);
+        cab.noRaiz = cab.proxRRN;
+        cab.primeiraFolha = cab.proxRRN;
+        cab.proxRRN++;
+        cab.nroNos++;
+        escreverCabecalhoArvoreBMais(fp, &cab);
+        return;
+    }
+
+    PaginaArvoreBMais caminho[ALTURA_MAX_BMAIS];
+    int rrns[ALTURA_MAX_BMAIS];
+    int nivel = 0;
+
+    // Descida registrando o caminho
+    rrns[0] = cab.noRaiz;
+    while (1) {
+        lerPaginaArvoreBMais(fp, rrns[nivel], &caminho[nivel]);
+        if (caminho[nivel].tipoNo == FOLHA_BMAIS) break;
+        if (nivel + 1 >= ALTURA_MAX_BMAIS) return;
+        int filho = caminho[nivel].ponteiros[indiceFilhoBMais(&caminho[nivel], id)];
+        if (filho == INVALIDO) return; // Erro - ponteiro inválido
+        rrns[++nivel] = filho;
+    }
+
+    PaginaArvoreBMais *folha = &caminho[nivel];
+    int rrnFolha = rrns[nivel];
+
+    if (folha->nroChaves < MAX_CHAVES_FOLHA_BMAIS) {
+        // Tem espaço, insere diretamente
+        int i;
+        for (i = folha->nroChaves - 1; i >= 0 && folha->chaves[i] > id; i--) {
+            folha->chaves[i + 1] = folha->chaves[i];
+            folha->pr[i + 1] = folha->pr[i];
+        }
+        folha->chaves[i + 1] = id;
+        folha->pr[i + 1] = byteOffset;
+        folha->nroChaves++;
+        escreverPaginaArvoreBMais(fp, rrnFolha, folha);
+        escreverCabecalhoArvoreBMais(fp, &cab);
+        return;
+    }
+
+    // Folha cheia: divide mantendo a folha da esquerda completa
+    int tempChaves[MAX_CHAVES_FOLHA_BMAIS + 1];
+    long long tempPr[MAX_CHAVES_FOLHA_BMAIS + 1];
+    int pos = 0, j = 0;
+    while (j < folha->nroChaves && folha->chaves[j] < id) {
+        tempChaves[pos] = folha->chaves[j];
+        tempPr[pos++] = folha->pr[j++];
+    }
+    tempChaves[pos] = id;
+    tempPr[pos++] = byteOffset;
+    while (j < folha->nroChaves) {
+        tempChaves[pos] = folha->chaves[j];
+        tempPr[pos++] = folha->pr[j++];
+    }
+
+    int total = MAX_CHAVES_FOLHA_BMAIS + 1;
+    int naEsquerda = (total + 1) / 2;
+
+    PaginaArvoreBMais novaFolha;
+    inicializaPaginaBMais(&novaFolha, FOLHA_BMAIS);
+    int rrnNovaFolha = cab.proxRRN++;
+    cab.nroNos++;
+
+    int anteriorAntigo = folha->anterior;
+    int proximoAntigo = folha->proximo;
+    inicializaPaginaBMais(folha, FOLHA_BMAIS);
+    for (int i = 0; i < naEsquerda; i++) {
+        folha->chaves[i] = tempChaves[i];
+        folha->pr[i] = tempPr[i];
+    }
+    folha->nroChaves = naEsquerda;
+    for (int i = naEsquerda; i < total; i++) {
+        novaFolha.chaves[i - naEsquerda] = tempChaves[i];
+        novaFolha.pr[i - naEsquerda] = tempPr[i];
+    }
+    novaFolha.nroChaves = total - naEsquerda;
+
+    // Reencadeia: folha <-> novaFolha <-> antigo próximo
+    folha->anterior = anteriorAntigo;
+    folha->proximo = rrnNovaFolha;
+    novaFolha.anterior = rrnFolha;
+    novaFolha.proximo = proximoAntigo;
+    if (proximoAntigo != INVALIDO) {
+        PaginaArvoreBMais vizinha;
+        lerPaginaArvoreBMais(fp, proximoAntigo, &vizinha);
+        vizinha.anterior = rrnNovaFolha;
+        escreverPaginaArvoreBMais(fp, proximoAntigo, &vizinha);
+    }
+
+    escreverPaginaArvoreBMais(fp, rrnFolha, folha);
+    escreverPaginaArvoreBMais(fp, rrnNovaFolha, &novaFolha);
+
+    int chavePromovida = novaFolha.chaves[0];
+    int ponteiroDir = rrnNovaFolha;
+
+    // Propaga o separador subindo pela pilha
+    for (nivel = nivel - 1; nivel >= 0; nivel--) {
+        PaginaArvoreBMais *pag = &caminho[nivel];
+
+        int idx = indiceFilhoBMais(pag, chavePromovida);
+
+        if (pag->nroChaves < MAX_CHAVES_INTERNO_BMAIS) {
+            for (int i = pag->nroChaves; i > idx; i--) {
+                pag->chaves[i] = pag->chaves[i - 1];
+                pag->ponteiros[i + 1] = pag->ponteiros[i];
+            }
+            pag->chaves[idx] = chavePromovida;
+            pag->ponteiros[idx + 1] = ponteiroDir;
+            pag->nroChaves++;
+            escreverPaginaArvoreBMais(fp, rrns[nivel], pag);
+            escreverCabecalhoArvoreBMais(fp, &cab);
+            return;
+        }
+
+        // Nó interno cheio: divide e promove o separador do meio
+        int tChaves[MAX_CHAVES_INTERNO_BMAIS + 1];
+        int tPonteiros[MAX_PONTEIROS_BMAIS + 1];
+        for (int i = 0, k = 0; i <= MAX_CHAVES_INTERNO_BMAIS; i++) {
+            if (i == idx) {
+                tChaves[i] = chavePromovida;
+            } else {
+                tChaves[i] = pag->chaves[k++];
+            }
+        }
+        for (int i = 0, k = 0; i <= MAX_PONTEIROS_BMAIS; i++) {
+            if (i == idx + 1) {
+                tPonteiros[i] = ponteiroDir;
+            } else {
+                tPonteiros[i] = pag->ponteiros[k++];
+            }
+        }
+
+        int meio = (MAX_CHAVES_INTERNO_BMAIS + 1) / 2;
+
+        PaginaArvoreBMais novoInterno;
+        inicializaPaginaBMais(&novoInterno, INTERNO_BMAIS);
+        int rrnNovo = cab.proxRRN++;
+        cab.nroNos++;
+
+        inicializaPaginaBMais(pag, INTERNO_BMAIS);
+        for (int i = 0; i < meio; i++) {
+            pag->chaves[i] = tChaves[i];
+            pag->ponteiros[i] = tPonteiros[i];
+        }
+        pag->ponteiros[meio] = tPonteiros[meio];
+        pag->nroChaves = meio;
+
+        for (int i = meio + 1; i <= MAX_CHAVES_INTERNO_BMAIS; i++) {
+            novoInterno.chaves[i - meio - 1] = tChaves[i];
+            novoInterno.ponteiros[i - meio - 1] = tPonteiros[i];
+        }
+        novoInterno.ponteiros[MAX_CHAVES_INTERNO_BMAIS - meio] = tPonteiros[MAX_PONTEIROS_BMAIS];
+        novoInterno.nroChaves = MAX_CHAVES_INTERNO_BMAIS - meio;
+
+        escreverPaginaArvoreBMais(fp, rrns[nivel], pag);
+        escreverPaginaArvoreBMais(fp, rrnNovo, &novoInterno);
+
+        chavePromovida = tChaves[meio];
+        ponteiroDir = rrnNovo;
+    }
+
+    // A raiz foi dividida: cria uma nova raiz interna
+    PaginaArvoreBMais novaRaiz;
+    inicializaPaginaBMais(&novaRaiz, INTERNO_BMAIS);
+    novaRaiz.chaves[0] = chavePromovida;
+    novaRaiz.ponteiros[0] = cab.noRaiz;
+    novaRaiz.ponteiros[1] = ponteiroDir;
+    novaRaiz.nroChaves = 1;
+
+    escreverPaginaArvoreBMais(fp, cab.proxRRN, &novaRaiz);
+    cab.noRaiz = cab.proxRRN;
+    cab.proxRRN++;
+    cab.nroNos++;
+
+    escreverCabecalhoArvoreBMais(fp, &cab);
+}
+
+
+/**
+ * @brief Busca uma chave na árvore-B+
+ *
+ * Os nós internos só direcionam a descida; a chave é sempre procurada na folha.
+ *
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param id ID do registro a ser buscado
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long bplus_search(FILE *fp, int id) {
+    CabecalhoArvoreBMais cab;
+    lerCabecalhoArvoreBMais(fp, &cab);
+
+    if (cab.status != '1') return -1;
+
+    PaginaArvoreBMais folha;
+    if (descerAteFolhaBMais(fp, &cab, id, &folha) == INVALIDO) return -1;
+
+    for (int i = 0; i < folha.nroChaves; i++) {
+        if (folha.chaves[i] == id) {
+            return folha.pr[i];
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Atualiza o byte offset de uma chave existente na árvore-B+
+ *
+ * Apenas a folha que contém a chave é regravada.
+ *
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param id ID do registro cuja chave será atualizada
+ * @param newOffset Novo byte offset do registro
+ * @return 1 se atualizado com sucesso, 0 se não encontrado
+ */
+int bplus_update_offset(FILE *fp, int id, long long newOffset) {
+    CabecalhoArvoreBMais cab;
+    lerCabecalhoArvoreBMais(fp, &cab);
+
+    if (cab.status != '1') return 0;
+
+    PaginaArvoreBMais folha;
+    int rrn = descerAteFolhaBMais(fp, &cab, id, &folha);
+    if (rrn == INVALIDO) return 0;
+
+    for (int i = 0; i < folha.nroChaves; i++) {
+        if (folha.chaves[i] == id) {
+            folha.pr[i] = newOffset;
+            escreverPaginaArvoreBMais(fp, rrn, &folha);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Posiciona o cursor na primeira chave maior ou igual a lo
+ *
+ * Faz uma única descida da raiz; o restante do percurso segue apenas
+ * o encadeamento das folhas.
+ *
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param lo Chave inicial do percurso
+ * @param cursor Cursor a ser inicializado
+ * @return 1 se há chaves a percorrer, 0 caso contrário
+ */
+int bplus_cursor_inicio(FILE *fp, int lo, CursorArvoreBMais *cursor) {
+    CabecalhoArvoreBMais cab;
+    lerCabecalhoArvoreBMais(fp, &cab);
+
+    cursor->fp = fp;
+    cursor->pos = 0;
+    cursor->rrnFolha = INVALIDO;
+
+    if (cab.status != '1') return 0;
+
+    cursor->rrnFolha = descerAteFolhaBMais(fp, &cab, lo, &cursor->folha);
+    if (cursor->rrnFolha == INVALIDO) return 0;
+
+    while (cursor->pos < cursor->folha.nroChaves && cursor->folha.chaves[cursor->pos] < lo) {
+        cursor->pos++;
+    }
+    return 1;
+}
+
+/**
+ * @brief Avança o cursor para o próximo par (chave, byte offset)
+ *
+ * Ao esgotar a folha atual, carrega a próxima pelo encadeamento.
+ *
+ * @param cursor Cursor inicializado por bplus_cursor_inicio
+ * @param id Ponteiro para armazenar a chave
+ * @param pr Ponteiro para armazenar o byte offset
+ * @return 1 se um par foi lido, 0 ao final das folhas
+ */
+int bplus_cursor_proximo(CursorArvoreBMais *cursor, int *id, long long *pr) {
+    while (cursor->rrnFolha != INVALIDO && cursor->pos >= cursor->folha.nroChaves) {
+        cursor->rrnFolha = cursor->folha.proximo;
+        cursor->pos = 0;
+        if (cursor->rrnFolha != INVALIDO) {
+            lerPaginaArvoreBMais(cursor->fp, cursor->rrnFolha, &cursor->folha);
+        }
+    }
+
+    if (cursor->rrnFolha == INVALIDO) return 0;
+
+    *id = cursor->folha.chaves[cursor->pos];
+    *pr = cursor->folha.pr[cursor->pos];
+    cursor->pos++;
+    return 1;
+}
+
+
+/**
+ * @brief Constrói uma árvore-B+ a partir de um arquivo de dados
+ *
+ * Lê todos os registros não removidos do arquivo de dados e insere
+ * (id, byte offset) no índice.
+ *
+ * @param dataFilename Nome do arquivo de dados
+ * @param bplusFilename Nome do arquivo de índice a ser criado
+ */
+void buildBPlusTreeFromDataFile(const char *dataFilename, const char *bplusFilename) {
+    FILE *dataFile = wal_fopen(dataFilename, "rb");
+    if (!dataFile) {
+        printf("Falha no processamento do arquivo.\n");
+        return;
+    }
+
+    // Verifica se o arquivo de dados está consistente
+    char status;
+    if (fread(&status, sizeof(char), 1, dataFile) != 1 || status != '1') {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(dataFile);
+        return;
+    }
+
+    FILE *bplusFile = fopen(bplusFilename, "wb+");
+    if (!bplusFile) {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(dataFile);
+        return;
+    }
+
+    inicializaCabecalhoArvoreBMais(bplusFile);
+
+    // Pula o cabeçalho do arquivo de dados (276 bytes)
+    if (fseek(dataFile, 276, SEEK_SET) != 0) {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(dataFile);
+        fclose(bplusFile);
+        return;
+    }
+
+    Record record;
+    while (1) {
+        long long recordOffset = ftell(dataFile);
+
+        if (!readRecord(dataFile, &record)) {
+            break; // Fim do arquivo
+        }
+
+        if (record.removido == '0' && record.id != -1) {
+            bplus_insert(bplusFile, record.id, recordOffset);
+        }
+
+        free(record.country);
+        free(record.attackType);
+        free(record.targetIndustry);
+        free(record.defenseStrategy);
+    }
+
+    // Marca o arquivo como consistente
+    CabecalhoArvoreBMais cab;
+    lerCabecalhoArvoreBMais(bplusFile, &cab);
+    cab.status = '1';
+    escreverCabecalhoArvoreBMais(bplusFile, &cab);
+
+    fclose(dataFile);
+    fclose(bplusFile);
+}
+
+/**
+ * @brief Imprime, em ordem de ID, os registros com ID no intervalo [lo, hi]
+ *
+ * Uma descida encontra a primeira folha do intervalo; depois o percurso
+ * é sequencial pelas folhas encadeadas até ultrapassar hi.
+ *
+ * @param dataFilename Nome do arquivo de dados
+ * @param bplusFilename Nome do arquivo de índice
+ * @param lo Menor ID do intervalo
+ * @param hi Maior ID do intervalo
+ */
+void printRecordsInRangeFromBPlusTree(const char *dataFilename, const char *bplusFilename, int lo, int hi) {
+    FILE *bplusFile = fopen(bplusFilename, "rb");
+    if (!bplusFile) {
+        printf("Falha no processamento do arquivo.\n");
+        return;
+    }
+
+    FILE *dataFile = wal_fopen(dataFilename, "rb");
+    if (!dataFile) {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(bplusFile);
+        return;
+    }
+
+    int found = 0;
+    CursorArvoreBMais cursor;
+    if (bplus_cursor_inicio(bplusFile, lo, &cursor)) {
+        int id;
+        long long offset;
+        while (bplus_cursor_proximo(&cursor, &id, &offset) && id <= hi) {
+            fseek(dataFile, offset, SEEK_SET);
+
+            Record record;
+            if (readRecord(dataFile, &record)) {
+                if (record.removido == '0') {
+                    printRecord(record);
+                    found = 1;
+                }
+                free(record.country);
+                free(record.attackType);
+                free(record.targetIndustry);
+                free(record.defenseStrategy);
+            }
+        }
+    }
+
+    if (found == 1) {
+        printf("**********\n");
+    } else {
+        printf("Registro inexistente.\n\n**********\n");
+    }
+
+    fclose(dataFile);
+    fclose(bplusFile);
+}
@@ -0,0 +1,172 @@
+/**
+ * @file arvore-bmais.h
+ * @brief Cabeçalho para implementação de Árvore-B+ com folhas encadeadas
+ *
+ * Variante do índice em que todos os pares (chave, byte offset) ficam nas
+ * folhas, encadeadas por RRN anterior/próximo, e os nós internos guardam
+ * apenas separadores. As páginas têm os mesmos 44 bytes da árvore-B, o que
+ * permite 4 separadores (5 filhos) por nó interno.
+ */
+
+#ifndef ARVORE_BMAIS_H
+#define ARVORE_BMAIS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define TAM_PAGINA_BMAIS 44
+#define MAX_CHAVES_FOLHA_BMAIS 2
+#define MAX_CHAVES_INTERNO_BMAIS 4
+#define MAX_PONTEIROS_BMAIS (MAX_CHAVES_INTERNO_BMAIS + 1)
+#define ALTURA_MAX_BMAIS 32
+
+#define FOLHA_BMAIS -1
+#define INTERNO_BMAIS 1
+
+/**
+ * @brief Estrutura do cabeçalho da árvore-B+
+ */
+typedef struct {
+    char status;        // Status do arquivo ('0' inconsistente, '1' consistente)
+    int noRaiz;         // RRN do nó raiz (-1 se árvore vazia)
+    int proxRRN;        // Próximo RRN disponível
+    int nroNos;         // Número total de nós na árvore
+    int primeiraFolha;  // RRN da folha mais à esquerda (-1 se árvore vazia)
+    char lixo[27];      // Preenchimento para completar 44 bytes
+} CabecalhoArvoreBMais;
+
+/**
+ * @brief Estrutura de uma página (nó) da árvore-B+
+ *
+ * Folhas usam anterior/proximo, chaves[0..1] e pr[0..1].
+ * Nós internos usam chaves[0..3] como separadores e ponteiros[0..4].
+ */
+typedef struct {
+    int tipoNo;                              // -1 (folha), 1 (interno)
+    int nroChaves;                           // Número de chaves presentes no nó
+    int anterior;                            // RRN da folha anterior (-1 se não houver)
+    int proximo;                             // RRN da próxima folha (-1 se não houver)
+    int chaves[MAX_CHAVES_INTERNO_BMAIS];    // Chaves (folha) ou separadores (interno)
+    long long pr[MAX_CHAVES_FOLHA_BMAIS];    // Byte offsets dos registros (folha)
+    int ponteiros[MAX_PONTEIROS_BMAIS];      // RRN dos filhos (interno)
+} PaginaArvoreBMais;
+
+/**
+ * @brief Cursor para percorrer as folhas em ordem de chave
+ */
+typedef struct {
+    FILE *fp;                 // Arquivo da árvore-B+
+    PaginaArvoreBMais folha;  // Folha atual em memória
+    int rrnFolha;             // RRN da folha atual (-1 ao final)
+    int pos;                  // Próxima posição a ser lida na folha
+} CursorArvoreBMais;
+
+// ================= FUNÇÕES PRINCIPAIS =================
+
+/**
+ * @brief Constrói uma árvore-B+ a partir de um arquivo de dados
+ * @param dataFilename Nome do arquivo de dados
+ * @param bplusFilename Nome do arquivo de índice a ser criado
+ */
+void buildBPlusTreeFromDataFile(const char *dataFilename, const char *bplusFilename);
+
+/**
+ * @brief Imprime, em ordem de ID, os registros com ID no intervalo [lo, hi]
+ * @param dataFilename Nome do arquivo de dados
+ * @param bplusFilename Nome do arquivo de índice
+ * @param lo Menor ID do intervalo
+ * @param hi Maior ID do intervalo
+ */
+void printRecordsInRangeFromBPlusTree(const char *dataFilename, const char *bplusFilename, int lo, int hi);
+
+/**
+ * @brief Insere uma chave na árvore-B+
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ */
+void bplus_insert(FILE *fp, int id, long long byteOffset);
+
+/**
+ * @brief Busca uma chave na árvore-B+
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param id ID do registro a ser buscado
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long bplus_search(FILE *fp, int id);
+
+/**
+ * @brief Atualiza o byte offset de uma chave existente na árvore-B+
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int bplus_update_offset(FILE *fp, int id, long long newOffset);
+
+// ================= PERCURSO EM ORDEM =================
+
+/**
+ * @brief Posiciona o cursor na primeira chave maior ou igual a lo
+ * @param fp Ponteiro para o arquivo da árvore-B+
+ * @param lo Chave inicial do percurso
+ * @param cursor Cursor a ser inicializado
+ * @return 1 se há chaves a percorrer, 0 caso contrário
+ */
+int bplus_cursor_inicio(FILE *fp, int lo, CursorArvoreBMais *cursor);
+
+/**
+ * @brief Avança o cursor para o próximo par (chave, byte offset)
+ * @param cursor Cursor inicializado por bplus_cursor_inicio
+ * @param id Ponteiro para armazenar a chave
+ * @param pr Ponteiro para armazenar o byte offset
+ * @return 1 se um par foi lido, 0 ao final das folhas
+ */
+int bplus_cursor_proximo(CursorArvoreBMais *cursor, int *id, long long *pr);
+
+// ================= FUNÇÕES DE I/O BÁSICAS =================
+
+/**
+ * @brief Inicializa o cabeçalho da árvore-B+ no arquivo
+ * @param fp Ponteiro para o arquivo
+ */
+void inicializaCabecalhoArvoreBMais(FILE *fp);
+
+/**
+ * @brief Inicializa uma página da árvore-B+
+ * @param pag Ponteiro para a página
+ * @param tipoNo Tipo do nó (-1: folha, 1: interno)
+ */
+void inicializaPaginaBMais(PaginaArvoreBMais *pag, int tipoNo);
+
+/**
+ * @brief Escreve o cabeçalho da árvore-B+ no arquivo
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ */
+void escreverCabecalhoArvoreBMais(FILE *fp, CabecalhoArvoreBMais *cab);
+
+/**
+ * @brief Lê o cabeçalho da árvore-B+ do arquivo
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ */
+void lerCabecalhoArvoreBMais(FILE *fp, CabecalhoArvoreBMais *cab);
+
+/**
+ * @brief Escreve uma página da árvore-B+ no arquivo
+ * @param fp Ponteiro para o arquivo
+ * @param rrn RRN da página
+ * @param pag Ponteiro para a página
+ */
+void escreverPaginaArvoreBMais(FILE *fp, int rrn, PaginaArvoreBMais *pag);
+
+/**
+ * @brief Lê uma página da árvore-B+ do arquivo
+ * @param fp Ponteiro para o arquivo
+ * @param rrn RRN da página
+ * @param pag Ponteiro para a página
+ */
+void lerPaginaArvoreBMais(FILE *fp, int rrn, PaginaArvoreBMais *pag);
+
+#endif // ARVORE_BMAIS_H
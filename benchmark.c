@@ -0,0 +1,371 @@
+/**
+ * @file benchmark.c
+ * @brief Reprodução de uma carga de remoções e inserções sob cada política de reaproveitamento
+ *
+ * Uso: ./benchmark <arquivo.bin> [operacoes] [semente]
+ *
+ * Para cada política, copia o arquivo de dados, reproduz a mesma sequência
+ * de operações (a sequência depende apenas da semente, nunca dos offsets
+ * escolhidos) e informa:
+ *  - tamanho final do arquivo;
+ *  - bytes de lixo: '$' no fim de registros ativos e bytes de registros removidos;
+ *  - localidade das escritas: distância média entre inserções consecutivas e
+ *    fração de inserções acrescentadas ao final do arquivo.
+ *
+ * Em seguida, para cada folga de crescimento (setGrowthSlack), insere
+ * registros novos, aumenta campos de texto de registros escolhidos ao acaso
+ * e informa a taxa de realocação das atualizações e o tamanho final.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binary_operations.h"
+#include "espaco-livre.h"
+
+#define OPERACOES_PADRAO 400
+#define SEMENTE_PADRAO 42
+#define TAM_MAX_CAMPO 48
+#define CRESCIMENTO_MAX 8      // Caracteres acrescentados a um campo por atualização
+
+/**
+ * @brief Folga de crescimento avaliada
+ */
+typedef struct {
+    double percentual;
+    int bytes;
+} Folga;
+
+static const Folga folgas[] = {
+    {0.0, 0}, {10.0, 0}, {25.0, 0}, {0.0, 8}, {0.0, 16}
+};
+#define NRO_FOLGAS ((int)(sizeof(folgas) / sizeof(folgas[0])))
+
+/**
+ * @brief Medidas de um arquivo de dados após a reprodução
+ */
+typedef struct {
+    long long tamanhoArquivo;
+    long long lixoAtivos;          // '$' no fim de registros ativos
+    long long bytesRemovidos;      // Registros removidos ainda no arquivo
+    int nroRemovidos;
+    long long distanciaTotal;      // Soma das distâncias entre inserções consecutivas
+    int nroInsercoes;
+    int nroAcrescimos;             // Inserções feitas ao final do arquivo
+} Medidas;
+
+/**
+ * @brief Gerador pseudoaleatório próprio, para a sequência não depender da libc
+ */
+static unsigned int proximoAleatorio(unsigned int *estado) {
+    *estado = *estado * 1103515245u + 12345u;
+    return (*estado >> 16) & 0x7fff;
+}
+
+/**
+ * @brief Copia o arquivo de dados para a área de trabalho da política
+ */
+static int copiarArquivo(const char *origem, const char *destino) {
+    FILE *in = fopen(origem, "rb");
+    if (!in) return 0;
+    FILE *out = fopen(destino, "wb");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+
+    char buffer[8192];
+    size_t lidos;
+    while ((lidos = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        fwrite(buffer, 1, lidos, out);
+    }
+    fclose(in);
+    fclose(out);
+    return 1;
+}
+
+/**
+ * @brief Coleta os IDs dos registros ativos do arquivo
+ */
+static int *coletarIds(const char *binaryFile, int *n, int *maiorId) {
+    FILE *file = fopen(binaryFile, "rb");
+    if (!file) return NULL;
+
+    int capacidade = 1024;
+    int *ids = malloc(capacidade * sizeof(int));
+    *n = 0;
+    *maiorId = 0;
+
+    fseek(file, 276, SEEK_SET);
+    Record record;
+    while (ids && readRecord(file, &record)) {
+        if (record.removido == '0') {
+            if (*n == capacidade) {
+                capacidade *= 2;
+                ids = realloc(ids, capacidade * sizeof(int));
+            }
+            if (ids) ids[(*n)++] = record.id;
+        }
+        if (record.id > *maiorId) *maiorId = record.id;
+        free(record.country);
+        free(record.attackType);
+        free(record.targetIndustry);
+        free(record.defenseStrategy);
+    }
+
+    fclose(file);
+    return ids;
+}
+
+/**
+ * @brief Percorre o arquivo pelos prefixos dos registros, somando lixo e removidos
+ */
+static void medirArquivo(const char *binaryFile, Medidas *m) {
+    FILE *file = fopen(binaryFile, "rb");
+    if (!file) return;
+
+    fseek(file, 0, SEEK_END);
+    m->tamanhoArquivo = ftell(file);
+
+    long long offset = 276;
+    char removido;
+    int tamanho;
+    while (offset < m->tamanhoArquivo) {
+        fseek(file, offset, SEEK_SET);
+        if (fread(&removido, sizeof(char), 1, file) != 1 ||
+            fread(&tamanho, sizeof(int), 1, file) != 1 || tamanho <= 0) {
+            break;
+        }
+
+        if (removido == '1') {
+            m->bytesRemovidos += sizeof(char) + sizeof(int) + tamanho;
+            m->nroRemovidos++;
+        } else {
+            // O preenchimento fica no fim do registro, depois do último '|'
+            char *corpo = malloc(tamanho);
+            if (corpo && fread(corpo, 1, tamanho, file) == (size_t)tamanho) {
+                int i = tamanho - 1;
+                while (i >= 0 && corpo[i] == '$') i--;
+                m->lixoAtivos += tamanho - 1 - i;
+            }
+            free(corpo);
+        }
+        offset += sizeof(char) + sizeof(int) + tamanho;
+    }
+
+    fclose(file);
+}
+
+/**
+ * @brief Preenche um campo com um texto de tamanho aleatório
+ *
+ * Nunca gera NULO: a inserção desconta 2 bytes por campo nulo do
+ * tamanhoRegistro, o que impediria medirArquivo de saltar de registro em
+ * registro pelo tamanho.
+ */
+static const char *campoAleatorio(char *buffer, unsigned int *estado) {
+    int tamanho = 1 + proximoAleatorio(estado) % TAM_MAX_CAMPO;
+    for (int i = 0; i < tamanho; i++) {
+        buffer[i] = 'A' + proximoAleatorio(estado) % 26;
+    }
+    buffer[tamanho] = '\0';
+    return buffer;
+}
+
+/**
+ * @brief Reproduz a carga sobre uma cópia do arquivo com a política indicada
+ */
+static int reproduzir(const char *binaryFile, const char *copia, int politica, int operacoes, unsigned int semente, Medidas *m) {
+    memset(m, 0, sizeof(Medidas));
+    if (!copiarArquivo(binaryFile, copia)) return 0;
+
+    int nroIds, maiorId;
+    int *ids = coletarIds(copia, &nroIds, &maiorId);
+    if (!ids) return 0;
+    int capacidade = nroIds + operacoes;
+    int *vivos = realloc(ids, capacidade * sizeof(int));
+    if (!vivos) {
+        free(ids);
+        return 0;
+    }
+
+    setAllocationPolicy(politica);
+
+    unsigned int estado = semente;
+    long long ultimaEscrita = -1;
+    char criteria[3][256], values[3][256];
+    char country[TAM_MAX_CAMPO + 1], attackType[TAM_MAX_CAMPO + 1];
+    char targetIndustry[TAM_MAX_CAMPO + 1], defenseStrategy[TAM_MAX_CAMPO + 1];
+    strcpy(criteria[0], "idAttack");
+
+    for (int op = 0; op < operacoes; op++) {
+        if (nroIds > 0 && proximoAleatorio(&estado) % 2 == 0) {
+            // Remove um registro ativo qualquer
+            int pos = proximoAleatorio(&estado) % nroIds;
+            snprintf(values[0], sizeof(values[0]), "%d", vivos[pos]);
+            deleteRecordByCriteria(copia, 1, criteria, values, NULL);
+            vivos[pos] = vivos[--nroIds];
+        } else {
+            // Insere um registro com campos de tamanhos variados
+            int id = ++maiorId;
+            const char *c1 = campoAleatorio(country, &estado);
+            const char *c2 = campoAleatorio(attackType, &estado);
+            const char *c3 = campoAleatorio(targetIndustry, &estado);
+            const char *c4 = campoAleatorio(defenseStrategy, &estado);
+
+            FILE *file = fopen(copia, "rb");
+            long long fim = -1;
+            if (file) {
+                fseek(file, 0, SEEK_END);
+                fim = ftell(file);
+                fclose(file);
+            }
+
+            long long offset = insertRecord(copia, id, 2000 + op % 25, 1.5f * op, c1, c2, c3, c4);
+            if (offset < 0) continue;
+
+            if (ultimaEscrita >= 0) {
+                m->distanciaTotal += offset > ultimaEscrita ? offset - ultimaEscrita : ultimaEscrita - offset;
+            }
+            ultimaEscrita = offset;
+            m->nroInsercoes++;
+            if (offset == fim) m->nroAcrescimos++;
+            vivos[nroIds++] = id;
+        }
+    }
+
+    free(vivos);
+    medirArquivo(copia, m);
+    return 1;
+}
+
+/**
+ * @brief Insere registros com a folga indicada e depois aumenta o country de registros ao acaso
+ *
+ * Metade das operações são inserções e metade atualizações, sempre pelo
+ * idAttack; as realocações são contadas por getUpdateStats.
+ */
+static int reproduzirFolga(const char *binaryFile, const char *copia, const Folga *folga, int operacoes, unsigned int semente, Medidas *m, long long *noLugar, long long *realocados) {
+    memset(m, 0, sizeof(Medidas));
+    if (!copiarArquivo(binaryFile, copia)) return 0;
+
+    int nroIds, maiorId;
+    int *ids = coletarIds(copia, &nroIds, &maiorId);
+    if (!ids) return 0;
+    free(ids);
+
+    int nroNovos = operacoes / 2 > 0 ? operacoes / 2 : 1;
+    int *novos = malloc(nroNovos * sizeof(int));
+    char (*paises)[256] = malloc(nroNovos * sizeof(*paises));
+    if (!novos || !paises) {
+        free(novos);
+        free(paises);
+        return 0;
+    }
+
+    setAllocationPolicy(POLITICA_PRIMEIRO);
+    setGrowthSlack(folga->percentual, folga->bytes);
+
+    unsigned int estado = semente;
+    char attackType[TAM_MAX_CAMPO + 1], targetIndustry[TAM_MAX_CAMPO + 1], defenseStrategy[TAM_MAX_CAMPO + 1];
+    int inseridos = 0;
+    for (int i = 0; i < nroNovos; i++) {
+        int id = ++maiorId;
+        campoAleatorio(paises[inseridos], &estado);
+        const char *c2 = campoAleatorio(attackType, &estado);
+        const char *c3 = campoAleatorio(targetIndustry, &estado);
+        const char *c4 = campoAleatorio(defenseStrategy, &estado);
+        if (insertRecord(copia, id, 2000 + i % 25, 1.5f * i, paises[inseridos], c2, c3, c4) >= 0) {
+            novos[inseridos++] = id;
+        }
+    }
+
+    long long noLugarAntes, realocadosAntes;
+    getUpdateStats(&noLugarAntes, &realocadosAntes);
+
+    char criteria[3][256], values[3][256], updateFields[3][256], updateValues[3][256];
+    strcpy(criteria[0], "idAttack");
+    strcpy(updateFields[0], "country");
+    for (int op = 0; inseridos > 0 && op < operacoes - nroNovos; op++) {
+        int pos = proximoAleatorio(&estado) % inseridos;
+        size_t tamanho = strlen(paises[pos]);
+        int crescimento = 1 + proximoAleatorio(&estado) % CRESCIMENTO_MAX;
+        for (int i = 0; i < crescimento && tamanho < sizeof(paises[pos]) - 1; i++) {
+            paises[pos][tamanho++] = 'A' + proximoAleatorio(&estado) % 26;
+        }
+        paises[pos][tamanho] = '\0';
+
+        snprintf(values[0], sizeof(values[0]), "%d", novos[pos]);
+        strcpy(updateValues[0], paises[pos]);
+        updateRecords(copia, 1, 1, criteria, values, 1, updateFields, updateValues, NULL);
+    }
+
+    getUpdateStats(noLugar, realocados);
+    *noLugar -= noLugarAntes;
+    *realocados -= realocadosAntes;
+
+    setGrowthSlack(0.0, 0);
+    free(novos);
+    free(paises);
+    medirArquivo(copia, m);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <arquivo.bin> [operacoes] [semente]\n", argv[0]);
+        return 1;
+    }
+
+    const char *binaryFile = argv[1];
+    int operacoes = argc > 2 ? atoi(argv[2]) : OPERACOES_PADRAO;
+    unsigned int semente = argc > 3 ? (unsigned int)atoi(argv[3]) : SEMENTE_PADRAO;
+
+    char copia[512];
+    snprintf(copia, sizeof(copia), "%s.bench", binaryFile);
+
+    printf("%-16s %12s %12s %12s %10s %14s %10s\n",
+           "politica", "arquivo", "lixo ativos", "removidos", "nro rem.", "dist. media", "ao final");
+
+    for (int politica = 0; politica < NRO_POLITICAS; politica++) {
+        Medidas m;
+        if (!reproduzir(binaryFile, copia, politica, operacoes, semente, &m)) {
+            printf("Falha no processamento do arquivo.\n");
+            remove(copia);
+            return 1;
+        }
+
+        double distanciaMedia = m.nroInsercoes > 1 ? (double)m.distanciaTotal / (m.nroInsercoes - 1) : 0.0;
+        double fracaoFinal = m.nroInsercoes > 0 ? 100.0 * m.nroAcrescimos / m.nroInsercoes : 0.0;
+        printf("%-16s %12lld %12lld %12lld %10d %14.1f %9.1f%%\n",
+               mapa_nome_politica(politica), m.tamanhoArquivo, m.lixoAtivos,
+               m.bytesRemovidos, m.nroRemovidos, distanciaMedia, fracaoFinal);
+    }
+
+    printf("\n%-16s %12s %12s %12s %12s %12s\n",
+           "folga", "arquivo", "lixo ativos", "no lugar", "realocados", "realocacao");
+
+    for (int i = 0; i < NRO_FOLGAS; i++) {
+        Medidas m;
+        long long noLugar, realocados;
+        if (!reproduzirFolga(binaryFile, copia, &folgas[i], operacoes, semente, &m, &noLugar, &realocados)) {
+            printf("Falha no processamento do arquivo.\n");
+            remove(copia);
+            return 1;
+        }
+
+        char nome[32];
+        if (folgas[i].bytes > 0) {
+            snprintf(nome, sizeof(nome), "%d bytes", folgas[i].bytes);
+        } else {
+            snprintf(nome, sizeof(nome), "%.0f%%", folgas[i].percentual);
+        }
+        long long total = noLugar + realocados;
+        double taxa = total > 0 ? 100.0 * realocados / total : 0.0;
+        printf("%-16s %12lld %12lld %12lld %12lld %11.1f%%\n",
+               nome, m.tamanhoArquivo, m.lixoAtivos, noLugar, realocados, taxa);
+    }
+
+    remove(copia);
+    return 0;
+}
@@ -1,11 +1,57 @@
 #include "binary_operations.h"
-#include "arvore-b.h"
+#include "indice.h"
+#include "wal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> 
+#include <stdbool.h>
 #include <math.h>   
 
 
+// Folga de crescimento reservada ao final dos registros gravados por generateBinaryFile e pelas inserções
+static double folgaPercentual = 0.0;
+static int folgaBytes = 0;
+
+// Atualizações feitas desde o início do programa, para medir a taxa de realocação
+static long long atualizacoesNoLugar = 0;
+static long long atualizacoesRealocadas = 0;
+
+/**
+ * @brief Define a folga de crescimento reservada em cada registro gravado.
+ *
+ * A folga é preenchida com '$', que readRecord já ignora, e entra no
+ * tamanhoRegistro; uma atualização que aumente o registro em até a folga é
+ * regravada no lugar em vez de realocada. Vale para generateBinaryFile e para
+ * as inserções (incluindo as realocações feitas pela atualização), mas não
+ * para a compactação. Padrão: sem folga.
+ *
+ * @param percentual Folga proporcional ao tamanho do registro, em porcentagem.
+ * @param bytes Folga fixa em bytes, somada à proporcional.
+ */
+void setGrowthSlack(double percentual, int bytes) {
+    folgaPercentual = percentual > 0 ? percentual : 0.0;
+    folgaBytes = bytes > 0 ? bytes : 0;
+}
+
+/**
+ * @brief Bytes de folga para um registro com o tamanhoRegistro dado.
+ */
+static int folgaRegistro(int tamanho) {
+    return folgaBytes + (int)(tamanho * folgaPercentual / 100.0);
+}
+
+/**
+ * @brief Informa quantas atualizações foram regravadas no lugar e quantas foram realocadas.
+ *
+ * @param noLugar Atualizações que couberam no espaço do registro.
+ * @param realocados Atualizações que moveram o registro pelo mapa de espaço livre.
+ */
+void getUpdateStats(long long *noLugar, long long *realocados) {
+    if (noLugar) *noLugar = atualizacoesNoLugar;
+    if (realocados) *realocados = atualizacoesRealocadas;
+}
+
+
 /**
  * @brief Gera um arquivo binário a partir de um arquivo CSV de entrada.
  *
@@ -22,7 +68,7 @@ int generateBinaryFile(const char *inputFile, char *binaryFile) {
         return -1; // Retorna falha se o arquivo não puder ser aberto
     }
 
-    FILE *output = fopen(binaryFile, "wb+"); // Abre o arquivo binário para escrita
+    FILE *output = wal_fopen(binaryFile, "wb+"); // Abre o arquivo binário para escrita
     if (!output) {
         printf("Falha no processamento do arquivo.\n");
         fclose(input);
@@ -109,11 +155,16 @@ int generateBinaryFile(const char *inputFile, char *binaryFile) {
         record.removido = '0'; // Marca o registro como não removido
         record.prox = -1; // Define o próximo registro como inexistente
 
-        // Calcula o tamanho do registro
+        // Calcula o tamanho do registro, já com a folga de crescimento
         record.tamanhoRegistro = calculateRecordSize(&record);
+        int folga = folgaRegistro(record.tamanhoRegistro);
+        record.tamanhoRegistro += folga;
 
         // Escreve o registro no arquivo binário
         writeRecord(output, &record);
+        if (folga > 0) {
+            fillWithTrash(output, folga);
+        }
 
         recordCount++; // Incrementa o contador de registros
 
@@ -148,7 +199,7 @@ int generateBinaryFile(const char *inputFile, char *binaryFile) {
  * @param binaryFile Caminho para o arquivo binário a ser lido.
  */
 void printAllUntilId(const char *binaryFile) {
-    FILE *file = fopen(binaryFile, "rb");
+    FILE *file = wal_fopen(binaryFile, "rb");
     if (!file) {
         printf("Falha no processamento do arquivo.\n");
         return; // Stop processing and return to the main menu
@@ -206,7 +257,7 @@ void printAllUntilId(const char *binaryFile) {
  * @param values Array com os valores dos critérios.
  */
 void sequentialSearch(const char *binaryFile, int numCriteria, char criteria[3][256], char values[3][256]) {
-    FILE *file = fopen(binaryFile, "rb"); // Abre o arquivo binário para leitura
+    FILE *file = wal_fopen(binaryFile, "rb"); // Abre o arquivo binário para leitura
     if (!file) {
         printf("Falha no processamento do arquivo.\n");
         return; 
@@ -256,20 +307,114 @@ void sequentialSearch(const char *binaryFile, int numCriteria, char criteria[3][
 
 
 
+/**
+ * @brief Marca um registro como removido e o empilha no topo da lista de removidos.
+ *
+ * Atualiza o cabeçalho e o mapa de espaço livre apenas em memória.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param header Cabeçalho em memória.
+ * @param mapa Mapa de espaço livre (NULL se não houver um em dia).
+ * @param recordOffset Byte offset do registro.
+ * @param tamanhoRegistro tamanhoRegistro do registro.
+ */
+static void marcarRemovido(FILE *file, Header *header, MapaEspacoLivre *mapa, long long recordOffset, int tamanhoRegistro) {
+    char removido = '1';
+
+    // Atualiza o campo prox do registro removido para apontar para o antigo topo
+    long long novoProx = header->topo;
+    header->topo = recordOffset;
+
+    // Atualiza o registro removido no arquivo
+    fseek(file, recordOffset, SEEK_SET);
+    fwrite(&removido, sizeof(char), 1, file);
+    fseek(file, recordOffset + sizeof(char) + sizeof(int), SEEK_SET); // pula tamanhoRegistro
+    fwrite(&novoProx, sizeof(long long), 1, file);
+    mapa_empilhar(mapa, recordOffset, tamanhoRegistro);
+
+    // Atualiza contadores de removidos e ativos
+    header->nroRegRem++;
+    header->nroRegArq--;
+}
+
+// Realocações deixam um esboço no lugar antigo em vez de atualizar o índice
+static bool encaminhamentoAtivo = false;
+
+/**
+ * @brief Ativa o modo de encaminhamento das realocações feitas pela atualização.
+ *
+ * Com ele, um registro que não cabe mais no lugar é gravado em outra posição
+ * e o lugar antigo vira um esboço (removido REGISTRO_ENCAMINHADO, nova posição
+ * em prox), sem descida nem escrita no índice. Quem lê pelo índice segue o
+ * esboço (readRecordFollowing); a compactação incremental e o VACUUM desfazem
+ * os esboços e corrigem os índices de uma vez. Só vale com um índice aberto:
+ * sem ele, não há o que poupar. Padrão: desativado.
+ *
+ * @param ativo true para encaminhar, false para atualizar o índice a cada realocação.
+ */
+void setForwarding(bool ativo) {
+    encaminhamentoAtivo = ativo;
+}
+
+/**
+ * @brief Transforma o registro em um esboço que encaminha para a nova posição.
+ *
+ * Só o prefixo muda: o restante do registro antigo (incluindo o id) continua
+ * legível, e o esboço não entra na lista de removidos.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param recordOffset Byte offset do registro (ou de um esboço já existente).
+ * @param destino Byte offset da nova posição.
+ */
+static void encaminharRegistro(FILE *file, long long recordOffset, long long destino) {
+    char removido = REGISTRO_ENCAMINHADO;
+    fseek(file, recordOffset, SEEK_SET);
+    fwrite(&removido, sizeof(char), 1, file);
+    fseek(file, recordOffset + sizeof(char) + sizeof(int), SEEK_SET);
+    fwrite(&destino, sizeof(long long), 1, file);
+}
+
+/**
+ * @brief Libera um esboço: ele passa a ser um removido comum, no topo da lista.
+ */
+static void liberarEsboco(FILE *file, Header *header, MapaEspacoLivre *mapa, long long recordOffset, int tamanhoRegistro) {
+    marcarRemovido(file, header, mapa, recordOffset, tamanhoRegistro);
+    header->nroRegArq++; // O esboço já não contava como ativo
+}
+
+/**
+ * @brief Posição do critério de igualdade em idAttack, se houver.
+ *
+ * @param numCriteria Número de critérios.
+ * @param criteria Array com os nomes dos campos de critério.
+ * @return Índice do critério idAttack ou -1.
+ */
+static int criterioIdAttack(int numCriteria, char criteria[3][256]) {
+    for (int i = 0; i < numCriteria; i++) {
+        if (strcasecmp(criteria[i], "idAttack") == 0) return i;
+    }
+    return -1;
+}
+
 /**
  * @brief Marca registros como removidos com base em critérios múltiplos.
  *
  * Busca registros no arquivo binário que correspondam aos critérios e altera o campo
- * 'removido' para '1', indicando que o registro foi logicamente excluído.
+ * 'removido' para '1', indicando que o registro foi logicamente excluído. Com um índice
+ * aberto e um critério idAttack, o registro é localizado pelo índice, os demais critérios
+ * são conferidos nele e a chave é removida do índice na mesma operação; sem idAttack, a
+ * varredura sequencial anota os IDs excluídos e, ao final, os remove do índice em um só
+ * lote (indice_remove_many), que na árvore-B refaz cada página afetada uma única vez.
  *
  * @param binaryFile Caminho para o arquivo binário.
  * @param numCriteria Número de critérios.
  * @param criteria Array com os nomes dos campos de critério.
  * @param values Array com os valores dos critérios.
+ * @param indice Sessão do índice (árvore-B ou hash) a manter atualizado (NULL se não houver).
  * @return Número de registros removidos, -1 em caso de falha.
  */
-int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteria[3][256], char values[3][256]) {
-    FILE *file = fopen(binaryFile, "rb+");
+int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteria[3][256], char values[3][256], SessaoIndice *indice) {
+    FILE *file = wal_fopen(binaryFile, "rb+");
     if (!file) {
         printf("Falha no processamento do arquivo.\n");
         return -1;
@@ -283,62 +428,118 @@ int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteri
         return -1;
     }
 
-    // Declara e lê o cabeçalho
+    // Lê o cabeçalho uma única vez; ele é mantido em memória durante a varredura
     Header header;
+    readHeader(file, &header);
 
-    // Move o ponteiro para o byte 276 (início dos registros)
-    if (fseek(file, 276, SEEK_SET) != 0) {
-        printf("Falha ao posicionar o ponteiro no arquivo.\n");
-        fclose(file);
-        return -1;
-    }
+    // Mapa de espaço livre salvo, se estiver em dia, para ser mantido junto
+    MapaEspacoLivre *mapa = mapa_carregar(binaryFile, &header);
+
+    // Marca o arquivo como inconsistente até o cabeçalho final ser gravado
+    status = '0';
+    fseek(file, 0, SEEK_SET);
+    fwrite(&status, sizeof(char), 1, file);
 
     Record record;
-    long long recordOffset, returnOffset;
     int removedCount = 0;
+    int criterioId = criterioIdAttack(numCriteria, criteria);
+
+    if (indice && criterioId >= 0) {
+        // Busca pontual: o índice leva direto ao único registro candidato
+        int id = atoi(values[criterioId]);
+        long long origem = indice_search(indice, id);
+        long long recordOffset = origem;
+
+        if (recordOffset != -1 && readRecordFollowing(file, &recordOffset, &record)) {
+            if (record.removido == '0' && matchRecord(&record, numCriteria, criteria, values) == numCriteria) {
+                marcarRemovido(file, &header, mapa, recordOffset, record.tamanhoRegistro);
+                indice_remove(indice, id);
+                removedCount++;
+
+                // O esboço apontado pelo índice também sai; intermediários ficam para a compactação
+                if (origem != recordOffset) {
+                    int tamanhoEsboco;
+                    fseek(file, origem + sizeof(char), SEEK_SET);
+                    if (fread(&tamanhoEsboco, sizeof(int), 1, file) == 1) {
+                        liberarEsboco(file, &header, mapa, origem, tamanhoEsboco);
+                    }
+                }
+            }
 
-    // Percorre todos os registros no arquivo
-    while (readRecord(file, &record)) {
-        returnOffset = ftell(file);
-        recordOffset = ftell(file) - (sizeof(char) + sizeof(int) + record.tamanhoRegistro);
-        readHeader(file, &header);
-        
-        int matchCount = matchRecord(&record, numCriteria, criteria, values);
-        if (matchCount == numCriteria && record.removido == '0') {
-            // Marca como removido
-            record.removido = '1';
-
-            // Atualiza o campo prox do registro removido para apontar para o antigo topo
-            long long novoProx = header.topo;
-            header.topo = recordOffset;
-
-            // Atualiza o registro removido no arquivo
-            fseek(file, recordOffset, SEEK_SET);
-            fwrite(&record.removido, sizeof(char), 1, file);
-            fseek(file, sizeof(int), SEEK_CUR); // pula tamanhoRegistro
-            fwrite(&novoProx, sizeof(long long), 1, file);
+            free(record.country);
+            free(record.attackType);
+            free(record.targetIndustry);
+            free(record.defenseStrategy);
+        }
+    } else {
+        // Move o ponteiro para o byte 276 (início dos registros)
+        if (fseek(file, 276, SEEK_SET) != 0) {
+            printf("Falha ao posicionar o ponteiro no arquivo.\n");
+            mapa_liberar(mapa);
+            fclose(file);
+            return -1;
+        }
 
-            // Atualiza contadores de removidos e ativos
-            header.nroRegRem++;
-            header.nroRegArq--;
+        long long recordOffset, returnOffset;
+
+        // IDs a remover do índice ao final da varredura
+        int *idsRemovidos = NULL;
+        int nroIds = 0, capacidadeIds = 0;
+
+        // Percorre todos os registros no arquivo
+        while (readRecord(file, &record)) {
+            returnOffset = ftell(file);
+            recordOffset = ftell(file) - (sizeof(char) + sizeof(int) + record.tamanhoRegistro);
+
+            int matchCount = matchRecord(&record, numCriteria, criteria, values);
+            if (matchCount == numCriteria && record.removido == '0') {
+                // Marca como removido (cabeçalho atualizado apenas em memória)
+                marcarRemovido(file, &header, mapa, recordOffset, record.tamanhoRegistro);
+                if (indice) {
+                    if (nroIds == capacidadeIds) {
+                        int novaCapacidade = capacidadeIds ? 2 * capacidadeIds : 64;
+                        int *maior = realloc(idsRemovidos, sizeof(int) * novaCapacidade);
+                        if (maior) {
+                            idsRemovidos = maior;
+                            capacidadeIds = novaCapacidade;
+                        }
+                    }
+                    // Sem memória para anotar, a chave sai do índice na hora
+                    if (nroIds < capacidadeIds) {
+                        idsRemovidos[nroIds++] = record.id;
+                    } else {
+                        indice_remove(indice, record.id);
+                    }
+                }
 
-            removedCount++;
+                removedCount++;
 
-            updateHeader(file, &header);
+                fseek(file, returnOffset, SEEK_SET);
+            }
 
-            fseek(file, returnOffset, SEEK_SET);
+            // Libera memória alocada dinamicamente
+            free(record.country);
+            free(record.attackType);
+            free(record.targetIndustry);
+            free(record.defenseStrategy);
         }
 
-        // Libera memória alocada dinamicamente
-        free(record.country);
-        free(record.attackType);
-        free(record.targetIndustry);
-        free(record.defenseStrategy);
+        indice_remove_many(indice, idsRemovidos, nroIds);
+        free(idsRemovidos);
     }
 
-    // Atualiza o cabeçalho no início do arquivo
-
+    // Atualiza o cabeçalho no início do arquivo, uma única vez, já consistente
+    header.status = '1';
+    updateHeader(file, &header);
     fclose(file);
+
+    if (mapa) {
+        mapa_salvar(mapa, binaryFile, &header);
+        mapa_liberar(mapa);
+    }
+
+    // Compactação incremental, se a fragmentação alcançou o limiar configurado
+    compactDataFileIfNeeded(binaryFile, indice);
     return removedCount;
 }
 
@@ -346,11 +547,159 @@ int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteri
 
 
 
+// Política de reaproveitamento de espaço usada pelas inserções
+static int politicaAlocacao = POLITICA_PRIMEIRO;
+
+/**
+ * @brief Define a política de reaproveitamento de registros removidos nas inserções.
+ *
+ * Todas as políticas mantêm a lista de removidos do disco no formato de sempre;
+ * mudam apenas qual removido recebe o registro novo.
+ *
+ * @param policy Uma das constantes POLITICA_* de espaco-livre.h (padrão: POLITICA_PRIMEIRO).
+ */
+void setAllocationPolicy(int policy) {
+    politicaAlocacao = (policy >= 0 && policy < NRO_POLITICAS) ? policy : POLITICA_PRIMEIRO;
+}
+
+/**
+ * @brief Calcula o tamanho de um registro novo como a inserção sempre calculou.
+ *
+ * Mantém o desconto de 2 bytes por campo variável nulo ou vazio, para que os
+ * arquivos gerados continuem idênticos aos anteriores.
+ *
+ * @param record Registro a ser inserido.
+ * @return tamanhoRegistro do registro novo.
+ */
+static int tamanhoRegistroNovo(const Record *record) {
+    int tamanho = calculateRecordSize(record);
+
+    if (record->country == NULL || strlen(record->country) == 0) {
+        tamanho -= 2;
+    }
+    if (record->attackType == NULL || strlen(record->attackType) == 0) {
+        tamanho -= 2;
+    }
+    if (record->targetIndustry == NULL || strlen(record->targetIndustry) == 0) {
+        tamanho -= 2;
+    }
+    if (record->defenseStrategy == NULL || strlen(record->defenseStrategy) == 0) {
+        tamanho -= 2;
+    }
+    return tamanho;
+}
+
+/**
+ * @brief Grava um registro no lugar de um removido, que sai do mapa e da lista.
+ *
+ * O registro herda o tamanhoRegistro do removido e o restante é completado
+ * com '$'. Atualiza o cabeçalho apenas em memória.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param header Cabeçalho em memória.
+ * @param mapa Mapa de espaço livre do arquivo.
+ * @param no Removido que recebe o registro.
+ * @param record Registro a ser gravado (tamanhoRegistro é preenchido aqui).
+ * @return Byte offset onde o registro foi gravado.
+ */
+static long long gravarEmRemovido(FILE *file, Header *header, MapaEspacoLivre *mapa, NoEspacoLivre *no, Record *record) {
+    long long offset = no->offset;
+    int fillBytes = no->tamanho - tamanhoRegistroNovo(record);
+    record->tamanhoRegistro = no->tamanho;
+    mapa_retirar(mapa, no, file, header);
+
+    fseek(file, offset, SEEK_SET);
+    writeRecord(file, record);
+
+    // Preenche com '$' se necessário
+    if (fillBytes > 0) {
+        fillWithTrash(file, fillBytes);
+    }
+
+    // Atualiza contadores de registros
+    header->nroRegArq++;
+    header->nroRegRem--;
+    return offset;
+}
+
+/**
+ * @brief Grava um registro novo usando o mapa de espaço livre.
+ *
+ * Reaproveita o removido escolhido pela política de alocação (por padrão, o
+ * primeiro da lista que comporte o registro com sua folga de crescimento),
+ * mantendo seu tamanhoRegistro e completando com '$', ou acrescenta ao final
+ * do arquivo, seguido da folga. Acréscimos seguidos
+ * não reposicionam o arquivo, de modo que o buffer do stdio os agrupa em
+ * escritas sequenciais. Atualiza o cabeçalho apenas em memória.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param header Cabeçalho em memória.
+ * @param mapa Mapa de espaço livre do arquivo.
+ * @param record Registro a ser gravado (tamanhoRegistro é preenchido aqui).
+ * @param fimArquivo Byte offset do fim do arquivo (atualizado nos acréscimos).
+ * @param acrescentando Indica se a última operação no arquivo foi um acréscimo terminado em fimArquivo.
+ * @param vizinho Byte offset do registro de ID mais próximo; um removido a até DISTANCIA_MAX_VIZINHO dele tem preferência sobre a política (-1: nenhum).
+ * @return Byte offset onde o registro foi gravado.
+ */
+static long long gravarRegistroNovo(FILE *file, Header *header, MapaEspacoLivre *mapa, Record *record, long long *fimArquivo, bool *acrescentando, long long vizinho) {
+    int novoTamanhoRegistro = tamanhoRegistroNovo(record);
+    int folga = folgaRegistro(novoTamanhoRegistro);
+    NoEspacoLivre *no = mapa_mais_proximo(mapa, novoTamanhoRegistro + folga, vizinho, DISTANCIA_MAX_VIZINHO);
+    if (!no) {
+        no = mapa_escolher(mapa, novoTamanhoRegistro + folga, politicaAlocacao);
+    }
+    long long insertedOffset;
+
+    if (no) {
+        // Reutiliza espaço removido
+        insertedOffset = gravarEmRemovido(file, header, mapa, no, record);
+        *acrescentando = false;
+    } else {
+        record->tamanhoRegistro = novoTamanhoRegistro + folga;
+        // Insere no final do arquivo; se a última escrita já terminou lá, não reposiciona
+        if (!*acrescentando) {
+            fseek(file, *fimArquivo, SEEK_SET);
+        }
+        insertedOffset = *fimArquivo;
+        writeRecord(file, record);
+        if (folga > 0) {
+            fillWithTrash(file, folga);
+        }
+        header->nroRegArq++;
+
+        // Atualiza o proxByteOffset para o próximo byte disponível (final real do arquivo)
+        *fimArquivo = insertedOffset + sizeof(char) + sizeof(int) + record->tamanhoRegistro;
+        header->proxByteOffset = *fimArquivo;
+        *acrescentando = true;
+    }
+
+    return insertedOffset;
+}
+
+/**
+ * @brief Monta um registro novo com cópias dos campos variáveis.
+ */
+static Record montarRegistroNovo(int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy) {
+    Record record;
+    record.removido = '0';
+    record.id = id;
+    record.year = year;
+    record.financialLoss = financialLoss;
+    record.country = country ? strdup(country) : NULL;
+    record.attackType = attackType ? strdup(attackType) : NULL;
+    record.targetIndustry = targetIndustry ? strdup(targetIndustry) : NULL;
+    record.defenseStrategy = defenseStrategy ? strdup(defenseStrategy) : NULL;
+    record.prox = -1;
+    return record;
+}
+
 /**
- * @brief Insere um registro no arquivo binário, reaproveitando registros removidos (First Fit).
+ * @brief Insere um registro no arquivo binário, reaproveitando registros removidos (First Fit por padrão; ver setAllocationPolicy).
  *
  * Insere um novo registro no arquivo binário, reutilizando espaço de registros logicamente removidos
- * ou adicionando no final do arquivo, caso não haja espaço suficiente.
+ * ou adicionando no final do arquivo, caso não haja espaço suficiente. O mapa de espaço livre
+ * vem de "<dados>.fsm" quando ele está em dia; senão, a lista de removidos é lida uma única vez
+ * (apenas o prefixo de 13 bytes de cada removido). O mapa atualizado é gravado de volta.
  *
  * @param binaryFile Caminho para o arquivo binário.
  * @param id Identificador do ataque.
@@ -363,7 +712,7 @@ int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteri
  * @return Byte offset onde o registro foi inserido, -1 em caso de falha.
  */
 long long insertRecord(const char *binaryFile, int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy) {
-    FILE *file = fopen(binaryFile, "rb+");
+    FILE *file = wal_fopen(binaryFile, "rb+");
     if (!file) {
         printf("Falha no processamento do arquivo.\n");
         return -1;
@@ -376,130 +725,28 @@ long long insertRecord(const char *binaryFile, int id, int year, float financial
         return -1;
     }
 
-    // Move o ponteiro para o byte 276 (início dos registros)
-    if (fseek(file, 275, SEEK_SET) != 0) {
-        fclose(file);
-        return -1;
-    }
-
     // Monta o registro a ser inserido
-    Record record;
-    record.removido = '0';
-    record.id = id;
-    record.year = year;
-    record.financialLoss = financialLoss;
-    record.country = country ? strdup(country) : NULL;
-    record.attackType = attackType ? strdup(attackType) : NULL;
-    record.targetIndustry = targetIndustry ? strdup(targetIndustry) : NULL;
-    record.defenseStrategy = defenseStrategy ? strdup(defenseStrategy) : NULL;
-    record.prox = -1;
-
-
-    // Calcula tamanho do registro novo
-    int novoTamanhoRegistro = calculateRecordSize(&record);
-
-
-     if (country == NULL || strlen(country) == 0) {
-        novoTamanhoRegistro -= 2;
-    }
-    if (attackType == NULL || strlen(attackType) == 0) {
-        novoTamanhoRegistro -= 2;
-    }
-    if (targetIndustry == NULL || strlen(targetIndustry) == 0) {
-        novoTamanhoRegistro -= 2;
-    }
-    if (defenseStrategy == NULL || strlen(defenseStrategy) == 0) {
-        novoTamanhoRegistro -= 2;
-    }
-
-
+    Record record = montarRegistroNovo(id, year, financialLoss, country, attackType, targetIndustry, defenseStrategy);
 
     // Declara e lê o cabeçalho
     Header header;
     readHeader(file, &header);
 
-    // Estratégia First Fit: procura espaço removido suficiente
-    long long prevOffset = -1, currOffset = header.topo, foundOffset = -1;
-    int found = 0;
-    int fillBytes = 0; // Variável para armazenar o número de bytes de lixo
-
-    int tamanhoRegistro = 0;
-
-
-    while (currOffset != -1) {
-        Record test; // Declare a Record structure to hold the current record
-        fseek(file, currOffset, SEEK_SET);
-
-        // Read the current record
-        if (!readRecord(file, &test)) {
-            break;
-        }
-
-
-        // Check if the space is sufficient
-        if (test.tamanhoRegistro >= novoTamanhoRegistro) {
-            found = 1;
-            foundOffset = currOffset;
-            fillBytes = test.tamanhoRegistro - novoTamanhoRegistro;
-            tamanhoRegistro = test.tamanhoRegistro;
-
-
-            // Update the 'prox' of the previous offset to point to the 'prox' of the current offset
-            if (prevOffset != -1) {
-                fseek(file, prevOffset + sizeof(char) + sizeof(int), SEEK_SET);
-                fwrite(&test.prox, sizeof(long long), 1, file);
-            } else {
-                // If prevOffset is -1, update the header's topo
-                header.topo = test.prox;
-            }
-            break;
-        }
-
-        // Update the offsets
-        prevOffset = currOffset;
-        currOffset = test.prox;
-
-        // Free dynamically allocated memory in the test record
-        free(test.country);
-        free(test.attackType);
-        free(test.targetIndustry);
-        free(test.defenseStrategy);
-    }
-
     long long insertedOffset = -1;
-
-    if (found) {
-        record.tamanhoRegistro = tamanhoRegistro;
-        // Reutiliza espaço removido
-        insertedOffset = foundOffset;
-        fseek(file, foundOffset, SEEK_SET);
-        writeRecord(file, &record);
-
-        // Preenche com '$' se necessário
-        if (fillBytes > 0) {
-            fillWithTrash(file, fillBytes);
-        }
-
-        // Atualiza contadores de registros
-        header.nroRegArq++;
-        header.nroRegRem--;
-    } else {
-        record.tamanhoRegistro = novoTamanhoRegistro;
-        // Insere no final do arquivo - vai para o final real
-        fseek(file, 0, SEEK_END);
-        insertedOffset = ftell(file);
-        writeRecord(file, &record);
-        header.nroRegArq++;
-
-        // Atualiza o proxByteOffset para o próximo byte disponível (final real do arquivo)
+    MapaEspacoLivre *mapa = mapa_obter(file, binaryFile, &header);
+    if (mapa) {
         fseek(file, 0, SEEK_END);
-        header.proxByteOffset = ftell(file);
-    }
+        long long fimArquivo = ftell(file);
+        bool acrescentando = false;
+        insertedOffset = gravarRegistroNovo(file, &header, mapa, &record, &fimArquivo, &acrescentando, -1);
 
+        // Atualiza o resto do cabeçalho normalmente
+        updateHeader(file, &header);
 
-
-    // Atualiza o resto do cabeçalho normalmente
-    updateHeader(file, &header);
+        // O mapa é gravado depois do cabeçalho, com a assinatura já nova
+        mapa_salvar(mapa, binaryFile, &header);
+        mapa_liberar(mapa);
+    }
 
     free(record.country);
     free(record.attackType);
@@ -514,199 +761,1471 @@ long long insertRecord(const char *binaryFile, int id, int year, float financial
 
 
 /**
- * @brief Atualiza registros no arquivo binário com base em critérios e novos valores.
+ * @brief Abre uma sessão de inserção sobre o arquivo binário.
  *
- * Busca registros que correspondam aos critérios especificados e atualiza seus campos
- * com os novos valores fornecidos. Reutiliza espaço ou realoca registros, se necessário.
+ * O arquivo é aberto uma única vez, o cabeçalho e o mapa de espaço livre ficam
+ * em memória e o status é gravado como '0' até closeInsertSession.
  *
  * @param binaryFile Caminho para o arquivo binário.
- * @param numUpdates Número de atualizações a serem realizadas.
- * @param numCriteria Número de critérios para correspondência.
- * @param criteria Array com os nomes dos campos de critério.
- * @param values Array com os valores dos critérios.
- * @param numUpdatesFields Número de campos a serem atualizados.
- * @param updateFields Array com os nomes dos campos a serem atualizados.
- * @param updateValues Array com os novos valores para os campos.
- * @return Número de registros atualizados, -1 em caso de falha.
+ * @return Sessão aberta ou NULL se o arquivo não existir ou estiver inconsistente.
  */
-int updateRecords(const char *binaryFile, int numUpdates, int numCriteria, char criteria[3][256], char values[3][256], int numUpdatesFields, char updateFields[3][256], char updateValues[3][256], const char *btreeFile, int useBTree) {
-    FILE *file = fopen(binaryFile, "rb+");
+SessaoInsercao *openInsertSession(const char *binaryFile) {
+    FILE *file = wal_fopen(binaryFile, "rb+");
     if (!file) {
         printf("Falha no processamento do arquivo.\n");
-        return -1;
+        return NULL;
     }
+    setvbuf(file, NULL, _IOFBF, TAM_BUFFER_SESSAO);
 
-    // Verifica se o primeiro byte do arquivo é "1"
-    char status;
-    if (fread(&status, sizeof(char), 1, file) != 1 || status != '1') {
-        printf("Falha no processamento do arquivo.\n");
+    SessaoInsercao *sessao = calloc(1, sizeof(SessaoInsercao));
+    if (!sessao) {
         fclose(file);
-        return -1;
+        return NULL;
     }
+    sessao->file = file;
+    readHeader(file, &sessao->header);
 
-    // Declara o cabeçalho
-    Header header;
-
-    // Move o ponteiro para o byte 276 (início dos registros)
-    if (fseek(file, 276, SEEK_SET) != 0) {
-        printf("Falha ao posicionar o ponteiro no arquivo.\n");
+    // Verifica se o arquivo está consistente
+    if (sessao->header.status != '1') {
         fclose(file);
-        return -1;
+        free(sessao);
+        return NULL;
     }
 
-    int updatedCount = 0;
-    Record record;
-
-    while (1) {
-        // Captura o offset ANTES de ler o registro
-        long long recordOffset = ftell(file);
-        
-        // Tenta ler o registro
-        if (!readRecord(file, &record)) {
-            break; // Fim do arquivo
-        }
-
-        int matchCount = matchRecord(&record, numCriteria, criteria, values);
-
-        if (matchCount == numCriteria && record.removido == '0') {
-            readHeader(file, &header);
-
-            Record updated = record;
-
-            updated.country = record.country ? strdup(record.country) : NULL;
-            updated.attackType = record.attackType ? strdup(record.attackType) : NULL;
-            updated.targetIndustry = record.targetIndustry ? strdup(record.targetIndustry) : NULL;
-            updated.defenseStrategy = record.defenseStrategy ? strdup(record.defenseStrategy) : NULL;
-
-            int changed = 0;
-            for (int i = 0; i < numUpdatesFields; i++) {
-                char adjustedValue[256];
-                strncpy(adjustedValue, updateValues[i], sizeof(adjustedValue) - 1);
-                adjustedValue[sizeof(adjustedValue) - 1] = '\0';
-
-                if (strcasecmp(updateFields[i], "idAttack") == 0) {
-                    continue;
-                } else if (strcasecmp(updateFields[i], "year") == 0) {
-                    int newYear = atoi(adjustedValue);
-                    if (updated.year != newYear) {
-                        updated.year = newYear;
-                        changed = 1;
-                    }
-                } else if (strcasecmp(updateFields[i], "financialLoss") == 0) {
-                    float newLoss = safeStringToFloat(adjustedValue);
-                    if (fabs(updated.financialLoss - newLoss) > 0.001) {
-                        updated.financialLoss = newLoss;
-                        changed = 1;
-                    }
-                } else if (strcasecmp(updateFields[i], "country") == 0 && updated.country != NULL) {
-                    if (strcmp(updated.country, adjustedValue) != 0) {
-                        free(updated.country);
-                        updated.country = strdup(adjustedValue);
-                        changed = 1;
-                    }
-                } else if (strcasecmp(updateFields[i], "attackType") == 0 && updated.attackType != NULL) {
-                    if (strcmp(updated.attackType, adjustedValue) != 0) {
-                        free(updated.attackType);
-                        updated.attackType = strdup(adjustedValue);
-                        changed = 1;
-                    }
-                } else if (strcasecmp(updateFields[i], "targetIndustry") == 0 && updated.targetIndustry != NULL) {
-                    if (strcmp(updated.targetIndustry, adjustedValue) != 0) {
-                        free(updated.targetIndustry);
-                        updated.targetIndustry = strdup(adjustedValue);
-                        changed = 1;
-                    }
-                } else if (strcasecmp(updateFields[i], "defenseMechanism") == 0 && updated.defenseStrategy != NULL) {
-                    if (strcmp(updated.defenseStrategy, adjustedValue) != 0) {
-                        free(updated.defenseStrategy);
-                        updated.defenseStrategy = strdup(adjustedValue);
-                        changed = 1;
-                    }
-                }
-            }
-
-            if (changed) {
-                int oldSize = record.tamanhoRegistro;
-                int newSize = calculateRecordSize(&updated);
-
-                if (newSize <= oldSize) {
-                    updated.tamanhoRegistro = oldSize;
-                    fseek(file, recordOffset, SEEK_SET);
-                    writeRecord(file, &updated);
-                    int fillBytes = oldSize - newSize;
-                    if (fillBytes > 0) {
-                        fillWithTrash(file, fillBytes);
-                    }
-                } else {
-                    // Registro será realocado - salva o ID e o offset do registro antigo
-                    int recordID = updated.id;
-                    long long oldRecordOffset = recordOffset; // Salva o offset do registro antigo ANTES de chamar insertRecord
-
-                    // Lê o header atual antes da inserção para verificar onde será inserido
-                    readHeader(file, &header);
-                    long long currentEndOfFile = header.proxByteOffset;
-                    
-                    // Insere o registro e obtém o novo offset diretamente
-                    long long newOffset = insertRecord(binaryFile, updated.id, updated.year, updated.financialLoss, updated.country, updated.attackType, updated.targetIndustry, updated.defenseStrategy);
-                    
-                    readHeader(file, &header);
-
-                    // Se estamos usando B-tree (case 11), precisa atualizar o offset no índice
-                    if (useBTree && btreeFile && newOffset != -1) {
-                        FILE *btreeFilePtr = fopen(btreeFile, "rb+");
-                        if (btreeFilePtr) {
-                            // Atualiza diretamente o offset da chave existente
-                            btree_update_offset(btreeFilePtr, recordID, newOffset);
-                            fclose(btreeFilePtr);
-                        }
-                    }
+    sessao->nomeArquivo = strdup(binaryFile);
+    sessao->mapa = mapa_obter(file, binaryFile, &sessao->header);
+    if (!sessao->nomeArquivo || !sessao->mapa) {
+        mapa_liberar(sessao->mapa);
+        free(sessao->nomeArquivo);
+        fclose(file);
+        free(sessao);
+        return NULL;
+    }
 
-                    record.removido = '1';
-                    // Atualiza o campo prox do registro removido para apontar para o antigo topo
-                    long long novoProx = header.topo;
-                    header.topo = oldRecordOffset; // Usa o offset salvo antes da chamada insertRecord
+    fseek(file, 0, SEEK_END);
+    sessao->fimArquivo = ftell(file);
 
-                    // Atualiza o registro removido no arquivo
-                    fseek(file, oldRecordOffset, SEEK_SET);
-                    fwrite(&record.removido, sizeof(char), 1, file);
-                    fseek(file, sizeof(int), SEEK_CUR); // pula tamanhoRegistro
-                    fwrite(&novoProx, sizeof(long long), 1, file);
+    // Marca o arquivo como inconsistente enquanto a sessão estiver aberta
+    char status = '0';
+    fseek(file, 0, SEEK_SET);
+    fwrite(&status, sizeof(char), 1, file);
 
-                    // Atualiza contadores de removidos
-                    header.nroRegRem++;
+    return sessao;
+}
 
-                    header.nroRegArq--;
-                    //if (newOffset < currentEndOfFile) {
-                    //   header.nroRegArq--;
-                    //}
+/**
+ * @brief Insere um registro usando a sessão, sem reabrir o arquivo nem reler o cabeçalho.
+ *
+ * @param sessao Sessão aberta.
+ * @param id Identificador do ataque.
+ * @param year Ano do ataque.
+ * @param financialLoss Prejuízo financeiro causado pelo ataque.
+ * @param country País onde ocorreu o ataque.
+ * @param attackType Tipo de ataque.
+ * @param targetIndustry Setor alvo do ataque.
+ * @param defenseStrategy Estratégia de defesa utilizada.
+ * @return Byte offset onde o registro foi inserido, -1 em caso de falha.
+ */
+long long insertRecordInSession(SessaoInsercao *sessao, int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy) {
+    return insertRecordNearInSession(sessao, -1, id, year, financialLoss, country, attackType, targetIndustry, defenseStrategy);
+}
+
+/**
+ * @brief Insere um registro pela sessão, preferindo espaço livre perto do registro vizinho.
+ *
+ * Um removido que comporte o registro a até DISTANCIA_MAX_VIZINHO bytes do
+ * vizinho (em geral, o de ID mais próximo, dado por indice_search_neighbor)
+ * é escolhido antes da política de alocação; assim, um arquivo agrupado por
+ * ID (clusterDataFile) continua próximo da ordem dos IDs. Sem removido por
+ * perto, vale a política de sempre.
+ *
+ * @param sessao Sessão aberta.
+ * @param vizinho Byte offset do registro vizinho (-1: nenhum).
+ * @return Byte offset onde o registro foi inserido, -1 em caso de falha.
+ */
+long long insertRecordNearInSession(SessaoInsercao *sessao, long long vizinho, int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy) {
+    if (!sessao) return -1;
+
+    Record record = montarRegistroNovo(id, year, financialLoss, country, attackType, targetIndustry, defenseStrategy);
+    long long insertedOffset = gravarRegistroNovo(sessao->file, &sessao->header, sessao->mapa, &record, &sessao->fimArquivo, &sessao->acrescentando, vizinho);
+
+    free(record.country);
+    free(record.attackType);
+    free(record.targetIndustry);
+    free(record.defenseStrategy);
+    return insertedOffset;
+}
+
+/**
+ * @brief Grava o cabeçalho (consistente) e o mapa de espaço livre e fecha a sessão.
+ *
+ * @param sessao Sessão aberta (liberada por esta função).
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int closeInsertSession(SessaoInsercao *sessao) {
+    if (!sessao) return -1;
+
+    sessao->header.status = '1';
+    updateHeader(sessao->file, &sessao->header);
+    int resultado = fclose(sessao->file) == 0 ? 0 : -1;
+
+    // O mapa é gravado depois do cabeçalho, com a assinatura já nova
+    mapa_salvar(sessao->mapa, sessao->nomeArquivo, &sessao->header);
+
+    mapa_liberar(sessao->mapa);
+    free(sessao->nomeArquivo);
+    free(sessao);
+    return resultado;
+}
+
+
+
+
+/**
+ * @brief Indica se a atualização altera algum campo de tamanho variável.
+ *
+ * @param numUpdatesFields Número de campos a serem atualizados.
+ * @param updateFields Array com os nomes dos campos a serem atualizados.
+ * @return true se algum campo string está entre os atualizados.
+ */
+static bool atualizaCamposVariaveis(int numUpdatesFields, char updateFields[3][256]) {
+    for (int i = 0; i < numUpdatesFields; i++) {
+        if (strcasecmp(updateFields[i], "country") == 0 ||
+            strcasecmp(updateFields[i], "attackType") == 0 ||
+            strcasecmp(updateFields[i], "targetIndustry") == 0 ||
+            strcasecmp(updateFields[i], "defenseMechanism") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Atualiza year e financialLoss gravando apenas os 4 bytes de cada campo.
+ *
+ * Os campos fixos ficam em posições conhecidas do registro e não mudam seu
+ * tamanho, então não há cópia de strings, recálculo de tamanho nem '$'.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param recordOffset Byte offset do registro.
+ * @param record Registro lido do arquivo.
+ * @param numUpdatesFields Número de campos a serem atualizados.
+ * @param updateFields Array com os nomes dos campos a serem atualizados.
+ * @param updateValues Array com os novos valores para os campos.
+ * @return 1 se algum campo mudou, 0 caso contrário.
+ */
+static int atualizarCamposFixos(FILE *file, long long recordOffset, const Record *record, int numUpdatesFields, char updateFields[3][256], char updateValues[3][256]) {
+    int year = record->year;
+    float financialLoss = record->financialLoss;
+
+    for (int i = 0; i < numUpdatesFields; i++) {
+        if (strcasecmp(updateFields[i], "year") == 0) {
+            int newYear = atoi(updateValues[i]);
+            if (year != newYear) {
+                year = newYear;
+            }
+        } else if (strcasecmp(updateFields[i], "financialLoss") == 0) {
+            float newLoss = safeStringToFloat(updateValues[i]);
+            if (fabs(financialLoss - newLoss) > 0.001) {
+                financialLoss = newLoss;
+            }
+        }
+    }
 
-                    updateHeader(file, &header);
+    int changed = 0;
+    if (year != record->year) {
+        fseek(file, recordOffset + OFFSET_YEAR, SEEK_SET);
+        fwrite(&year, sizeof(int), 1, file);
+        changed = 1;
+    }
+    if (financialLoss != record->financialLoss) {
+        fseek(file, recordOffset + OFFSET_FINANCIAL_LOSS, SEEK_SET);
+        fwrite(&financialLoss, sizeof(float), 1, file);
+        changed = 1;
+    }
+    return changed;
+}
 
+/**
+ * @brief Aplica os novos valores a um registro que satisfaz os critérios.
+ *
+ * Regrava o registro no lugar se o novo tamanho couber; senão, grava-o pelo mapa
+ * de espaço livre, atualiza o índice e marca o antigo como removido (no modo de
+ * encaminhamento, o antigo vira um esboço e o índice não é tocado). Cabeçalho e
+ * mapa são atualizados apenas em memória.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param header Cabeçalho em memória.
+ * @param mapa Mapa de espaço livre.
+ * @param fimArquivo Byte offset do fim do arquivo (atualizado nas realocações).
+ * @param recordOffset Byte offset do registro.
+ * @param record Registro lido do arquivo.
+ * @param numUpdatesFields Número de campos a serem atualizados.
+ * @param updateFields Array com os nomes dos campos a serem atualizados.
+ * @param updateValues Array com os novos valores para os campos.
+ * @param indice Sessão do índice a manter atualizado nas realocações (NULL se não houver).
+ * @param origem Byte offset para o qual o índice aponta, se conhecido (-1 caso contrário); difere de recordOffset quando o registro foi alcançado por um esboço.
+ * @return 1 se algum campo mudou, 0 caso contrário.
+ */
+static int aplicarAtualizacao(FILE *file, Header *header, MapaEspacoLivre *mapa, long long *fimArquivo, long long recordOffset, Record *record, int numUpdatesFields, char updateFields[3][256], char updateValues[3][256], SessaoIndice *indice, long long origem) {
+    // Só campos fixos em um registro que seria regravado no lugar: basta trocar os 4 bytes
+    if (!atualizaCamposVariaveis(numUpdatesFields, updateFields) && calculateRecordSize(record) <= record->tamanhoRegistro) {
+        int mudou = atualizarCamposFixos(file, recordOffset, record, numUpdatesFields, updateFields, updateValues);
+        atualizacoesNoLugar += mudou;
+        return mudou;
+    }
 
-                    fseek(file, 276, SEEK_SET);
+    Record updated = *record;
+
+    updated.country = record->country ? strdup(record->country) : NULL;
+    updated.attackType = record->attackType ? strdup(record->attackType) : NULL;
+    updated.targetIndustry = record->targetIndustry ? strdup(record->targetIndustry) : NULL;
+    updated.defenseStrategy = record->defenseStrategy ? strdup(record->defenseStrategy) : NULL;
+
+    int changed = 0;
+    for (int i = 0; i < numUpdatesFields; i++) {
+        char adjustedValue[256];
+        strncpy(adjustedValue, updateValues[i], sizeof(adjustedValue) - 1);
+        adjustedValue[sizeof(adjustedValue) - 1] = '\0';
+
+        if (strcasecmp(updateFields[i], "idAttack") == 0) {
+            continue;
+        } else if (strcasecmp(updateFields[i], "year") == 0) {
+            int newYear = atoi(adjustedValue);
+            if (updated.year != newYear) {
+                updated.year = newYear;
+                changed = 1;
+            }
+        } else if (strcasecmp(updateFields[i], "financialLoss") == 0) {
+            float newLoss = safeStringToFloat(adjustedValue);
+            if (fabs(updated.financialLoss - newLoss) > 0.001) {
+                updated.financialLoss = newLoss;
+                changed = 1;
+            }
+        } else if (strcasecmp(updateFields[i], "country") == 0 && updated.country != NULL) {
+            if (strcmp(updated.country, adjustedValue) != 0) {
+                free(updated.country);
+                updated.country = strdup(adjustedValue);
+                changed = 1;
+            }
+        } else if (strcasecmp(updateFields[i], "attackType") == 0 && updated.attackType != NULL) {
+            if (strcmp(updated.attackType, adjustedValue) != 0) {
+                free(updated.attackType);
+                updated.attackType = strdup(adjustedValue);
+                changed = 1;
+            }
+        } else if (strcasecmp(updateFields[i], "targetIndustry") == 0 && updated.targetIndustry != NULL) {
+            if (strcmp(updated.targetIndustry, adjustedValue) != 0) {
+                free(updated.targetIndustry);
+                updated.targetIndustry = strdup(adjustedValue);
+                changed = 1;
+            }
+        } else if (strcasecmp(updateFields[i], "defenseMechanism") == 0 && updated.defenseStrategy != NULL) {
+            if (strcmp(updated.defenseStrategy, adjustedValue) != 0) {
+                free(updated.defenseStrategy);
+                updated.defenseStrategy = strdup(adjustedValue);
+                changed = 1;
+            }
+        }
+    }
+
+    if (changed) {
+        int oldSize = record->tamanhoRegistro;
+        int newSize = calculateRecordSize(&updated);
+
+        if (newSize <= oldSize) {
+            updated.tamanhoRegistro = oldSize;
+            fseek(file, recordOffset, SEEK_SET);
+            writeRecord(file, &updated);
+            int fillBytes = oldSize - newSize;
+            if (fillBytes > 0) {
+                fillWithTrash(file, fillBytes);
+            }
+            atualizacoesNoLugar++;
+        } else {
+            // Registro será realocado: grava a nova versão pelo mapa de espaço livre
+            Record relocated = updated;
+            relocated.removido = '0';
+            relocated.prox = -1;
+            bool acrescentando = false; // A varredura leu do arquivo desde a última escrita
+            long long newOffset = gravarRegistroNovo(file, header, mapa, &relocated, fimArquivo, &acrescentando, -1);
+
+            if (encaminhamentoAtivo && indice && newOffset != -1) {
+                if (origem != -1 && origem != recordOffset) {
+                    // Já havia um esboço: ele passa a apontar para a nova posição e a antiga é liberada
+                    encaminharRegistro(file, origem, newOffset);
+                    marcarRemovido(file, header, mapa, recordOffset, record->tamanhoRegistro);
+                } else {
+                    // O índice continua apontando para cá; o lugar antigo encaminha para o novo
+                    encaminharRegistro(file, recordOffset, newOffset);
+                    header->nroRegArq--;
                 }
+            } else {
+                // Se há um índice aberto (case 11), atualiza o offset pela sessão
+                if (indice && newOffset != -1) {
+                    indice_update_offset(indice, updated.id, newOffset);
+                }
+
+                // O registro antigo passa a ser o topo da lista, também no mapa
+                marcarRemovido(file, header, mapa, recordOffset, record->tamanhoRegistro);
+            }
+            atualizacoesRealocadas++;
+        }
+    }
+
+    free(updated.country);
+    free(updated.attackType);
+    free(updated.targetIndustry);
+    free(updated.defenseStrategy);
+    return changed;
+}
+
+/**
+ * @brief Atualiza registros no arquivo binário com base em critérios e novos valores.
+ *
+ * Busca registros que correspondam aos critérios especificados e atualiza seus campos
+ * com os novos valores fornecidos. Reutiliza espaço ou realoca registros, se necessário.
+ * A varredura é feita em uma única passada, até o fim que o arquivo tinha no início:
+ * registros realocados para o final não são revisitados, e os realocados para espaço
+ * reaproveitado à frente já trazem os novos valores, de modo que não mudam de novo.
+ * Com um índice aberto e um critério idAttack, não há varredura: o registro é lido no
+ * offset dado pelo índice e os demais critérios são conferidos nele.
+ *
+ * @param binaryFile Caminho para o arquivo binário.
+ * @param numUpdates Número de atualizações a serem realizadas.
+ * @param numCriteria Número de critérios para correspondência.
+ * @param criteria Array com os nomes dos campos de critério.
+ * @param values Array com os valores dos critérios.
+ * @param numUpdatesFields Número de campos a serem atualizados.
+ * @param updateFields Array com os nomes dos campos a serem atualizados.
+ * @param updateValues Array com os novos valores para os campos.
+ * @param indice Sessão do índice (árvore-B ou hash) a manter atualizado nas realocações (NULL se não houver).
+ * @return Número de registros atualizados, -1 em caso de falha.
+ */
+int updateRecords(const char *binaryFile, int numUpdates, int numCriteria, char criteria[3][256], char values[3][256], int numUpdatesFields, char updateFields[3][256], char updateValues[3][256], SessaoIndice *indice) {
+    FILE *file = wal_fopen(binaryFile, "rb+");
+    if (!file) {
+        printf("Falha no processamento do arquivo.\n");
+        return -1;
+    }
+
+    // Verifica se o primeiro byte do arquivo é "1"
+    char status;
+    if (fread(&status, sizeof(char), 1, file) != 1 || status != '1') {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(file);
+        return -1;
+    }
+
+    // Declara e lê o cabeçalho; ele é mantido em memória até o fim
+    Header header;
+    readHeader(file, &header);
+
+    // Mapa de espaço livre para as realocações (do arquivo .fsm, se estiver em dia)
+    MapaEspacoLivre *mapa = mapa_obter(file, binaryFile, &header);
+    if (!mapa) {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(file);
+        return -1;
+    }
+
+    // Só as realocações aumentam o arquivo; a varredura para no fim original
+    fseek(file, 0, SEEK_END);
+    long long fimArquivo = ftell(file);
+    long long horizonte = fimArquivo;
+
+    // Marca o arquivo como inconsistente até o cabeçalho final ser gravado
+    status = '0';
+    fseek(file, 0, SEEK_SET);
+    fwrite(&status, sizeof(char), 1, file);
+
+    int updatedCount = 0;
+    Record record;
+    long long recordOffset = 276; // Início dos registros
+    int criterioId = criterioIdAttack(numCriteria, criteria);
+
+    if (indice && criterioId >= 0) {
+        // Busca pontual: o índice leva direto ao único registro candidato
+        long long origem = indice_search(indice, atoi(values[criterioId]));
+        recordOffset = origem;
+
+        if (recordOffset != -1 && readRecordFollowing(file, &recordOffset, &record)) {
+            if (record.removido == '0' && matchRecord(&record, numCriteria, criteria, values) == numCriteria &&
+                aplicarAtualizacao(file, &header, mapa, &fimArquivo, recordOffset, &record, numUpdatesFields, updateFields, updateValues, indice, origem)) {
                 updatedCount++;
             }
 
-            free(updated.country);
-            free(updated.attackType);
-            free(updated.targetIndustry);
-            free(updated.defenseStrategy);
+            free(record.country);
+            free(record.attackType);
+            free(record.targetIndustry);
+            free(record.defenseStrategy);
+        }
+    } else {
+        // Move o ponteiro para o byte 276 (início dos registros)
+        fseek(file, recordOffset, SEEK_SET);
+
+        while (recordOffset < horizonte) {
+            // Tenta ler o registro
+            if (!readRecord(file, &record)) {
+                break; // Fim do arquivo
+            }
+            long long nextOffset = ftell(file);
+
+            int matchCount = matchRecord(&record, numCriteria, criteria, values);
+
+            if (matchCount == numCriteria && record.removido == '0') {
+                if (aplicarAtualizacao(file, &header, mapa, &fimArquivo, recordOffset, &record, numUpdatesFields, updateFields, updateValues, indice, -1)) {
+                    updatedCount++;
+
+                    // Continua a varredura logo após o registro atualizado
+                    fseek(file, nextOffset, SEEK_SET);
+                }
+            }
+
+            free(record.country);
+            free(record.attackType);
+            free(record.targetIndustry);
+            free(record.defenseStrategy);
+
+            recordOffset = nextOffset;
+        }
+    }
+
+    // Cabeçalho gravado uma única vez, já consistente; o mapa acompanha
+    header.status = '1';
+    updateHeader(file, &header);
+    fclose(file);
+
+    mapa_salvar(mapa, binaryFile, &header);
+    mapa_liberar(mapa);
+
+    // Compactação incremental, se a fragmentação alcançou o limiar configurado
+    compactDataFileIfNeeded(binaryFile, indice);
+    return updatedCount;
+}
+
+/**
+ * @brief Copia um arquivo inteiro (usado para preparar a cópia temporária do índice).
+ *
+ * @return true se a cópia foi gravada por completo.
+ */
+static bool copiarArquivo(const char *origem, const char *destino) {
+    FILE *in = fopen(origem, "rb");
+    if (!in) return false;
+    FILE *out = fopen(destino, "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+
+    char buffer[8192];
+    size_t lidos;
+    bool ok = true;
+    while (ok && (lidos = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        ok = fwrite(buffer, 1, lidos, out) == lidos;
+    }
+    fclose(in);
+    if (fclose(out) != 0) ok = false;
+    return ok;
+}
+
+/**
+ * @brief Par de offsets (antigo, novo) de uma reescrita do arquivo de dados.
+ */
+typedef struct {
+    long long antigo;
+    long long novo;
+} ParOffsets;
+
+/**
+ * @brief Busca binária de um offset antigo entre pares ordenados por ele.
+ */
+static int buscarPar(const ParOffsets pares[], int n, long long antigo) {
+    int ini = 0, fim = n - 1;
+    while (ini <= fim) {
+        int meio = ini + (fim - ini) / 2;
+        if (pares[meio].antigo == antigo) return meio;
+        if (pares[meio].antigo < antigo) ini = meio + 1;
+        else fim = meio - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Guarda um esboço encontrado na varredura de uma reescrita.
+ */
+static bool guardarEsboco(ParOffsets **esbocos, int *n, int *capacidade, long long offset, long long destino) {
+    if (*n == *capacidade) {
+        int maior = *capacidade > 0 ? *capacidade * 2 : 64;
+        ParOffsets *novos = realloc(*esbocos, sizeof(ParOffsets) * maior);
+        if (!novos) return false;
+        *esbocos = novos;
+        *capacidade = maior;
+    }
+    (*esbocos)[*n].antigo = offset;
+    (*esbocos)[*n].novo = destino;
+    (*n)++;
+    return true;
+}
+
+/**
+ * @brief Acrescenta ao mapa de offsets os esboços de registros encaminhados.
+ *
+ * Cada esboço passa a ser traduzido para a posição nova do registro ao fim da
+ * sua cadeia, de modo que os índices que ainda apontam para esboços sejam
+ * corrigidos junto com os demais. Esboços cuja cadeia termina em um removido
+ * ficam de fora. Os vetores são realocados e continuam em ordem crescente
+ * dos offsets antigos.
+ *
+ * @param antigos Offsets antigos dos registros ativos, em ordem crescente.
+ * @param novos Offsets novos correspondentes.
+ * @param n Número de pares; recebe o total com os esboços.
+ * @param esbocos Esboços (offset do esboço, destino), em ordem crescente do esboço.
+ * @param nroEsbocos Número de esboços.
+ * @return true em caso de sucesso.
+ */
+static bool acrescentarEsbocos(long long **antigos, long long **novos, int *n, const ParOffsets esbocos[], int nroEsbocos) {
+    if (nroEsbocos == 0) return true;
+
+    long long *a = malloc(sizeof(long long) * (*n + nroEsbocos));
+    long long *b = malloc(sizeof(long long) * (*n + nroEsbocos));
+    if (!a || !b) {
+        free(a);
+        free(b);
+        return false;
+    }
+
+    // Intercala os dois conjuntos, ambos em ordem de offset antigo
+    int i = 0, j = 0, total = 0;
+    while (i < *n || j < nroEsbocos) {
+        if (j == nroEsbocos || (i < *n && (*antigos)[i] < esbocos[j].antigo)) {
+            a[total] = (*antigos)[i];
+            b[total++] = (*novos)[i++];
+            continue;
+        }
+
+        long long destino = esbocos[j].novo;
+        long long novo = -1;
+        for (int saltos = 0; saltos <= nroEsbocos && destino != -1; saltos++) {
+            novo = remapearOffset(*antigos, *novos, *n, destino);
+            if (novo != -1) break;
+            int k = buscarPar(esbocos, nroEsbocos, destino);
+            destino = k >= 0 ? esbocos[k].novo : -1;
+        }
+        if (novo != -1) {
+            a[total] = esbocos[j].antigo;
+            b[total++] = novo;
+        }
+        j++;
+    }
+
+    free(*antigos);
+    free(*novos);
+    *antigos = a;
+    *novos = b;
+    *n = total;
+    return true;
+}
+
+/**
+ * @brief Conclui uma reescrita completa do arquivo de dados (VACUUM ou CLUSTER).
+ *
+ * Grava "<dados>.remap" com os pares de offsets, traduz uma cópia do índice
+ * e só então troca os arquivos. O mapa de offsets só serve para refazer a
+ * tradução se a troca for interrompida entre os dois rename(), e é removido
+ * ao fim; o mapa de espaço livre também deixa de valer e é removido. Em caso
+ * de falha, as cópias são removidas e os originais ficam intactos.
+ *
+ * @param binaryFile Nome do arquivo de dados.
+ * @param temporario Arquivo de dados reescrito, já completo e fechado.
+ * @param indexFile Nome do índice (NULL se não houver).
+ * @param antigos Offsets antigos dos registros ativos, em ordem crescente.
+ * @param novos Offsets novos correspondentes.
+ * @param n Número de pares.
+ * @return true se os arquivos foram trocados.
+ */
+static bool concluirReescrita(const char *binaryFile, const char *temporario, const char *indexFile, const long long antigos[], const long long novos[], int n) {
+    size_t tamanhoNome = strlen(binaryFile) + 7;
+    char *nomeRemap = malloc(tamanhoNome);
+    char *indiceTemporario = indexFile ? malloc(strlen(indexFile) + 5) : NULL;
+    bool ok = nomeRemap && (!indexFile || indiceTemporario);
+    bool mapaGravado = false;
+
+    // Mapa de offsets, guardado até os dois arquivos estarem trocados
+    if (ok) {
+        snprintf(nomeRemap, tamanhoNome, "%s.remap", binaryFile);
+        FILE *remap = fopen(nomeRemap, "wb");
+        ok = remap != NULL;
+        if (ok) {
+            fwrite(&n, sizeof(int), 1, remap);
+            for (int i = 0; i < n; i++) {
+                fwrite(&antigos[i], sizeof(long long), 1, remap);
+                fwrite(&novos[i], sizeof(long long), 1, remap);
+            }
+            if (fclose(remap) != 0) ok = false;
+            mapaGravado = true;
+        }
+    }
+
+    if (ok && indexFile) {
+        sprintf(indiceTemporario, "%s.tmp", indexFile);
+        ok = copiarArquivo(indexFile, indiceTemporario) &&
+             indice_remap_offsets(indiceTemporario, antigos, novos, n) >= 0;
+    }
+
+    // Troca os arquivos só com as duas cópias completas
+    bool dadosTrocados = ok && rename(temporario, binaryFile) == 0;
+    ok = dadosTrocados;
+    if (ok && indexFile && rename(indiceTemporario, indexFile) != 0) ok = false;
+    if (ok) {
+        char *nomeMapa = malloc(strlen(binaryFile) + 5);
+        if (nomeMapa) {
+            sprintf(nomeMapa, "%s.fsm", binaryFile);
+            remove(nomeMapa);
+            free(nomeMapa);
+        }
+    } else {
+        remove(temporario);
+        if (indiceTemporario) remove(indiceTemporario);
+    }
+    // Com os dados trocados e o índice não, o mapa é o que permite traduzir o índice depois
+    if (mapaGravado && (ok || !dadosTrocados)) remove(nomeRemap);
+
+    free(nomeRemap);
+    free(indiceTemporario);
+    return ok;
+}
+
+/**
+ * @brief Compacta o arquivo de dados, mantendo apenas os registros ativos (VACUUM).
+ *
+ * Os registros ativos são regravados em sequência em "<dados>.tmp", sem
+ * removidos e sem o preenchimento '$', cada um com o tamanhoRegistro exato.
+ * O cabeçalho novo tem topo -1 e nroRegRem 0. O mapa de offsets antigo -> novo
+ * é gravado em "<dados>.remap" (nroEntradas seguido dos pares) enquanto é
+ * aplicado em uma única passada a uma cópia do índice, se houver um, e
+ * removido depois da troca. Só depois que as
+ * duas cópias estão completas elas substituem os originais com rename(), que é
+ * atômico; até lá os arquivos originais não são alterados. O mapa de espaço
+ * livre "<dados>.fsm" deixa de valer e é apagado.
+ *
+ * @param binaryFile Caminho para o arquivo binário.
+ * @param indexFile Caminho para o índice (árvore-B ou hash) a atualizar (NULL se não houver).
+ * @return Número de registros mantidos, -1 em caso de falha.
+ */
+int vacuumDataFile(const char *binaryFile, const char *indexFile) {
+    FILE *file = wal_fopen(binaryFile, "rb");
+    if (!file) return -1;
+
+    char cabecalho[276];
+    if (fread(cabecalho, 1, sizeof(cabecalho), file) != sizeof(cabecalho) || cabecalho[0] != '1') {
+        fclose(file);
+        return -1;
+    }
+    Header header;
+    readHeader(file, &header);
+
+    char *temporario = malloc(strlen(binaryFile) + 5);
+    FILE *novo = NULL;
+    if (temporario) {
+        sprintf(temporario, "%s.tmp", binaryFile);
+        novo = fopen(temporario, "wb");
+    }
+    if (!novo) {
+        free(temporario);
+        fclose(file);
+        return -1;
+    }
+    setvbuf(novo, NULL, _IOFBF, TAM_BUFFER_SESSAO);
+
+    // Cabeçalho copiado como está, inconsistente até o fim da cópia
+    cabecalho[0] = '0';
+    fwrite(cabecalho, 1, sizeof(cabecalho), novo);
+
+    int capacidade = header.nroRegArq > 0 ? header.nroRegArq : 1024;
+    long long *antigos = malloc(sizeof(long long) * capacidade);
+    long long *novos = malloc(sizeof(long long) * capacidade);
+    int mantidos = 0;
+    bool ok = antigos && novos;
+    ParOffsets *esbocos = NULL;
+    int nroEsbocos = 0, capacidadeEsbocos = 0;
+
+    // Varredura sequencial: a posição antes de cada leitura é o offset do registro
+    long long recordOffset = 276;
+    long long novoOffset = 276;
+    Record record;
+    fseek(file, recordOffset, SEEK_SET);
+    while (ok && readRecord(file, &record)) {
+        if (record.removido == '0') {
+            if (mantidos == capacidade) {
+                capacidade *= 2;
+                long long *a = realloc(antigos, sizeof(long long) * capacidade);
+                if (a) antigos = a;
+                long long *b = realloc(novos, sizeof(long long) * capacidade);
+                if (b) novos = b;
+                ok = a && b;
+            }
+            if (ok) {
+                // Campos vazios voltam de readRecord como "", que não ocupam bytes no registro
+                record.tamanhoRegistro = tamanhoRegistroNovo(&record);
+                record.prox = -1;
+                writeRecord(novo, &record);
+
+                antigos[mantidos] = recordOffset;
+                novos[mantidos] = novoOffset;
+                mantidos++;
+                novoOffset += sizeof(char) + sizeof(int) + record.tamanhoRegistro;
+            }
+        } else if (record.removido == REGISTRO_ENCAMINHADO) {
+            // Esboços não são copiados; quem apontava para eles passa a apontar para o destino
+            ok = guardarEsboco(&esbocos, &nroEsbocos, &capacidadeEsbocos, recordOffset, record.prox);
         }
 
         free(record.country);
         free(record.attackType);
         free(record.targetIndustry);
         free(record.defenseStrategy);
+        recordOffset = ftell(file);
+    }
+    fclose(file);
+
+    // Cabeçalho final: nenhum removido, fim do arquivo logo após o último ativo
+    if (ok) {
+        header.topo = -1;
+        header.proxByteOffset = novoOffset;
+        header.nroRegArq = mantidos;
+        header.nroRegRem = 0;
+        updateHeader(novo, &header);
+    }
+    if (fclose(novo) != 0) ok = false;
+
+    int nroPares = mantidos;
+    if (ok) ok = acrescentarEsbocos(&antigos, &novos, &nroPares, esbocos, nroEsbocos);
+    if (ok) {
+        ok = concluirReescrita(binaryFile, temporario, indexFile, antigos, novos, nroPares);
+    } else {
+        remove(temporario);
+    }
+
+    free(antigos);
+    free(novos);
+    free(esbocos);
+    free(temporario);
+    return ok ? mantidos : -1;
+}
+
+
+/**
+ * @brief Libera os campos variáveis de um registro lido.
+ */
+static void liberarCampos(Record *record) {
+    free(record->country);
+    free(record->attackType);
+    free(record->targetIndustry);
+    free(record->defenseStrategy);
+}
+
+/**
+ * @brief Compara registros pelo ID, para o qsort das corridas.
+ */
+static int compararRegistrosPorId(const void *a, const void *b) {
+    int x = ((const Record *)a)->id;
+    int y = ((const Record *)b)->id;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Compara pares pelo offset antigo, a ordem pedida por indice_remap_offsets.
+ */
+static int compararParesPorAntigo(const void *a, const void *b) {
+    long long x = ((const ParOffsets *)a)->antigo;
+    long long y = ((const ParOffsets *)b)->antigo;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nome da corrida i do agrupamento: "<dados>.run<i>".
+ */
+static char *nomeCorrida(const char *binaryFile, int i) {
+    size_t tamanho = strlen(binaryFile) + 16;
+    char *nome = malloc(tamanho);
+    if (nome) snprintf(nome, tamanho, "%s.run%d", binaryFile, i);
+    return nome;
+}
+
+/**
+ * @brief Ordena um bloco de registros e o grava como a corrida i.
+ *
+ * Os registros vão compactos e ativos, com o offset antigo no campo prox,
+ * de modo que readRecord os lê de volta sem nenhum formato próprio. Os campos
+ * do bloco são liberados.
+ */
+static bool gravarCorrida(const char *binaryFile, int i, Record *bloco, int n) {
+    qsort(bloco, n, sizeof(Record), compararRegistrosPorId);
+
+    char *nome = nomeCorrida(binaryFile, i);
+    FILE *corrida = nome ? fopen(nome, "wb") : NULL;
+    free(nome);
+    if (corrida) setvbuf(corrida, NULL, _IOFBF, TAM_BUFFER_SESSAO);
+
+    for (int j = 0; j < n; j++) {
+        if (corrida) writeRecord(corrida, &bloco[j]);
+        liberarCampos(&bloco[j]);
+    }
+    return corrida && fclose(corrida) == 0;
+}
+
+/**
+ * @brief Acrescenta um registro ao arquivo agrupado e guarda seu par de offsets.
+ *
+ * O offset antigo vem no campo prox, como nas corridas.
+ */
+static bool emitirAgrupado(FILE *novo, Record *record, ParOffsets **pares, int *n, int *capacidade, long long *novoOffset) {
+    if (*n == *capacidade) {
+        *capacidade *= 2;
+        ParOffsets *maior = realloc(*pares, sizeof(ParOffsets) * *capacidade);
+        if (!maior) return false;
+        *pares = maior;
+    }
+    (*pares)[*n].antigo = record->prox;
+    (*pares)[*n].novo = *novoOffset;
+    (*n)++;
+
+    record->prox = -1;
+    writeRecord(novo, record);
+    *novoOffset += sizeof(char) + sizeof(int) + record->tamanhoRegistro;
+    return true;
+}
+
+/**
+ * @brief Cabeça de uma corrida na intercalação.
+ */
+typedef struct {
+    Record registro;
+    FILE *corrida;
+    int ordem;          // Posição da corrida no grupo, que desempata IDs iguais
+} CabecaCorrida;
+
+static bool cabecaMenor(const CabecaCorrida *a, const CabecaCorrida *b) {
+    if (a->registro.id != b->registro.id) return a->registro.id < b->registro.id;
+    return a->ordem < b->ordem;
+}
+
+/**
+ * @brief Desce a cabeça da posição i até restaurar o heap de mínimo.
+ */
+static void descerCabeca(CabecaCorrida *heap, int n, int i) {
+    while (true) {
+        int menor = i;
+        int esquerda = 2 * i + 1, direita = 2 * i + 2;
+        if (esquerda < n && cabecaMenor(&heap[esquerda], &heap[menor])) menor = esquerda;
+        if (direita < n && cabecaMenor(&heap[direita], &heap[menor])) menor = direita;
+        if (menor == i) return;
+
+        CabecaCorrida troca = heap[i];
+        heap[i] = heap[menor];
+        heap[menor] = troca;
+        i = menor;
+    }
+}
+
+/**
+ * @brief Intercala as corridas [primeira, primeira + nro) e as apaga.
+ *
+ * As cabeças ficam em um heap de mínimo por ID. Com destino >= 0, o
+ * resultado é gravado como a corrida destino, ainda com o offset antigo em
+ * prox; com destino -1, cada registro vai para o arquivo agrupado por
+ * emitirAgrupado.
+ */
+static bool intercalarCorridas(const char *binaryFile, int primeira, int nro, int destino, FILE *novo, ParOffsets **pares, int *mantidos, int *capacidadePares, long long *novoOffset) {
+    CabecaCorrida *heap = malloc(sizeof(CabecaCorrida) * nro);
+    FILE **corridas = calloc(nro, sizeof(FILE *));
+    FILE *saida = NULL;
+    bool ok = heap && corridas;
+
+    if (ok && destino >= 0) {
+        char *nome = nomeCorrida(binaryFile, destino);
+        saida = nome ? fopen(nome, "wb") : NULL;
+        free(nome);
+        ok = saida != NULL;
+        if (ok) setvbuf(saida, NULL, _IOFBF, TAM_BUFFER_SESSAO);
+    }
+
+    int n = 0;
+    for (int i = 0; ok && i < nro; i++) {
+        char *nome = nomeCorrida(binaryFile, primeira + i);
+        corridas[i] = nome ? fopen(nome, "rb") : NULL;
+        free(nome);
+        ok = corridas[i] != NULL;
+        if (ok && readRecord(corridas[i], &heap[n].registro)) {
+            heap[n].corrida = corridas[i];
+            heap[n].ordem = i;
+            n++;
+        }
+    }
+    for (int i = n / 2 - 1; ok && i >= 0; i--) {
+        descerCabeca(heap, n, i);
     }
 
+    while (ok && n > 0) {
+        Record *menor = &heap[0].registro;
+        if (saida) {
+            writeRecord(saida, menor);
+        } else {
+            ok = emitirAgrupado(novo, menor, pares, mantidos, capacidadePares, novoOffset);
+        }
+        liberarCampos(menor);
+
+        // A corrida esgotada sai do heap; a última cabeça toma o lugar dela
+        if (!readRecord(heap[0].corrida, menor)) {
+            heap[0] = heap[--n];
+        }
+        descerCabeca(heap, n, 0);
+    }
+
+    for (int i = 0; i < n; i++) {
+        liberarCampos(&heap[i].registro);
+    }
+    for (int i = 0; corridas && i < nro; i++) {
+        if (corridas[i]) fclose(corridas[i]);
+        char *nome = nomeCorrida(binaryFile, primeira + i);
+        if (nome) remove(nome);
+        free(nome);
+    }
+    if (saida && fclose(saida) != 0) ok = false;
+    free(heap);
+    free(corridas);
+    return ok;
+}
+
+/**
+ * @brief Reescreve o arquivo de dados em ordem de idAttack (CLUSTER) e traduz o índice.
+ *
+ * Ordenação externa: os registros ativos são lidos em blocos de até
+ * TAM_MEMORIA_AGRUPAMENTO bytes, cada bloco é ordenado por ID e gravado como
+ * uma corrida ("<dados>.run<i>"), e as corridas são intercaladas em
+ * "<dados>.tmp". Cada intercalação abre no máximo MAX_CORRIDAS_INTERCALACAO
+ * corridas; havendo mais, passadas intermediárias as juntam em corridas
+ * maiores até que caibam em uma só. Se o arquivo inteiro couber em um bloco, ele é gravado
+ * direto, sem corridas. Como no VACUUM, o resultado não tem removidos nem
+ * '$', os offsets são traduzidos em uma cópia do índice e os arquivos só são
+ * trocados com as duas cópias completas. Depois do agrupamento, IDs próximos
+ * ficam em offsets próximos e uma faixa de IDs é lida sequencialmente.
+ *
+ * @param binaryFile Caminho para o arquivo binário.
+ * @param indexFile Índice (árvore-B ou hash) a traduzir; NULL se não houver.
+ * @return Número de registros mantidos, -1 em caso de falha.
+ */
+int clusterDataFile(const char *binaryFile, const char *indexFile) {
+    FILE *file = wal_fopen(binaryFile, "rb");
+    if (!file) return -1;
+
+    char cabecalho[276];
+    if (fread(cabecalho, 1, sizeof(cabecalho), file) != sizeof(cabecalho) || cabecalho[0] != '1') {
+        fclose(file);
+        return -1;
+    }
+    Header header;
+    readHeader(file, &header);
+
+    // Fase 1: corridas ordenadas
+    int capacidadeBloco = 1024;
+    Record *bloco = malloc(sizeof(Record) * capacidadeBloco);
+    int nroBloco = 0;
+    long long bytesBloco = 0;
+    int nroCorridas = 0;
+    bool ok = bloco != NULL;
+    ParOffsets *esbocos = NULL;
+    int nroEsbocos = 0, capacidadeEsbocos = 0;
+
+    long long recordOffset = 276;
+    Record record;
+    fseek(file, recordOffset, SEEK_SET);
+    while (ok && readRecord(file, &record)) {
+        if (record.removido != '0') {
+            // Esboços não são copiados; quem apontava para eles passa a apontar para o destino
+            if (record.removido == REGISTRO_ENCAMINHADO) {
+                ok = guardarEsboco(&esbocos, &nroEsbocos, &capacidadeEsbocos, recordOffset, record.prox);
+            }
+            liberarCampos(&record);
+            recordOffset = ftell(file);
+            continue;
+        }
+        if (nroBloco == capacidadeBloco) {
+            capacidadeBloco *= 2;
+            Record *maior = realloc(bloco, sizeof(Record) * capacidadeBloco);
+            if (maior) bloco = maior;
+            ok = maior != NULL;
+        }
+        if (!ok) {
+            liberarCampos(&record);
+            break;
+        }
+
+        // Campos vazios voltam de readRecord como "", que não ocupam bytes no registro
+        record.tamanhoRegistro = tamanhoRegistroNovo(&record);
+        record.prox = recordOffset;
+        bloco[nroBloco++] = record;
+        bytesBloco += sizeof(char) + sizeof(int) + record.tamanhoRegistro;
+        recordOffset = ftell(file);
+
+        if (bytesBloco >= TAM_MEMORIA_AGRUPAMENTO) {
+            ok = gravarCorrida(binaryFile, nroCorridas++, bloco, nroBloco);
+            nroBloco = 0;
+            bytesBloco = 0;
+        }
+    }
     fclose(file);
-    return updatedCount;
+
+    // Um bloco que não chegou ao limite fica em memória se for o único
+    if (ok && nroCorridas > 0 && nroBloco > 0) {
+        ok = gravarCorrida(binaryFile, nroCorridas++, bloco, nroBloco);
+        nroBloco = 0;
+    } else if (ok) {
+        qsort(bloco, nroBloco, sizeof(Record), compararRegistrosPorId);
+    }
+
+    // Fase 2: intercalação em "<dados>.tmp"
+    char *temporario = malloc(strlen(binaryFile) + 5);
+    FILE *novo = NULL;
+    if (ok && temporario) {
+        sprintf(temporario, "%s.tmp", binaryFile);
+        novo = fopen(temporario, "wb");
+    }
+    int capacidadePares = header.nroRegArq > 0 ? header.nroRegArq : 1024;
+    ParOffsets *pares = malloc(sizeof(ParOffsets) * capacidadePares);
+    int mantidos = 0;
+    long long novoOffset = 276;
+    ok = ok && novo && pares;
+
+    if (ok) {
+        setvbuf(novo, NULL, _IOFBF, TAM_BUFFER_SESSAO);
+
+        // Cabeçalho copiado como está, inconsistente até o fim da cópia
+        cabecalho[0] = '0';
+        fwrite(cabecalho, 1, sizeof(cabecalho), novo);
+
+        if (nroCorridas == 0) {
+            for (int i = 0; ok && i < nroBloco; i++) {
+                ok = emitirAgrupado(novo, &bloco[i], &pares, &mantidos, &capacidadePares, &novoOffset);
+            }
+        } else {
+            // Passadas intermediárias: grupos de corridas viram corridas novas, numeradas em seguida
+            int inicio = 0, fim = nroCorridas;
+            while (ok && fim - inicio > MAX_CORRIDAS_INTERCALACAO) {
+                int proxima = fim;
+                for (int i = inicio; ok && i < fim; i += MAX_CORRIDAS_INTERCALACAO) {
+                    int nro = fim - i < MAX_CORRIDAS_INTERCALACAO ? fim - i : MAX_CORRIDAS_INTERCALACAO;
+                    ok = intercalarCorridas(binaryFile, i, nro, proxima++, NULL, NULL, NULL, NULL, NULL);
+                }
+                inicio = fim;
+                fim = proxima;
+            }
+            nroCorridas = fim;
+
+            ok = ok && intercalarCorridas(binaryFile, inicio, fim - inicio, -1, novo, &pares, &mantidos, &capacidadePares, &novoOffset);
+        }
+    }
+
+    // Corridas que uma falha deixou para trás
+    for (int i = 0; i < nroCorridas; i++) {
+        char *nome = nomeCorrida(binaryFile, i);
+        if (nome) remove(nome);
+        free(nome);
+    }
+    for (int i = 0; i < nroBloco; i++) {
+        liberarCampos(&bloco[i]);
+    }
+    free(bloco);
+
+    // Cabeçalho final: nenhum removido, fim do arquivo logo após o último ativo
+    if (ok) {
+        header.topo = -1;
+        header.proxByteOffset = novoOffset;
+        header.nroRegArq = mantidos;
+        header.nroRegRem = 0;
+        updateHeader(novo, &header);
+    }
+    if (novo && fclose(novo) != 0) ok = false;
+
+    // O índice é traduzido pela ordem dos offsets antigos
+    long long *antigos = ok ? malloc(sizeof(long long) * (mantidos > 0 ? mantidos : 1)) : NULL;
+    long long *novos = ok ? malloc(sizeof(long long) * (mantidos > 0 ? mantidos : 1)) : NULL;
+    ok = ok && antigos && novos;
+    if (ok) {
+        qsort(pares, mantidos, sizeof(ParOffsets), compararParesPorAntigo);
+        for (int i = 0; i < mantidos; i++) {
+            antigos[i] = pares[i].antigo;
+            novos[i] = pares[i].novo;
+        }
+        int nroPares = mantidos;
+        if (acrescentarEsbocos(&antigos, &novos, &nroPares, esbocos, nroEsbocos)) {
+            ok = concluirReescrita(binaryFile, temporario, indexFile, antigos, novos, nroPares);
+        } else {
+            ok = false;
+            remove(temporario);
+        }
+    } else if (novo) {
+        remove(temporario);
+    }
+
+    free(esbocos);
+    free(pares);
+    free(antigos);
+    free(novos);
+    free(temporario);
+    return ok ? mantidos : -1;
 }
 
 
+// Compactação incremental automática: desligada por padrão (limiares 0)
+static double limiarRemovidos = 0.0;
+static double limiarLixo = 0.0;
+static int registrosPorPasso = REGISTROS_POR_PASSO_PADRAO;
+
+/**
+ * @brief Configura o disparo automático da compactação incremental.
+ *
+ * Depois de cada remoção ou atualização feita com um índice aberto, um passo de
+ * compactação é executado se nroRegRem / nroRegArq ou a fração de bytes removidos
+ * no arquivo alcançar o limiar correspondente. Um limiar 0 desliga o critério.
+ *
+ * @param razaoRemovidos Limiar de nroRegRem / nroRegArq (0 desliga).
+ * @param razaoLixo Limiar de bytes removidos / bytes de registros (0 desliga).
+ * @param maxRegistros Máximo de registros realocados por passo.
+ */
+void setCompactionThresholds(double razaoRemovidos, double razaoLixo, int maxRegistros) {
+    limiarRemovidos = razaoRemovidos > 0 ? razaoRemovidos : 0.0;
+    limiarLixo = razaoLixo > 0 ? razaoLixo : 0.0;
+    registrosPorPasso = maxRegistros > 0 ? maxRegistros : REGISTROS_POR_PASSO_PADRAO;
+}
+
+/**
+ * @brief Verifica se a fragmentação do arquivo alcançou algum limiar configurado.
+ */
+static bool precisaCompactar(const Header *header, const MapaEspacoLivre *mapa, long long fimArquivo) {
+    if (header->nroRegRem == 0) return false;
+    if (limiarRemovidos > 0 && header->nroRegRem >= limiarRemovidos * header->nroRegArq) return true;
+    long long bytesRegistros = fimArquivo - 276;
+    return limiarLixo > 0 && bytesRegistros > 0 && mapa->bytesLivres >= limiarLixo * bytesRegistros;
+}
+
+/**
+ * @brief Registro visto pela varredura da compactação.
+ */
+typedef struct {
+    long long offset;   // Byte offset do registro
+    long long fim;      // Byte offset do registro seguinte
+    int tamanho;        // Bytes necessários para regravá-lo (só ativos)
+    bool ativo;
+    bool esboco;        // Esboço de registro encaminhado: ocupa o lugar até ser desfeito
+} RegistroCompactacao;
+
+/**
+ * @brief Candidato a realocação, com os bytes ativos da sua região.
+ */
+typedef struct {
+    int registro;       // Posição no vetor da varredura
+    long long ativosRegiao;
+    long long offset;
+} CandidatoCompactacao;
+
+/**
+ * @brief Ordem dos candidatos: regiões mais esparsas primeiro e, nelas, do fim para o início.
+ */
+static int compararCandidatos(const void *a, const void *b) {
+    const CandidatoCompactacao *x = a, *y = b;
+    if (x->ativosRegiao != y->ativosRegiao) return x->ativosRegiao < y->ativosRegiao ? -1 : 1;
+    return (x->offset < y->offset) - (x->offset > y->offset);
+}
+
+/**
+ * @brief Posição do registro de offset dado no vetor da varredura (ordenado por offset).
+ */
+static int buscarRegistroCompactacao(RegistroCompactacao *registros, int n, long long offset) {
+    int lo = 0, hi = n - 1;
+    while (lo <= hi) {
+        int meio = lo + (hi - lo) / 2;
+        if (registros[meio].offset == offset) return meio;
+        if (registros[meio].offset < offset) lo = meio + 1;
+        else hi = meio - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Desfaz os esboços de registros encaminhados vistos pela varredura da compactação.
+ *
+ * Cada esboço para o qual o índice ainda aponta tem a chave redirecionada ao
+ * registro no fim da cadeia; todos os esboços viram removidos comuns. Os
+ * destinos são resolvidos antes de liberar qualquer esboço, porque um esboço
+ * liberado perde o prox para a lista de removidos.
+ *
+ * @param file Arquivo de dados aberto para escrita.
+ * @param header Cabeçalho em memória.
+ * @param mapa Mapa de espaço livre.
+ * @param indice Sessão do índice.
+ * @param registros Registros da varredura (esboco é zerado nos desfeitos).
+ * @param nroRegistros Número de registros da varredura.
+ * @return true em caso de sucesso.
+ */
+static bool desfazerEsbocos(FILE *file, Header *header, MapaEspacoLivre *mapa, SessaoIndice *indice, RegistroCompactacao *registros, int nroRegistros) {
+    int nroEsbocos = 0;
+    for (int i = 0; i < nroRegistros; i++) {
+        if (registros[i].esboco) nroEsbocos++;
+    }
+    if (nroEsbocos == 0) return true;
+
+    long long *destinos = malloc(sizeof(long long) * nroEsbocos);
+    int *ids = malloc(sizeof(int) * nroEsbocos);
+    int *tamanhos = malloc(sizeof(int) * nroEsbocos);
+    if (!destinos || !ids || !tamanhos) {
+        free(destinos);
+        free(ids);
+        free(tamanhos);
+        return false;
+    }
+
+    Record record;
+    for (int i = 0, k = 0; i < nroRegistros; i++) {
+        if (!registros[i].esboco) continue;
+
+        fseek(file, registros[i].offset + sizeof(char), SEEK_SET);
+        if (fread(&tamanhos[k], sizeof(int), 1, file) != 1) tamanhos[k] = -1;
+
+        destinos[k] = registros[i].offset;
+        ids[k] = -1;
+        if (readRecordFollowing(file, &destinos[k], &record)) {
+            ids[k] = record.id;
+            if (record.removido != '0') destinos[k] = -1;
+            liberarCampos(&record);
+        } else {
+            destinos[k] = -1;
+        }
+        k++;
+    }
+
+    for (int i = 0, k = 0; i < nroRegistros; i++) {
+        if (!registros[i].esboco) continue;
+
+        if (destinos[k] != -1 && indice_search(indice, ids[k]) == registros[i].offset) {
+            indice_update_offset(indice, ids[k], destinos[k]);
+        }
+        if (tamanhos[k] > 0) {
+            liberarEsboco(file, header, mapa, registros[i].offset, tamanhos[k]);
+            registros[i].esboco = false;
+        }
+        k++;
+    }
+
+    free(destinos);
+    free(ids);
+    free(tamanhos);
+    return true;
+}
+
+/**
+ * @brief Executa um passo de compactação incremental.
+ *
+ * Uma varredura sequencial mede os bytes ativos de cada região de
+ * TAM_REGIAO_COMPACTACAO bytes. Com um índice aberto, os esboços deixados pelo
+ * modo de encaminhamento são desfeitos primeiro (desfazerEsbocos). Os registros ativos das regiões mais esparsas
+ * (e, nelas, os mais próximos do fim) são realocados para o removido de menor
+ * endereço que os comporte, desde que ele esteja antes do registro, até o limite
+ * do passo; o índice recebe o offset novo e o lugar antigo entra na lista de
+ * removidos. Por fim, os removidos que ficaram depois do último registro ativo
+ * saem da lista e o arquivo é truncado.
+ *
+ * @param soSeNecessario Se verdadeiro, só compacta quando um limiar foi alcançado.
+ * @return Número de registros realocados, -1 em caso de falha.
+ */
+static int passoCompactacao(const char *binaryFile, SessaoIndice *indice, int maxRegistros, bool soSeNecessario) {
+    FILE *file = wal_fopen(binaryFile, "rb+");
+    if (!file) return -1;
+
+    Header header;
+    readHeader(file, &header);
+    if (header.status != '1') {
+        fclose(file);
+        return -1;
+    }
+
+    MapaEspacoLivre *mapa = mapa_obter(file, binaryFile, &header);
+    if (!mapa) {
+        fclose(file);
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long long fimArquivo = ftell(file);
+    if (soSeNecessario && !precisaCompactar(&header, mapa, fimArquivo)) {
+        mapa_liberar(mapa);
+        fclose(file);
+        return 0;
+    }
+
+    // Varredura: offsets, extensão real e tamanho necessário de cada registro
+    int capacidade = header.nroRegArq + header.nroRegRem + 1;
+    RegistroCompactacao *registros = malloc(sizeof(RegistroCompactacao) * capacidade);
+    int nroRegistros = 0;
+    bool ok = registros != NULL;
+
+    Record record;
+    long long recordOffset = 276;
+    fseek(file, recordOffset, SEEK_SET);
+    while (ok && readRecord(file, &record)) {
+        if (nroRegistros == capacidade) {
+            capacidade *= 2;
+            RegistroCompactacao *maior = realloc(registros, sizeof(RegistroCompactacao) * capacidade);
+            if (maior) registros = maior;
+            ok = maior != NULL;
+        }
+        if (ok) {
+            RegistroCompactacao *r = &registros[nroRegistros++];
+            r->offset = recordOffset;
+            r->fim = ftell(file);
+            r->ativo = record.removido == '0';
+            r->esboco = record.removido == REGISTRO_ENCAMINHADO;
+            r->tamanho = r->ativo ? tamanhoRegistroNovo(&record) : 0;
+            recordOffset = r->fim;
+        }
+
+        free(record.country);
+        free(record.attackType);
+        free(record.targetIndustry);
+        free(record.defenseStrategy);
+    }
+    // Só trunca se a varredura chegou ao fim do arquivo
+    bool varreduraCompleta = ok && feof(file);
+
+    // Bytes ativos por região
+    int nroRegioes = (int)((fimArquivo - 276) / TAM_REGIAO_COMPACTACAO) + 1;
+    long long *ativosRegiao = calloc(nroRegioes, sizeof(long long));
+    CandidatoCompactacao *candidatos = malloc(sizeof(CandidatoCompactacao) * (nroRegistros > 0 ? nroRegistros : 1));
+    int nroCandidatos = 0;
+    ok = ok && ativosRegiao && candidatos;
+
+    if (ok) {
+        for (int i = 0; i < nroRegistros; i++) {
+            if (registros[i].ativo) {
+                ativosRegiao[(registros[i].offset - 276) / TAM_REGIAO_COMPACTACAO] += registros[i].fim - registros[i].offset;
+            }
+        }
+        for (int i = 0; i < nroRegistros; i++) {
+            if (!registros[i].ativo) continue;
+            candidatos[nroCandidatos].registro = i;
+            candidatos[nroCandidatos].ativosRegiao = ativosRegiao[(registros[i].offset - 276) / TAM_REGIAO_COMPACTACAO];
+            candidatos[nroCandidatos].offset = registros[i].offset;
+            nroCandidatos++;
+        }
+        qsort(candidatos, nroCandidatos, sizeof(CandidatoCompactacao), compararCandidatos);
+    }
+
+    // Marca o arquivo como inconsistente até o cabeçalho final ser gravado
+    char status = '0';
+    fseek(file, 0, SEEK_SET);
+    fwrite(&status, sizeof(char), 1, file);
+
+    // Esboços são desfeitos antes: o espaço deles também recebe registros
+    if (ok && indice) {
+        ok = desfazerEsbocos(file, &header, mapa, indice, registros, nroRegistros);
+    }
+
+    int movidos = 0;
+    for (int c = 0; ok && c < nroCandidatos && movidos < maxRegistros; c++) {
+        RegistroCompactacao *r = &registros[candidatos[c].registro];
+        NoEspacoLivre *no = mapa_escolher(mapa, r->tamanho, POLITICA_MENOR_ENDERECO);
+        if (!no || no->offset >= r->offset) continue;
+
+        fseek(file, r->offset, SEEK_SET);
+        if (!readRecord(file, &record)) continue;
+
+        int tamanhoAntigo = record.tamanhoRegistro;
+        record.removido = '0';
+        record.prox = -1;
+        long long destino = gravarEmRemovido(file, &header, mapa, no, &record);
+        if (indice) {
+            indice_update_offset(indice, record.id, destino);
+        }
+        marcarRemovido(file, &header, mapa, r->offset, tamanhoAntigo);
+
+        free(record.country);
+        free(record.attackType);
+        free(record.targetIndustry);
+        free(record.defenseStrategy);
+
+        int d = buscarRegistroCompactacao(registros, nroRegistros, destino);
+        if (d >= 0) registros[d].ativo = true;
+        r->ativo = false;
+        movidos++;
+    }
+
+    // Removidos depois do último registro ativo (ou esboço ainda apontado) saem da lista e do arquivo
+    if (varreduraCompleta) {
+        long long novoFim = 276;
+        for (int i = 0; i < nroRegistros; i++) {
+            if ((registros[i].ativo || registros[i].esboco) && registros[i].fim > novoFim) novoFim = registros[i].fim;
+        }
+
+        if (novoFim < fimArquivo) {
+            NoEspacoLivre *no = mapa->inicio;
+            while (no) {
+                NoEspacoLivre *proximo = no->proximo;
+                if (no->offset >= novoFim) {
+                    mapa_retirar(mapa, no, file, &header);
+                    header.nroRegRem--;
+                }
+                no = proximo;
+            }
+            // Dentro de um lote, o truncamento vai ao log e chega ao arquivo no checkpoint
+            fflush(file);
+            if (wal_truncar(binaryFile, novoFim)) {
+                header.proxByteOffset = novoFim;
+            }
+        }
+    }
+
+    header.status = '1';
+    updateHeader(file, &header);
+    fclose(file);
+
+    mapa_salvar(mapa, binaryFile, &header);
+    mapa_liberar(mapa);
+    free(registros);
+    free(ativosRegiao);
+    free(candidatos);
+    return ok ? movidos : -1;
+}
+
+/**
+ * @brief Executa um passo de compactação incremental, independentemente dos limiares.
+ *
+ * @param binaryFile Caminho para o arquivo binário.
+ * @param indice Sessão do índice (árvore-B ou hash) que recebe os offsets novos.
+ * @param maxRegistros Máximo de registros realocados.
+ * @return Número de registros realocados, -1 em caso de falha.
+ */
+int compactDataFileStep(const char *binaryFile, SessaoIndice *indice, int maxRegistros) {
+    return passoCompactacao(binaryFile, indice, maxRegistros, false);
+}
+
+/**
+ * @brief Executa um passo de compactação se algum limiar configurado foi alcançado.
+ *
+ * Sem índice aberto não há compactação: os offsets realocados não teriam
+ * como ser corrigidos.
+ *
+ * @param binaryFile Caminho para o arquivo binário.
+ * @param indice Sessão do índice (árvore-B ou hash) que recebe os offsets novos.
+ * @return Número de registros realocados, -1 em caso de falha.
+ */
+int compactDataFileIfNeeded(const char *binaryFile, SessaoIndice *indice) {
+    if (!indice || (limiarRemovidos == 0 && limiarLixo == 0)) return 0;
+    return passoCompactacao(binaryFile, indice, registrosPorPasso, true);
+}
+
 void printRecordFromOffset(const char *fileName, long long offset) {
-    FILE *file = fopen(fileName, "rb");
+    FILE *file = wal_fopen(fileName, "rb");
     if (!file) {
         printf("Erro ao abrir o arquivo: %s\n", fileName);
         return;
@@ -1,16 +1,51 @@
 #ifndef BINARY_OPERATIONS_H
 #define BINARY_OPERATIONS_H
 
+#include <stdbool.h>
 #include "record.h"
 #include "header.h"
 #include "utils.h"
+#include "indice.h"
+#include "espaco-livre.h"
 
+#define TAM_BUFFER_SESSAO (64 * 1024)   // Buffer de escrita da sessão de inserção
+#define TAM_REGIAO_COMPACTACAO 4096     // Granularidade da medida de esparsidade na compactação incremental
+#define REGISTROS_POR_PASSO_PADRAO 64   // Registros realocados por passo de compactação automática
+#define DISTANCIA_MAX_VIZINHO (64 * 1024)  // Distância até o vizinho em que um removido tem preferência na inserção
+#define TAM_MEMORIA_AGRUPAMENTO (8 * 1024 * 1024)  // Bytes de registros ordenados em memória por corrida do agrupamento
+#define MAX_CORRIDAS_INTERCALACAO 16    // Corridas abertas ao mesmo tempo em cada intercalação do agrupamento
+
+/**
+ * @brief Sessão de inserção: arquivo aberto uma vez, cabeçalho e mapa de espaço livre em memória
+ */
+typedef struct {
+    FILE *file;                  // Arquivo de dados aberto em modo "rb+"
+    char *nomeArquivo;           // Nome do arquivo de dados (para o mapa .fsm)
+    Header header;               // Cabeçalho mantido em memória
+    MapaEspacoLivre *mapa;       // Mapa de espaço livre mantido durante a sessão
+    long long fimArquivo;        // Byte offset do fim do arquivo
+    bool acrescentando;          // Última escrita foi um acréscimo terminado em fimArquivo
+} SessaoInsercao;
+
+void setGrowthSlack(double percentual, int bytes);
+void getUpdateStats(long long *noLugar, long long *realocados);
 int generateBinaryFile(const char *inputFile, char *binaryFile);
 void printAllUntilId(const char *binaryFile);
 void sequentialSearch(const char *binaryFile, int numCriteria, char criteria[3][256], char values[3][256]);
-int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteria[3][256], char values[3][256]);
+int deleteRecordByCriteria(const char *binaryFile, int numCriteria, char criteria[3][256], char values[3][256], SessaoIndice *indice);
+void setAllocationPolicy(int policy);
+void setForwarding(bool ativo);
 long long insertRecord(const char *binaryFile, int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy);
-int updateRecords(const char *binaryFile, int numUpdates, int numCriteria, char criteria[3][256], char values[3][256], int numUpdatesFields, char updateFields[3][256], char updateValues[3][256], const char *btreeFile, int useBTree);
+SessaoInsercao *openInsertSession(const char *binaryFile);
+long long insertRecordInSession(SessaoInsercao *sessao, int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy);
+long long insertRecordNearInSession(SessaoInsercao *sessao, long long vizinho, int id, int year, float financialLoss, const char *country, const char *attackType, const char *targetIndustry, const char *defenseStrategy);
+int closeInsertSession(SessaoInsercao *sessao);
+int updateRecords(const char *binaryFile, int numUpdates, int numCriteria, char criteria[3][256], char values[3][256], int numUpdatesFields, char updateFields[3][256], char updateValues[3][256], SessaoIndice *indice);
+int vacuumDataFile(const char *binaryFile, const char *indexFile);
+int clusterDataFile(const char *binaryFile, const char *indexFile);
+void setCompactionThresholds(double razaoRemovidos, double razaoLixo, int maxRegistros);
+int compactDataFileStep(const char *binaryFile, SessaoIndice *indice, int maxRegistros);
+int compactDataFileIfNeeded(const char *binaryFile, SessaoIndice *indice);
 void printRecordFromOffset(const char *fileName, long long offset);
 
 
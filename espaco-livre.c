@@ -0,0 +1,446 @@
+/**
+ * @file espaco-livre.c
+ * @brief Implementação do mapa de espaço livre do arquivo de dados
+ *
+ * O mapa é montado uma vez a partir de header.topo e mantido junto com a
+ * lista do disco: cada retirada regrava apenas o prox do removido anterior
+ * (ou o topo), que o mapa já conhece.
+ *
+ * Formato de "<dados>.fsm": identificador "FSM1", topo e nroRegRem do
+ * cabeçalho de dados, número de removidos e, ordenadas por tamanho, as
+ * entradas (offset, tamanho, prox, posição na lista do disco).
+ */
+
+#include "espaco-livre.h"
+#include "wal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ================= FUNÇÕES AUXILIARES =================
+
+/**
+ * @brief Classe de tamanho: posição do bit mais significativo
+ */
+static int classeDoTamanho(int tamanho) {
+    int classe = 0;
+    while (tamanho > 1 && classe < NRO_CLASSES_ESPACO - 1) {
+        tamanho >>= 1;
+        classe++;
+    }
+    return classe;
+}
+
+/**
+ * @brief Acrescenta o nó ao final da lista do disco e da sua classe
+ */
+static void anexarNo(MapaEspacoLivre *mapa, NoEspacoLivre *no) {
+    no->anterior = mapa->fim;
+    no->proximo = NULL;
+    if (mapa->fim) mapa->fim->proximo = no;
+    else mapa->inicio = no;
+    mapa->fim = no;
+
+    no->anteriorClasse = mapa->fimClasses[no->classe];
+    no->proximoClasse = NULL;
+    if (mapa->fimClasses[no->classe]) mapa->fimClasses[no->classe]->proximoClasse = no;
+    else mapa->classes[no->classe] = no;
+    mapa->fimClasses[no->classe] = no;
+
+    mapa->nroLivres++;
+    mapa->bytesLivres += no->tamanho;
+}
+
+/**
+ * @brief Desliga o nó das listas em memória (não altera o disco)
+ */
+static void desligarNo(MapaEspacoLivre *mapa, NoEspacoLivre *no) {
+    if (no->anterior) no->anterior->proximo = no->proximo;
+    else mapa->inicio = no->proximo;
+    if (no->proximo) no->proximo->anterior = no->anterior;
+    else mapa->fim = no->anterior;
+
+    if (no->anteriorClasse) no->anteriorClasse->proximoClasse = no->proximoClasse;
+    else mapa->classes[no->classe] = no->proximoClasse;
+    if (no->proximoClasse) no->proximoClasse->anteriorClasse = no->anteriorClasse;
+    else mapa->fimClasses[no->classe] = no->anteriorClasse;
+
+    mapa->nroLivres--;
+    mapa->bytesLivres -= no->tamanho;
+}
+
+/**
+ * @brief Nome do arquivo do mapa: "<dados>.fsm"
+ */
+static char *nomeArquivoMapa(const char *binaryFile) {
+    size_t tamanho = strlen(binaryFile) + 5;
+    char *nome = malloc(tamanho);
+    if (nome) snprintf(nome, tamanho, "%s.fsm", binaryFile);
+    return nome;
+}
+
+/**
+ * @brief Ordem das entradas no arquivo: tamanho e, no empate, posição na lista
+ */
+static int compararPorTamanho(const void *a, const void *b) {
+    const NoEspacoLivre *x = *(NoEspacoLivre * const *)a;
+    const NoEspacoLivre *y = *(NoEspacoLivre * const *)b;
+    if (x->tamanho != y->tamanho) return x->tamanho < y->tamanho ? -1 : 1;
+    return x->ordem < y->ordem ? -1 : (x->ordem > y->ordem);
+}
+
+// ================= FUNÇÕES PRINCIPAIS =================
+
+MapaEspacoLivre *mapa_construir(FILE *file, long long topo) {
+    MapaEspacoLivre *mapa = calloc(1, sizeof(MapaEspacoLivre));
+    if (!mapa) return NULL;
+
+    long long offset = topo;
+    long long ordem = 0;
+
+    while (offset != -1) {
+        char removido;
+        int tamanho;
+        long long prox;
+
+        // Apenas o prefixo fixo; os campos do registro morto não interessam
+        if (fseek(file, offset, SEEK_SET) != 0 ||
+            fread(&removido, sizeof(char), 1, file) != 1 ||
+            fread(&tamanho, sizeof(int), 1, file) != 1 ||
+            fread(&prox, sizeof(long long), 1, file) != 1) {
+            break;
+        }
+
+        NoEspacoLivre *no = malloc(sizeof(NoEspacoLivre));
+        if (!no) {
+            mapa_liberar(mapa);
+            return NULL;
+        }
+        no->offset = offset;
+        no->tamanho = tamanho;
+        no->prox = prox;
+        no->ordem = ordem++;
+        no->classe = classeDoTamanho(tamanho);
+        anexarNo(mapa, no);
+
+        offset = prox;
+    }
+
+    return mapa;
+}
+
+void mapa_liberar(MapaEspacoLivre *mapa) {
+    if (!mapa) return;
+    NoEspacoLivre *no = mapa->inicio;
+    while (no) {
+        NoEspacoLivre *proximo = no->proximo;
+        free(no);
+        no = proximo;
+    }
+    free(mapa);
+}
+
+NoEspacoLivre *mapa_primeiro_que_cabe(MapaEspacoLivre *mapa, int tamanho) {
+    if (!mapa) return NULL;
+
+    int classe = classeDoTamanho(tamanho);
+    NoEspacoLivre *melhor = NULL;
+
+    // Na própria classe os tamanhos variam: o primeiro que cabe, em ordem
+    for (NoEspacoLivre *no = mapa->classes[classe]; no; no = no->proximoClasse) {
+        if (no->tamanho >= tamanho) {
+            melhor = no;
+            break;
+        }
+    }
+
+    // Nas classes acima qualquer nó cabe: basta comparar as cabeças
+    for (int c = classe + 1; c < NRO_CLASSES_ESPACO; c++) {
+        NoEspacoLivre *no = mapa->classes[c];
+        if (no && (!melhor || no->ordem < melhor->ordem)) {
+            melhor = no;
+        }
+    }
+
+    return melhor;
+}
+
+/**
+ * @brief Menor removido que cabe: a própria classe e, se vazia, a primeira classe acima
+ */
+static NoEspacoLivre *melhorQueCabe(MapaEspacoLivre *mapa, int tamanho) {
+    for (int c = classeDoTamanho(tamanho); c < NRO_CLASSES_ESPACO; c++) {
+        NoEspacoLivre *melhor = NULL;
+        for (NoEspacoLivre *no = mapa->classes[c]; no; no = no->proximoClasse) {
+            if (no->tamanho >= tamanho && (!melhor || no->tamanho < melhor->tamanho)) {
+                melhor = no;
+            }
+        }
+        // Qualquer nó de uma classe acima é maior que os desta
+        if (melhor) return melhor;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Maior removido: procura apenas na classe mais alta ocupada
+ */
+static NoEspacoLivre *piorQueCabe(MapaEspacoLivre *mapa, int tamanho) {
+    for (int c = NRO_CLASSES_ESPACO - 1; c >= 0; c--) {
+        if (!mapa->classes[c]) continue;
+        NoEspacoLivre *pior = NULL;
+        for (NoEspacoLivre *no = mapa->classes[c]; no; no = no->proximoClasse) {
+            if (!pior || no->tamanho > pior->tamanho) {
+                pior = no;
+            }
+        }
+        return pior->tamanho >= tamanho ? pior : NULL;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Primeiro que cabe na própria classe; senão, a cabeça da menor classe acima
+ */
+static NoEspacoLivre *segregadoQueCabe(MapaEspacoLivre *mapa, int tamanho) {
+    int classe = classeDoTamanho(tamanho);
+    for (NoEspacoLivre *no = mapa->classes[classe]; no; no = no->proximoClasse) {
+        if (no->tamanho >= tamanho) return no;
+    }
+    for (int c = classe + 1; c < NRO_CLASSES_ESPACO; c++) {
+        if (mapa->classes[c]) return mapa->classes[c];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Removido de menor byte offset que cabe
+ */
+static NoEspacoLivre *menorEnderecoQueCabe(MapaEspacoLivre *mapa, int tamanho) {
+    NoEspacoLivre *menor = NULL;
+    for (NoEspacoLivre *no = mapa->inicio; no; no = no->proximo) {
+        if (no->tamanho >= tamanho && (!menor || no->offset < menor->offset)) {
+            menor = no;
+        }
+    }
+    return menor;
+}
+
+NoEspacoLivre *mapa_mais_proximo(MapaEspacoLivre *mapa, int tamanho, long long alvo, long long distanciaMax) {
+    if (!mapa || alvo < 0) return NULL;
+
+    NoEspacoLivre *escolhido = NULL;
+    long long menorDistancia = distanciaMax + 1;
+    for (NoEspacoLivre *no = mapa->inicio; no; no = no->proximo) {
+        long long distancia = no->offset > alvo ? no->offset - alvo : alvo - no->offset;
+        if (no->tamanho >= tamanho && distancia < menorDistancia) {
+            escolhido = no;
+            menorDistancia = distancia;
+        }
+    }
+    return escolhido;
+}
+
+NoEspacoLivre *mapa_escolher(MapaEspacoLivre *mapa, int tamanho, int politica) {
+    if (!mapa) return NULL;
+
+    switch (politica) {
+        case POLITICA_MELHOR:
+            return melhorQueCabe(mapa, tamanho);
+        case POLITICA_PIOR:
+            return piorQueCabe(mapa, tamanho);
+        case POLITICA_SEGREGADA:
+            return segregadoQueCabe(mapa, tamanho);
+        case POLITICA_MENOR_ENDERECO:
+            return menorEnderecoQueCabe(mapa, tamanho);
+        default:
+            return mapa_primeiro_que_cabe(mapa, tamanho);
+    }
+}
+
+const char *mapa_nome_politica(int politica) {
+    switch (politica) {
+        case POLITICA_MELHOR: return "best-fit";
+        case POLITICA_PIOR: return "worst-fit";
+        case POLITICA_SEGREGADA: return "segregated-fit";
+        case POLITICA_MENOR_ENDERECO: return "lowest-address";
+        default: return "first-fit";
+    }
+}
+
+void mapa_retirar(MapaEspacoLivre *mapa, NoEspacoLivre *no, FILE *file, Header *header) {
+    // Religa a lista do disco sem percorrê-la: o anterior já é conhecido
+    if (no->anterior) {
+        no->anterior->prox = no->prox;
+        fseek(file, no->anterior->offset + sizeof(char) + sizeof(int), SEEK_SET);
+        fwrite(&no->prox, sizeof(long long), 1, file);
+    } else {
+        header->topo = no->prox;
+    }
+
+    desligarNo(mapa, no);
+    free(no);
+}
+
+void mapa_empilhar(MapaEspacoLivre *mapa, long long offset, int tamanho) {
+    if (!mapa) return;
+
+    NoEspacoLivre *no = malloc(sizeof(NoEspacoLivre));
+    if (!no) return;
+    no->offset = offset;
+    no->tamanho = tamanho;
+    no->prox = mapa->inicio ? mapa->inicio->offset : -1;
+    no->ordem = mapa->inicio ? mapa->inicio->ordem - 1 : 0;
+    no->classe = classeDoTamanho(tamanho);
+
+    // Novo topo: primeiro na lista do disco e na sua classe
+    no->anterior = NULL;
+    no->proximo = mapa->inicio;
+    if (mapa->inicio) mapa->inicio->anterior = no;
+    else mapa->fim = no;
+    mapa->inicio = no;
+
+    no->anteriorClasse = NULL;
+    no->proximoClasse = mapa->classes[no->classe];
+    if (mapa->classes[no->classe]) mapa->classes[no->classe]->anteriorClasse = no;
+    else mapa->fimClasses[no->classe] = no;
+    mapa->classes[no->classe] = no;
+
+    mapa->nroLivres++;
+    mapa->bytesLivres += tamanho;
+}
+
+// ================= ARQUIVO DO MAPA =================
+
+MapaEspacoLivre *mapa_carregar(const char *binaryFile, Header *header) {
+    char *nome = nomeArquivoMapa(binaryFile);
+    if (!nome) return NULL;
+    FILE *fp = wal_fopen(nome, "rb");
+    free(nome);
+    if (!fp) return NULL;
+
+    // Uma única leitura do arquivo inteiro
+    fseek(fp, 0, SEEK_END);
+    long tamanhoArquivo = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char *buffer = tamanhoArquivo >= TAM_CABECALHO_MAPA ? malloc(tamanhoArquivo) : NULL;
+    if (!buffer || fread(buffer, 1, tamanhoArquivo, fp) != (size_t)tamanhoArquivo) {
+        free(buffer);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+
+    long long topo;
+    int nroRegRem, nroLivres;
+    memcpy(&topo, buffer + 4, sizeof(long long));
+    memcpy(&nroRegRem, buffer + 12, sizeof(int));
+    memcpy(&nroLivres, buffer + 16, sizeof(int));
+
+    // Assinatura e tamanho precisam conferir com o cabeçalho de dados
+    if (memcmp(buffer, IDENTIFICADOR_MAPA, 4) != 0 || topo != header->topo ||
+        nroRegRem != header->nroRegRem || nroLivres < 0 ||
+        tamanhoArquivo != TAM_CABECALHO_MAPA + (long)nroLivres * TAM_ENTRADA_MAPA) {
+        free(buffer);
+        return NULL;
+    }
+
+    MapaEspacoLivre *mapa = calloc(1, sizeof(MapaEspacoLivre));
+    NoEspacoLivre **porPosicao = calloc(nroLivres > 0 ? nroLivres : 1, sizeof(NoEspacoLivre *));
+    bool valido = mapa && porPosicao;
+
+    for (int i = 0; valido && i < nroLivres; i++) {
+        unsigned char *entrada = buffer + TAM_CABECALHO_MAPA + (long)i * TAM_ENTRADA_MAPA;
+        NoEspacoLivre *no = malloc(sizeof(NoEspacoLivre));
+        if (!no) {
+            valido = false;
+            break;
+        }
+        int posicao;
+        memcpy(&no->offset, entrada, sizeof(long long));
+        memcpy(&no->tamanho, entrada + 8, sizeof(int));
+        memcpy(&no->prox, entrada + 12, sizeof(long long));
+        memcpy(&posicao, entrada + 20, sizeof(int));
+        if (posicao < 0 || posicao >= nroLivres || porPosicao[posicao]) {
+            free(no);
+            valido = false;
+            break;
+        }
+        no->ordem = posicao;
+        no->classe = classeDoTamanho(no->tamanho);
+        porPosicao[posicao] = no;
+    }
+
+    // As entradas precisam formar exatamente a lista que começa em topo
+    for (int i = 0; valido && i < nroLivres; i++) {
+        long long esperado = i == 0 ? header->topo : porPosicao[i - 1]->prox;
+        if (porPosicao[i]->offset != esperado) valido = false;
+    }
+    if (valido && (nroLivres == 0 ? header->topo != -1 : porPosicao[nroLivres - 1]->prox != -1)) {
+        valido = false;
+    }
+
+    for (int i = 0; i < nroLivres && porPosicao; i++) {
+        if (!porPosicao[i]) continue;
+        if (valido) anexarNo(mapa, porPosicao[i]);
+        else free(porPosicao[i]);
+    }
+
+    free(porPosicao);
+    free(buffer);
+    if (!valido) {
+        free(mapa);
+        return NULL;
+    }
+    return mapa;
+}
+
+bool mapa_salvar(MapaEspacoLivre *mapa, const char *binaryFile, Header *header) {
+    if (!mapa) return false;
+
+    long tamanho = TAM_CABECALHO_MAPA + (long)mapa->nroLivres * TAM_ENTRADA_MAPA;
+    unsigned char *buffer = malloc(tamanho);
+    NoEspacoLivre **nos = malloc((mapa->nroLivres > 0 ? mapa->nroLivres : 1) * sizeof(NoEspacoLivre *));
+    char *nome = nomeArquivoMapa(binaryFile);
+    if (!buffer || !nos || !nome) {
+        free(buffer);
+        free(nos);
+        free(nome);
+        return false;
+    }
+
+    // Posições renumeradas a partir de 0 na ordem da lista do disco
+    int n = 0;
+    for (NoEspacoLivre *no = mapa->inicio; no; no = no->proximo) {
+        no->ordem = n;
+        nos[n++] = no;
+    }
+    qsort(nos, n, sizeof(NoEspacoLivre *), compararPorTamanho);
+
+    memcpy(buffer, IDENTIFICADOR_MAPA, 4);
+    memcpy(buffer + 4, &header->topo, sizeof(long long));
+    memcpy(buffer + 12, &header->nroRegRem, sizeof(int));
+    memcpy(buffer + 16, &n, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        unsigned char *entrada = buffer + TAM_CABECALHO_MAPA + (long)i * TAM_ENTRADA_MAPA;
+        int posicao = (int)nos[i]->ordem;
+        memcpy(entrada, &nos[i]->offset, sizeof(long long));
+        memcpy(entrada + 8, &nos[i]->tamanho, sizeof(int));
+        memcpy(entrada + 12, &nos[i]->prox, sizeof(long long));
+        memcpy(entrada + 20, &posicao, sizeof(int));
+    }
+
+    FILE *fp = wal_fopen(nome, "wb");
+    bool ok = fp && fwrite(buffer, 1, tamanho, fp) == (size_t)tamanho;
+    if (fp && fclose(fp) != 0) ok = false;
+    if (!ok) remove(nome);
+
+    free(buffer);
+    free(nos);
+    free(nome);
+    return ok;
+}
+
+MapaEspacoLivre *mapa_obter(FILE *file, const char *binaryFile, Header *header) {
+    MapaEspacoLivre *mapa = mapa_carregar(binaryFile, header);
+    return mapa ? mapa : mapa_construir(file, header->topo);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file espaco-livre.h
+ * @brief Mapa em memória dos registros removidos do arquivo de dados
+ *
+ * Espelha a lista de removidos do disco (header.topo -> prox -> ...) lendo
+ * apenas o prefixo fixo de 13 bytes de cada registro (removido,
+ * tamanhoRegistro, prox). Além da lista na ordem do disco, cada nó fica
+ * em uma classe de tamanho (potências de 2), na mesma ordem, de modo que
+ * o primeiro registro que cabe (first-fit sobre a lista do disco) é
+ * encontrado olhando a cabeça de cada classe, sem percorrer a lista.
+ *
+ * O mapa pode ser guardado em "<dados>.fsm", com a assinatura (topo,
+ * nroRegRem) do cabeçalho de dados; uma cópia cuja assinatura não confere
+ * é descartada e o mapa é remontado pela lista do disco.
+ */
+
+#ifndef ESPACO_LIVRE_H
+#define ESPACO_LIVRE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "header.h"
+
+#define NRO_CLASSES_ESPACO 32
+#define TAM_PREFIXO_REGISTRO 13   // removido (1) + tamanhoRegistro (4) + prox (8)
+
+// Políticas de reaproveitamento de espaço (todas mantêm a lista do disco compatível)
+#define POLITICA_PRIMEIRO 0         // Primeiro que cabe na ordem da lista (padrão)
+#define POLITICA_MELHOR 1           // Menor removido que cabe
+#define POLITICA_PIOR 2             // Maior removido
+#define POLITICA_SEGREGADA 3        // Primeiro que cabe na própria classe, senão a menor classe acima
+#define POLITICA_MENOR_ENDERECO 4   // Removido de menor byte offset que cabe
+#define NRO_POLITICAS 5
+
+#define IDENTIFICADOR_MAPA "FSM1"
+#define TAM_CABECALHO_MAPA 20     // identificador (4) + topo (8) + nroRegRem (4) + nroLivres (4)
+#define TAM_ENTRADA_MAPA 24       // offset (8) + tamanho (4) + prox (8) + posição na lista (4)
+
+/**
+ * @brief Registro removido conhecido pelo mapa
+ */
+typedef struct NoEspacoLivre {
+    long long offset;                        // Byte offset do registro removido
+    int tamanho;                             // tamanhoRegistro
+    long long prox;                          // Próximo removido na lista do disco
+    long long ordem;                         // Posição na lista do disco (menor = mais perto do topo)
+    int classe;                              // Classe de tamanho
+    struct NoEspacoLivre *anterior;          // Vizinhos na lista do disco
+    struct NoEspacoLivre *proximo;
+    struct NoEspacoLivre *anteriorClasse;    // Vizinhos na classe, na mesma ordem
+    struct NoEspacoLivre *proximoClasse;
+} NoEspacoLivre;
+
+/**
+ * @brief Mapa de espaço livre do arquivo de dados
+ */
+typedef struct {
+    NoEspacoLivre *inicio;                          // Nó apontado por header.topo
+    NoEspacoLivre *fim;                             // Último nó da lista do disco
+    NoEspacoLivre *classes[NRO_CLASSES_ESPACO];     // Primeiro nó de cada classe
+    NoEspacoLivre *fimClasses[NRO_CLASSES_ESPACO];  // Último nó de cada classe
+    int nroLivres;                                  // Número de registros removidos no mapa
+    long long bytesLivres;                          // Soma dos tamanhos
+} MapaEspacoLivre;
+
+/**
+ * @brief Monta o mapa percorrendo a lista de removidos a partir de topo
+ * @param file Arquivo de dados aberto
+ * @param topo Byte offset do primeiro removido (header.topo)
+ * @return Mapa criado ou NULL em caso de falha de memória
+ */
+MapaEspacoLivre *mapa_construir(FILE *file, long long topo);
+
+/**
+ * @brief Carrega o mapa de "<dados>.fsm" se ele estiver em dia com o cabeçalho
+ * @param binaryFile Nome do arquivo de dados
+ * @param header Cabeçalho atual do arquivo de dados
+ * @return Mapa carregado ou NULL se ausente, desatualizado ou inconsistente
+ */
+MapaEspacoLivre *mapa_carregar(const char *binaryFile, Header *header);
+
+/**
+ * @brief Grava o mapa em "<dados>.fsm", ordenado por tamanho
+ *
+ * Dentro de um lote, o arquivo vai pelo log no mesmo grupo do arquivo de dados.
+ *
+ * @param mapa Mapa
+ * @param binaryFile Nome do arquivo de dados
+ * @param header Cabeçalho que o arquivo de dados terá ao ser fechado
+ * @return true se gravado com sucesso
+ */
+bool mapa_salvar(MapaEspacoLivre *mapa, const char *binaryFile, Header *header);
+
+/**
+ * @brief Carrega o mapa salvo ou, se não houver um em dia, monta-o pela lista do disco
+ * @param file Arquivo de dados aberto
+ * @param binaryFile Nome do arquivo de dados
+ * @param header Cabeçalho atual do arquivo de dados
+ * @return Mapa ou NULL em caso de falha de memória
+ */
+MapaEspacoLivre *mapa_obter(FILE *file, const char *binaryFile, Header *header);
+
+/**
+ * @brief Libera o mapa
+ * @param mapa Mapa (pode ser NULL)
+ */
+void mapa_liberar(MapaEspacoLivre *mapa);
+
+/**
+ * @brief Primeiro removido, na ordem da lista do disco, com tamanho >= tamanho
+ * @param mapa Mapa
+ * @param tamanho Tamanho necessário
+ * @return Nó encontrado ou NULL se nenhum couber
+ */
+NoEspacoLivre *mapa_primeiro_que_cabe(MapaEspacoLivre *mapa, int tamanho);
+
+/**
+ * @brief Escolhe o removido que receberá um registro segundo a política
+ * @param mapa Mapa
+ * @param tamanho Tamanho necessário
+ * @param politica Uma das constantes POLITICA_*
+ * @return Nó escolhido ou NULL se nenhum couber
+ */
+NoEspacoLivre *mapa_escolher(MapaEspacoLivre *mapa, int tamanho, int politica);
+
+/**
+ * @brief Removido que cabe mais próximo de um byte offset
+ * @param mapa Mapa
+ * @param tamanho Tamanho necessário
+ * @param alvo Byte offset de referência (negativo: nenhum)
+ * @param distanciaMax Maior distância aceita entre o removido e o alvo
+ * @return Nó encontrado ou NULL se nenhum couber dentro da distância
+ */
+NoEspacoLivre *mapa_mais_proximo(MapaEspacoLivre *mapa, int tamanho, long long alvo, long long distanciaMax);
+
+/**
+ * @brief Nome legível da política
+ * @param politica Uma das constantes POLITICA_*
+ * @return Nome da política
+ */
+const char *mapa_nome_politica(int politica);
+
+/**
+ * @brief Retira um nó do mapa e da lista do disco
+ *
+ * Regrava o prox do removido anterior ou, se o nó era o primeiro,
+ * atualiza header->topo (em memória). O nó é liberado.
+ *
+ * @param mapa Mapa
+ * @param no Nó a retirar
+ * @param file Arquivo de dados aberto para escrita
+ * @param header Cabeçalho em memória
+ */
+void mapa_retirar(MapaEspacoLivre *mapa, NoEspacoLivre *no, FILE *file, Header *header);
+
+/**
+ * @brief Registra um registro recém-removido no topo da lista
+ *
+ * Não altera o disco: quem remove grava prox = antigo topo no registro e
+ * atualiza header.topo.
+ *
+ * @param mapa Mapa
+ * @param offset Byte offset do registro removido
+ * @param tamanho tamanhoRegistro
+ */
+void mapa_empilhar(MapaEspacoLivre *mapa, long long offset, int tamanho);
+
+#endif // ESPACO_LIVRE_H
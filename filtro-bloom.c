@@ -0,0 +1,316 @@
+/**
+ * @file filtro-bloom.c
+ * @brief Implementação do filtro de Bloom com contadores do índice árvore-B
+ *
+ * Formato de "<índice>.bloom": identificador "BLM1", assinatura do
+ * cabeçalho do índice (noRaiz, proxRRN, nroNos, topoLivres), número de
+ * contadores, número de hashes, número de chaves e, por fim, um byte por
+ * contador.
+ */
+
+#include "filtro-bloom.h"
+#include "wal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+#define BLOOM_IDENTIFICADOR "BLM1"
+#define BLOOM_TAM_CABECALHO (4 + 7 * (int)sizeof(int))
+
+/**
+ * @brief Embaralha os bits de um inteiro (finalizador do MurmurHash3)
+ */
+static uint32_t misturar(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Posição do i-ésimo contador da chave (hash duplo)
+ */
+static int posicaoContador(int nroContadores, int id, int i) {
+    uint32_t h1 = misturar((uint32_t)id);
+    uint32_t h2 = misturar((uint32_t)id ^ 0x9e3779b9u) | 1u;
+    return (int)((h1 + (uint32_t)i * h2) & (uint32_t)(nroContadores - 1));
+}
+
+/**
+ * @brief Monta o nome "<índice>.bloom"
+ * @return Nome alocado dinamicamente ou NULL
+ */
+static char *nomeArquivoFiltro(const char *btreeFilename) {
+    char *nome = malloc(strlen(btreeFilename) + 7);
+    if (nome) sprintf(nome, "%s.bloom", btreeFilename);
+    return nome;
+}
+
+/**
+ * @brief Lê e valida o cabeçalho do arquivo do filtro
+ * @return true se o filtro corresponde ao cabeçalho atual do índice
+ */
+static bool lerCabecalhoFiltro(FILE *fp, CabecalhoArvoreB *cab, int *nroContadores, int *nroHashes, int *nroChaves) {
+    char identificador[4];
+    int noRaiz, proxRRN, nroNos, topoLivres;
+
+    if (fread(identificador, sizeof(char), 4, fp) != 4 ||
+        fread(&noRaiz, sizeof(int), 1, fp) != 1 ||
+        fread(&proxRRN, sizeof(int), 1, fp) != 1 ||
+        fread(&nroNos, sizeof(int), 1, fp) != 1 ||
+        fread(&topoLivres, sizeof(int), 1, fp) != 1 ||
+        fread(nroContadores, sizeof(int), 1, fp) != 1 ||
+        fread(nroHashes, sizeof(int), 1, fp) != 1 ||
+        fread(nroChaves, sizeof(int), 1, fp) != 1) {
+        return false;
+    }
+
+    if (memcmp(identificador, BLOOM_IDENTIFICADOR, 4) != 0) return false;
+
+    // Índice inconsistente ou alterado sem o filtro
+    if (cab->status != '1' || cab->filtroDesatualizado != FILTRO_EM_DIA) return false;
+    if (noRaiz != cab->noRaiz || proxRRN != cab->proxRRN ||
+        nroNos != cab->nroNos || topoLivres != cab->topoLivres) {
+        return false;
+    }
+
+    // Número de contadores precisa ser potência de 2
+    if (*nroContadores <= 0 || (*nroContadores & (*nroContadores - 1)) != 0) return false;
+    if (*nroHashes <= 0 || *nroHashes > 16) return false;
+    return true;
+}
+
+/**
+ * @brief Cria um filtro vazio dimensionado para a capacidade informada
+ *
+ * Usa a menor potência de 2 com ao menos BLOOM_CONTADORES_POR_CHAVE
+ * contadores por chave esperada.
+ *
+ * @param capacidade Número de chaves esperado
+ * @return Filtro criado ou NULL em caso de falha
+ */
+FiltroBloom *bloom_criar(int capacidade) {
+    long long desejado = (long long)(capacidade > 0 ? capacidade : 0) * BLOOM_CONTADORES_POR_CHAVE;
+    int nroContadores = BLOOM_MIN_CONTADORES;
+    while (nroContadores < desejado && nroContadores <= INT_MAX / 2) {
+        nroContadores *= 2;
+    }
+
+    FiltroBloom *filtro = malloc(sizeof(FiltroBloom));
+    if (!filtro) return NULL;
+    filtro->contadores = calloc(nroContadores, sizeof(unsigned char));
+    if (!filtro->contadores) {
+        free(filtro);
+        return NULL;
+    }
+    filtro->nroContadores = nroContadores;
+    filtro->nroHashes = BLOOM_NRO_HASHES;
+    filtro->nroChaves = 0;
+    return filtro;
+}
+
+/**
+ * @brief Libera o filtro
+ * @param filtro Filtro a ser liberado (pode ser NULL)
+ */
+void bloom_liberar(FiltroBloom *filtro) {
+    if (!filtro) return;
+    free(filtro->contadores);
+    free(filtro);
+}
+
+/**
+ * @brief Acrescenta uma chave ao filtro
+ * @param filtro Filtro
+ * @param id Chave
+ */
+void bloom_adicionar(FiltroBloom *filtro, int id) {
+    if (!filtro) return;
+    for (int i = 0; i < filtro->nroHashes; i++) {
+        unsigned char *c = &filtro->contadores[posicaoContador(filtro->nroContadores, id, i)];
+        if (*c < BLOOM_CONTADOR_MAX) (*c)++;
+    }
+    filtro->nroChaves++;
+}
+
+/**
+ * @brief Retira uma chave do filtro
+ *
+ * Contadores saturados ficam como estão: não se sabe mais quantas chaves
+ * passam por eles, e decrementá-los poderia gerar falsos negativos.
+ *
+ * @param filtro Filtro
+ * @param id Chave (precisa ter sido adicionada antes)
+ */
+void bloom_remover(FiltroBloom *filtro, int id) {
+    if (!filtro) return;
+    for (int i = 0; i < filtro->nroHashes; i++) {
+        unsigned char *c = &filtro->contadores[posicaoContador(filtro->nroContadores, id, i)];
+        if (*c > 0 && *c < BLOOM_CONTADOR_MAX) (*c)--;
+    }
+    if (filtro->nroChaves > 0) filtro->nroChaves--;
+}
+
+/**
+ * @brief Consulta o filtro em memória
+ * @param filtro Filtro
+ * @param id Chave
+ * @return false se a chave certamente não está no índice
+ */
+bool bloom_pode_conter(FiltroBloom *filtro, int id) {
+    if (!filtro) return true;
+    for (int i = 0; i < filtro->nroHashes; i++) {
+        if (filtro->contadores[posicaoContador(filtro->nroContadores, id, i)] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Indica se o filtro passou da carga para a qual foi dimensionado
+ *
+ * Abaixo de 8 contadores por chave a taxa de falsos positivos passa de
+ * cerca de 2%.
+ *
+ * @param filtro Filtro
+ * @return true se convém reconstruí-lo maior
+ */
+bool bloom_sobrecarregado(FiltroBloom *filtro) {
+    if (!filtro) return false;
+    return (long long)filtro->nroChaves * 8 > filtro->nroContadores;
+}
+
+/**
+ * @brief Monta um filtro com todas as chaves da árvore-B
+ * @param fp Ponteiro para o arquivo da árvore-B
+ * @param cab Cabeçalho da árvore-B
+ * @return Filtro criado ou NULL em caso de falha
+ */
+FiltroBloom *bloom_reconstruir(FILE *fp, CabecalhoArvoreB *cab) {
+    int capacidade = cab->nroNos * MAX_CHAVES;
+    int *chaves = malloc(sizeof(int) * (capacidade > 0 ? capacidade : 1));
+    long long *pr = malloc(sizeof(long long) * (capacidade > 0 ? capacidade : 1));
+    int n = -1;
+    if (chaves && pr) {
+        n = coletarChavesArvoreB(fp, cab->noRaiz, INT_MIN, INT_MAX, chaves, pr, 0, capacidade);
+    }
+
+    FiltroBloom *filtro = (n >= 0) ? bloom_criar(n) : NULL;
+    for (int i = 0; filtro && i < n; i++) {
+        bloom_adicionar(filtro, chaves[i]);
+    }
+
+    free(chaves);
+    free(pr);
+    return filtro;
+}
+
+/**
+ * @brief Carrega o filtro de "<índice>.bloom" se ele estiver em dia com o índice
+ * @param btreeFilename Nome do arquivo de índice
+ * @param cab Cabeçalho atual do índice
+ * @return Filtro carregado ou NULL se ausente ou desatualizado
+ */
+FiltroBloom *bloom_carregar(const char *btreeFilename, CabecalhoArvoreB *cab) {
+    char *nome = nomeArquivoFiltro(btreeFilename);
+    FILE *fp = nome ? wal_fopen(nome, "rb") : NULL;
+    free(nome);
+    if (!fp) return NULL;
+
+    int nroContadores, nroHashes, nroChaves;
+    FiltroBloom *filtro = NULL;
+    if (lerCabecalhoFiltro(fp, cab, &nroContadores, &nroHashes, &nroChaves)) {
+        filtro = malloc(sizeof(FiltroBloom));
+        if (filtro) {
+            filtro->contadores = malloc(nroContadores);
+            filtro->nroContadores = nroContadores;
+            filtro->nroHashes = nroHashes;
+            filtro->nroChaves = nroChaves;
+            if (!filtro->contadores ||
+                fread(filtro->contadores, sizeof(unsigned char), nroContadores, fp) != (size_t)nroContadores) {
+                bloom_liberar(filtro);
+                filtro = NULL;
+            }
+        }
+    }
+
+    fclose(fp);
+    return filtro;
+}
+
+/**
+ * @brief Grava o filtro em "<índice>.bloom" com a assinatura do cabeçalho
+ *
+ * Dentro de um lote, o arquivo é gravado pelo log, no mesmo grupo das
+ * páginas do índice: um filtro novo nunca chega ao disco sem elas.
+ *
+ * @param filtro Filtro
+ * @param btreeFilename Nome do arquivo de índice
+ * @param cab Cabeçalho que o índice terá ao ser fechado
+ * @return true se gravado com sucesso
+ */
+bool bloom_salvar(FiltroBloom *filtro, const char *btreeFilename, CabecalhoArvoreB *cab) {
+    if (!filtro) return false;
+
+    char *nome = nomeArquivoFiltro(btreeFilename);
+    FILE *fp = nome ? wal_fopen(nome, "wb") : NULL;
+    free(nome);
+    if (!fp) return false;
+
+    bool ok = fwrite(BLOOM_IDENTIFICADOR, sizeof(char), 4, fp) == 4 &&
+              fwrite(&cab->noRaiz, sizeof(int), 1, fp) == 1 &&
+              fwrite(&cab->proxRRN, sizeof(int), 1, fp) == 1 &&
+              fwrite(&cab->nroNos, sizeof(int), 1, fp) == 1 &&
+              fwrite(&cab->topoLivres, sizeof(int), 1, fp) == 1 &&
+              fwrite(&filtro->nroContadores, sizeof(int), 1, fp) == 1 &&
+              fwrite(&filtro->nroHashes, sizeof(int), 1, fp) == 1 &&
+              fwrite(&filtro->nroChaves, sizeof(int), 1, fp) == 1 &&
+              fwrite(filtro->contadores, sizeof(unsigned char), filtro->nroContadores, fp) == (size_t)filtro->nroContadores;
+
+    if (fclose(fp) != 0) ok = false;
+    return ok;
+}
+
+/**
+ * @brief Consulta o filtro direto no arquivo, lendo apenas os contadores da chave
+ *
+ * Usada em buscas avulsas, em que carregar o filtro inteiro custaria mais
+ * que a própria descida na árvore.
+ *
+ * @param btreeFilename Nome do arquivo de índice
+ * @param cab Cabeçalho atual do índice
+ * @param id Chave
+ * @return 0 se a chave certamente não existe, 1 se pode existir, -1 se não há filtro em dia
+ */
+int bloom_consultar_arquivo(const char *btreeFilename, CabecalhoArvoreB *cab, int id) {
+    char *nome = nomeArquivoFiltro(btreeFilename);
+    FILE *fp = nome ? wal_fopen(nome, "rb") : NULL;
+    free(nome);
+    if (!fp) return -1;
+
+    int nroContadores, nroHashes, nroChaves;
+    int resultado = -1;
+    if (lerCabecalhoFiltro(fp, cab, &nroContadores, &nroHashes, &nroChaves)) {
+        resultado = 1;
+        for (int i = 0; i < nroHashes; i++) {
+            unsigned char contador;
+            long posicao = BLOOM_TAM_CABECALHO + posicaoContador(nroContadores, id, i);
+            if (fseek(fp, posicao, SEEK_SET) != 0 || fread(&contador, 1, 1, fp) != 1) {
+                resultado = -1;
+                break;
+            }
+            if (contador == 0) {
+                resultado = 0;
+                break;
+            }
+        }
+    }
+
+    fclose(fp);
+    return resultado;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file filtro-bloom.h
+ * @brief Filtro de Bloom com contadores mantido ao lado do índice árvore-B
+ *
+ * O filtro responde "certamente ausente" ou "talvez presente" para um ID
+ * sem descer na árvore. Como usa contadores em vez de bits, aceita
+ * remoções. Fica no arquivo "<índice>.bloom", que guarda uma assinatura do
+ * cabeçalho do índice; o filtro só é usado se a assinatura ainda confere e
+ * o índice não foi marcado como alterado sem o filtro.
+ */
+
+#ifndef FILTRO_BLOOM_H
+#define FILTRO_BLOOM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "arvore-b.h"
+
+#define BLOOM_NRO_HASHES 4
+#define BLOOM_CONTADORES_POR_CHAVE 16   // Dimensionamento inicial
+#define BLOOM_MIN_CONTADORES 1024
+#define BLOOM_CONTADOR_MAX 255          // Contador saturado nunca é decrementado
+
+/**
+ * @brief Filtro de Bloom com contadores de 8 bits
+ */
+struct FiltroBloom {
+    int nroContadores;          // Potência de 2
+    int nroHashes;              // Número de funções de hash
+    int nroChaves;              // Chaves representadas no filtro
+    unsigned char *contadores;  // Vetor de contadores
+};
+
+/**
+ * @brief Cria um filtro vazio dimensionado para a capacidade informada
+ * @param capacidade Número de chaves esperado
+ * @return Filtro criado ou NULL em caso de falha
+ */
+FiltroBloom *bloom_criar(int capacidade);
+
+/**
+ * @brief Libera o filtro
+ * @param filtro Filtro a ser liberado (pode ser NULL)
+ */
+void bloom_liberar(FiltroBloom *filtro);
+
+/**
+ * @brief Acrescenta uma chave ao filtro
+ * @param filtro Filtro
+ * @param id Chave
+ */
+void bloom_adicionar(FiltroBloom *filtro, int id);
+
+/**
+ * @brief Retira uma chave do filtro
+ * @param filtro Filtro
+ * @param id Chave (precisa ter sido adicionada antes)
+ */
+void bloom_remover(FiltroBloom *filtro, int id);
+
+/**
+ * @brief Consulta o filtro em memória
+ * @param filtro Filtro
+ * @param id Chave
+ * @return false se a chave certamente não está no índice
+ */
+bool bloom_pode_conter(FiltroBloom *filtro, int id);
+
+/**
+ * @brief Indica se o filtro passou da carga para a qual foi dimensionado
+ * @param filtro Filtro
+ * @return true se convém reconstruí-lo maior
+ */
+bool bloom_sobrecarregado(FiltroBloom *filtro);
+
+/**
+ * @brief Monta um filtro com todas as chaves da árvore-B
+ * @param fp Ponteiro para o arquivo da árvore-B
+ * @param cab Cabeçalho da árvore-B
+ * @return Filtro criado ou NULL em caso de falha
+ */
+FiltroBloom *bloom_reconstruir(FILE *fp, CabecalhoArvoreB *cab);
+
+/**
+ * @brief Carrega o filtro de "<índice>.bloom" se ele estiver em dia com o índice
+ * @param btreeFilename Nome do arquivo de índice
+ * @param cab Cabeçalho atual do índice
+ * @return Filtro carregado ou NULL se ausente ou desatualizado
+ */
+FiltroBloom *bloom_carregar(const char *btreeFilename, CabecalhoArvoreB *cab);
+
+/**
+ * @brief Grava o filtro em "<índice>.bloom" com a assinatura do cabeçalho
+ * @param filtro Filtro
+ * @param btreeFilename Nome do arquivo de índice
+ * @param cab Cabeçalho que o índice terá ao ser fechado
+ * @return true se gravado com sucesso
+ */
+bool bloom_salvar(FiltroBloom *filtro, const char *btreeFilename, CabecalhoArvoreB *cab);
+
+/**
+ * @brief Consulta o filtro direto no arquivo, lendo apenas os contadores da chave
+ * @param btreeFilename Nome do arquivo de índice
+ * @param cab Cabeçalho atual do índice
+ * @param id Chave
+ * @return 0 se a chave certamente não existe, 1 se pode existir, -1 se não há filtro em dia
+ */
+int bloom_consultar_arquivo(const char *btreeFilename, CabecalhoArvoreB *cab, int id);
+
+#endif // FILTRO_BLOOM_H
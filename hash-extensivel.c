@@ -0,0 +1,881 @@
+/**
+ * @file hash-extensivel.c
+ * @brief Implementação do índice de hashing extensível por idAttack
+ *
+ * O diretório usa os bits menos significativos de um hash do ID. Quando
+ * um balde cheio precisa receber uma chave, ele é dividido pelo próximo
+ * bit do hash; se sua profundidade local já é a global, o diretório é
+ * dobrado antes. Baldes novos e diretórios maiores são acrescentados ao
+ * final do arquivo (proxByteOffset). Na remoção os baldes não são
+ * fundidos: o espaço liberado é reaproveitado pelas próximas inserções
+ * no mesmo balde.
+ *
+ * Cada ID entra uma única vez; uma segunda inserção da mesma chave é
+ * recusada. Se todas as chaves de um balde cheio têm os mesmos
+ * PROFUNDIDADE_MAX_HASH bits de hash, nenhuma divisão as separaria: a
+ * nova chave vai para um balde de overflow encadeado pelo proxBalde.
+ */
+
+#include "hash-extensivel.h"
+#include "arvore-b.h"
+#include "record.h"
+#include "utils.h"
+#include "wal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/**
+ * @brief Hash do ID (finalizador do MurmurHash3)
+ */
+static uint32_t hashId(int id) {
+    uint32_t x = (uint32_t)id;
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Entrada do diretório correspondente ao ID
+ */
+static int entradaDiretorio(int profundidadeGlobal, int id) {
+    return (int)(hashId(id) & ((1u << profundidadeGlobal) - 1u));
+}
+
+// ================= FUNÇÕES DE I/O BÁSICAS =================
+
+/**
+ * @brief Escreve o cabeçalho do índice hash
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ */
+void escreverCabecalhoHash(FILE *fp, CabecalhoHash *cab) {
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&cab->status, sizeof(char), 1, fp);
+    fwrite(&cab->profundidadeGlobal, sizeof(int), 1, fp);
+    fwrite(&cab->nroBaldes, sizeof(int), 1, fp);
+    fwrite(&cab->nroChaves, sizeof(int), 1, fp);
+    fwrite(&cab->offsetDiretorio, sizeof(long long), 1, fp);
+    fwrite(&cab->proxByteOffset, sizeof(long long), 1, fp);
+    fwrite(&cab->lixo, sizeof(char), 11, fp);
+    fwrite(&cab->identificador, sizeof(char), 4, fp);
+    fflush(fp);
+}
+
+/**
+ * @brief Lê o cabeçalho do índice hash
+ *
+ * Em caso de erro na leitura, devolve um cabeçalho inconsistente.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ */
+void lerCabecalhoHash(FILE *fp, CabecalhoHash *cab) {
+    if (fseek(fp, 0, SEEK_SET) != 0 ||
+        fread(&cab->status, sizeof(char), 1, fp) != 1 ||
+        fread(&cab->profundidadeGlobal, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->nroBaldes, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->nroChaves, sizeof(int), 1, fp) != 1 ||
+        fread(&cab->offsetDiretorio, sizeof(long long), 1, fp) != 1 ||
+        fread(&cab->proxByteOffset, sizeof(long long), 1, fp) != 1 ||
+        fread(&cab->lixo, sizeof(char), 11, fp) != 11 ||
+        fread(&cab->identificador, sizeof(char), 4, fp) != 4) {
+        memset(cab, 0, sizeof(CabecalhoHash));
+        cab->status = '0';
+    }
+}
+
+/**
+ * @brief Escreve um balde no byte offset indicado
+ *
+ * Ordem dos campos: profundidadeLocal, nroChaves, os pares (C, PR) e proxBalde.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param offset Byte offset do balde
+ * @param balde Ponteiro para o balde
+ */
+void escreverBaldeHash(FILE *fp, long long offset, BaldeHash *balde) {
+    if (fseek(fp, offset, SEEK_SET) != 0) return;
+    fwrite(&balde->profundidadeLocal, sizeof(int), 1, fp);
+    fwrite(&balde->nroChaves, sizeof(int), 1, fp);
+    for (int i = 0; i < TAM_BALDE_HASH; i++) {
+        fwrite(&balde->chaves[i], sizeof(int), 1, fp);
+        fwrite(&balde->pr[i], sizeof(long long), 1, fp);
+    }
+    fwrite(&balde->proxBalde, sizeof(long long), 1, fp);
+    fflush(fp);
+}
+
+/**
+ * @brief Lê o balde do byte offset indicado
+ *
+ * Em caso de erro, devolve um balde vazio.
+ *
+ * @param fp Ponteiro para o arquivo
+ * @param offset Byte offset do balde
+ * @param balde Ponteiro para o balde
+ */
+void lerBaldeHash(FILE *fp, long long offset, BaldeHash *balde) {
+    bool ok = fseek(fp, offset, SEEK_SET) == 0 &&
+              fread(&balde->profundidadeLocal, sizeof(int), 1, fp) == 1 &&
+              fread(&balde->nroChaves, sizeof(int), 1, fp) == 1;
+    for (int i = 0; ok && i < TAM_BALDE_HASH; i++) {
+        ok = fread(&balde->chaves[i], sizeof(int), 1, fp) == 1 &&
+             fread(&balde->pr[i], sizeof(long long), 1, fp) == 1;
+    }
+    ok = ok && fread(&balde->proxBalde, sizeof(long long), 1, fp) == 1;
+    if (!ok || balde->nroChaves < 0 || balde->nroChaves > TAM_BALDE_HASH) {
+        balde->profundidadeLocal = 0;
+        balde->nroChaves = 0;
+        balde->proxBalde = -1;
+    }
+}
+
+/**
+ * @brief Prepara um balde vazio
+ */
+static void inicializaBalde(BaldeHash *balde, int profundidadeLocal) {
+    balde->profundidadeLocal = profundidadeLocal;
+    balde->nroChaves = 0;
+    for (int i = 0; i < TAM_BALDE_HASH; i++) {
+        balde->chaves[i] = -1;
+        balde->pr[i] = -1;
+    }
+    balde->proxBalde = -1;
+}
+
+/**
+ * @brief Inicializa o cabeçalho, o primeiro balde e o diretório de um índice vazio
+ *
+ * O índice começa com profundidade global 0: um único balde e um
+ * diretório de uma entrada. O status fica inconsistente ('0').
+ *
+ * @param fp Ponteiro para o arquivo
+ */
+void inicializaIndiceHash(FILE *fp) {
+    if (!fp) return;
+
+    CabecalhoHash cab;
+    cab.status = '0';
+    cab.profundidadeGlobal = 0;
+    cab.nroBaldes = 1;
+    cab.nroChaves = 0;
+    memset(cab.lixo, '$', 11);
+    memcpy(cab.identificador, IDENTIFICADOR_HASH, 4);
+
+    long long offsetBalde = TAM_CABECALHO_HASH;
+    cab.offsetDiretorio = offsetBalde + TAM_PAGINA_HASH;
+    cab.proxByteOffset = cab.offsetDiretorio + (long long)sizeof(long long);
+
+    BaldeHash balde;
+    inicializaBalde(&balde, 0);
+    escreverCabecalhoHash(fp, &cab);
+    escreverBaldeHash(fp, offsetBalde, &balde);
+
+    fseek(fp, cab.offsetDiretorio, SEEK_SET);
+    fwrite(&offsetBalde, sizeof(long long), 1, fp);
+    fflush(fp);
+}
+
+// ================= DIRETÓRIO EM MEMÓRIA =================
+
+/**
+ * @brief Carrega cabeçalho e diretório do arquivo para a sessão
+ * @return true se o arquivo é um índice hash legível
+ */
+static bool carregarSessao(FILE *fp, SessaoHash *sessao) {
+    sessao->fp = fp;
+    sessao->diretorio = NULL;
+    sessao->diretorioSujo = false;
+    lerCabecalhoHash(fp, &sessao->cab);
+
+    if (memcmp(sessao->cab.identificador, IDENTIFICADOR_HASH, 4) != 0) return false;
+    if (sessao->cab.profundidadeGlobal < 0 || sessao->cab.profundidadeGlobal > PROFUNDIDADE_MAX_HASH) return false;
+
+    int tamanho = 1 << sessao->cab.profundidadeGlobal;
+    sessao->diretorio = malloc(sizeof(long long) * tamanho);
+    if (!sessao->diretorio) return false;
+    sessao->tamanhoEmDisco = tamanho;
+
+    if (fseek(fp, sessao->cab.offsetDiretorio, SEEK_SET) != 0 ||
+        fread(sessao->diretorio, sizeof(long long), tamanho, fp) != (size_t)tamanho) {
+        free(sessao->diretorio);
+        sessao->diretorio = NULL;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Grava o diretório (se alterado) e o cabeçalho da sessão
+ *
+ * Um diretório que cresceu não cabe mais na área antiga e é gravado ao
+ * final do arquivo; a área antiga deixa de ser usada.
+ */
+static void descarregarSessao(SessaoHash *sessao) {
+    int tamanho = 1 << sessao->cab.profundidadeGlobal;
+    if (sessao->diretorioSujo) {
+        if (tamanho > sessao->tamanhoEmDisco) {
+            sessao->cab.offsetDiretorio = sessao->cab.proxByteOffset;
+            sessao->cab.proxByteOffset += (long long)sizeof(long long) * tamanho;
+            sessao->tamanhoEmDisco = tamanho;
+        }
+        fseek(sessao->fp, sessao->cab.offsetDiretorio, SEEK_SET);
+        fwrite(sessao->diretorio, sizeof(long long), tamanho, sessao->fp);
+        sessao->diretorioSujo = false;
+    }
+    escreverCabecalhoHash(sessao->fp, &sessao->cab);
+}
+
+/**
+ * @brief Procura a chave no balde
+ * @return Posição da chave ou -1
+ */
+static int posicaoNoBalde(BaldeHash *balde, int id) {
+    for (int i = 0; i < balde->nroChaves; i++) {
+        if (balde->chaves[i] == id) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Procura a chave no balde indicado e nos baldes de overflow encadeados a ele
+ * @param limite Número máximo de baldes percorridos (protege contra cadeias corrompidas)
+ * @param balde Recebe o balde em que a chave está
+ * @param offset Recebe o byte offset desse balde
+ * @return Posição da chave no balde ou -1
+ */
+static int localizarNaCadeia(FILE *fp, long long offsetBalde, int id, int limite, BaldeHash *balde, long long *offset) {
+    for (int passos = 0; offsetBalde != -1 && passos <= limite; passos++) {
+        lerBaldeHash(fp, offsetBalde, balde);
+        int pos = posicaoNoBalde(balde, id);
+        if (pos != -1) {
+            *offset = offsetBalde;
+            return pos;
+        }
+        offsetBalde = balde->proxBalde;
+    }
+    return -1;
+}
+
+/**
+ * @brief Grava as chaves como uma cadeia de baldes
+ *
+ * Reaproveita primeiro os baldes da lista de livres e só então acrescenta
+ * baldes ao final do arquivo. Com esgotar, os livres que sobrarem entram
+ * vazios no fim da cadeia, para não ficarem perdidos no arquivo.
+ *
+ * @return Byte offset do primeiro balde da cadeia
+ */
+static long long gravarCadeia(SessaoHash *sessao, const long long livres[], int nLivres, int *usados,
+                              const int chaves[], const long long pr[], int n, int profundidade, bool esgotar) {
+    long long primeiro = -1, offsetAnterior = -1;
+    BaldeHash anterior;
+    int i = 0;
+
+    do {
+        long long offset;
+        if (*usados < nLivres) {
+            offset = livres[(*usados)++];
+        } else {
+            offset = sessao->cab.proxByteOffset;
+            sessao->cab.proxByteOffset += TAM_PAGINA_HASH;
+            sessao->cab.nroBaldes++;
+        }
+
+        BaldeHash balde;
+        inicializaBalde(&balde, profundidade);
+        for (; i < n && balde.nroChaves < TAM_BALDE_HASH; i++) {
+            balde.chaves[balde.nroChaves] = chaves[i];
+            balde.pr[balde.nroChaves] = pr[i];
+            balde.nroChaves++;
+        }
+
+        if (offsetAnterior == -1) {
+            primeiro = offset;
+        } else {
+            anterior.proxBalde = offset;
+            escreverBaldeHash(sessao->fp, offsetAnterior, &anterior);
+        }
+        anterior = balde;
+        offsetAnterior = offset;
+    } while (i < n || (esgotar && *usados < nLivres));
+
+    escreverBaldeHash(sessao->fp, offsetAnterior, &anterior);
+    return primeiro;
+}
+
+/**
+ * @brief Divide o balde cheio do diretório na entrada indicada
+ *
+ * Dobra o diretório se necessário e redistribui as chaves do balde e de
+ * seus baldes de overflow pelo bit (profundidadeLocal) do hash em duas
+ * cadeias. Os baldes da cadeia antiga são reaproveitados; o primeiro
+ * continua com as chaves de bit desligado.
+ *
+ * @return true se a divisão foi feita
+ */
+static bool dividirBalde(SessaoHash *sessao, int entrada) {
+    long long offsetBalde = sessao->diretorio[entrada];
+
+    // Reúne as chaves e os byte offsets de todos os baldes da cadeia
+    int nBaldes = 0, nChaves = 0, capacidade = 0;
+    long long *baldes = NULL, *pr = NULL;
+    int *chaves = NULL;
+    int profundidade = 0;
+    BaldeHash balde;
+    for (long long o = offsetBalde; o != -1 && nBaldes <= sessao->cab.nroBaldes; o = balde.proxBalde) {
+        if (nBaldes == capacidade) {
+            capacidade = capacidade ? 2 * capacidade : 4;
+            long long *nb = realloc(baldes, sizeof(long long) * capacidade);
+            if (nb) baldes = nb;
+            int *nc = realloc(chaves, sizeof(int) * capacidade * TAM_BALDE_HASH);
+            if (nc) chaves = nc;
+            long long *np = realloc(pr, sizeof(long long) * capacidade * TAM_BALDE_HASH);
+            if (np) pr = np;
+            if (!nb || !nc || !np) {
+                free(baldes);
+                free(chaves);
+                free(pr);
+                return false;
+            }
+        }
+        lerBaldeHash(sessao->fp, o, &balde);
+        if (nBaldes == 0) profundidade = balde.profundidadeLocal;
+        baldes[nBaldes++] = o;
+        for (int i = 0; i < balde.nroChaves; i++) {
+            chaves[nChaves] = balde.chaves[i];
+            pr[nChaves] = balde.pr[i];
+            nChaves++;
+        }
+    }
+
+    bool dividido = false;
+    if (profundidade == sessao->cab.profundidadeGlobal) {
+        int tamanho = 1 << sessao->cab.profundidadeGlobal;
+        long long *novo = NULL;
+        if (sessao->cab.profundidadeGlobal < PROFUNDIDADE_MAX_HASH) {
+            novo = realloc(sessao->diretorio, sizeof(long long) * tamanho * 2);
+        }
+        if (novo) {
+            for (int i = 0; i < tamanho; i++) novo[tamanho + i] = novo[i];
+            sessao->diretorio = novo;
+            sessao->cab.profundidadeGlobal++;
+        }
+        dividido = novo != NULL;
+    } else {
+        dividido = true;
+    }
+
+    if (dividido) {
+        // Chaves de bit desligado à frente, de bit ligado ao fim
+        uint32_t bit = 1u << profundidade;
+        int mantidas = 0;
+        for (int i = 0; i < nChaves; i++) {
+            if (!(hashId(chaves[i]) & bit)) {
+                int c = chaves[i];
+                long long p = pr[i];
+                chaves[i] = chaves[mantidas];
+                pr[i] = pr[mantidas];
+                chaves[mantidas] = c;
+                pr[mantidas] = p;
+                mantidas++;
+            }
+        }
+
+        int usados = 0;
+        gravarCadeia(sessao, baldes, nBaldes, &usados, chaves, pr, mantidas, profundidade + 1, false);
+        long long offsetIrmao = gravarCadeia(sessao, baldes, nBaldes, &usados, chaves + mantidas, pr + mantidas,
+                                             nChaves - mantidas, profundidade + 1, true);
+
+        // Entradas que apontavam para o balde e têm o bit ligado passam ao irmão
+        int tamanho = 1 << sessao->cab.profundidadeGlobal;
+        for (int i = 0; i < tamanho; i++) {
+            if (sessao->diretorio[i] == offsetBalde && ((uint32_t)i & bit)) {
+                sessao->diretorio[i] = offsetIrmao;
+            }
+        }
+        sessao->diretorioSujo = true;
+    }
+
+    free(baldes);
+    free(chaves);
+    free(pr);
+    return dividido;
+}
+
+/**
+ * @brief Insere uma chave com o diretório em memória
+ *
+ * A chave vai para o primeiro balde da cadeia com espaço. Com a cadeia
+ * cheia, o balde é dividido; se todas as chaves têm os mesmos
+ * PROFUNDIDADE_MAX_HASH bits de hash que a nova, a divisão não as
+ * separaria e um balde de overflow é encadeado ao fim da cadeia.
+ *
+ * @return 1 se inserida, 0 se a chave já existe, -1 em caso de falha
+ */
+static int inserirNaSessao(SessaoHash *sessao, int id, long long byteOffset) {
+    const uint32_t mascara = (1u << PROFUNDIDADE_MAX_HASH) - 1u;
+
+    while (1) {
+        int entrada = entradaDiretorio(sessao->cab.profundidadeGlobal, id);
+        long long offset = sessao->diretorio[entrada];
+        long long offsetLivre = -1, offsetUltimo = -1;
+        BaldeHash balde, livre;
+        int profundidade = 0;
+        bool mesmoHash = true;
+
+        for (int passos = 0; offset != -1 && passos <= sessao->cab.nroBaldes; passos++) {
+            lerBaldeHash(sessao->fp, offset, &balde);
+            if (passos == 0) profundidade = balde.profundidadeLocal;
+            if (posicaoNoBalde(&balde, id) != -1) return 0;
+            for (int i = 0; i < balde.nroChaves; i++) {
+                if ((hashId(balde.chaves[i]) ^ hashId(id)) & mascara) mesmoHash = false;
+            }
+            if (offsetLivre == -1 && balde.nroChaves < TAM_BALDE_HASH) {
+                offsetLivre = offset;
+                livre = balde;
+            }
+            offsetUltimo = offset;
+            offset = balde.proxBalde;
+        }
+
+        if (offsetLivre != -1) {
+            livre.chaves[livre.nroChaves] = id;
+            livre.pr[livre.nroChaves] = byteOffset;
+            livre.nroChaves++;
+            escreverBaldeHash(sessao->fp, offsetLivre, &livre);
+            sessao->cab.nroChaves++;
+            return 1;
+        }
+
+        if (mesmoHash || profundidade >= PROFUNDIDADE_MAX_HASH) {
+            // Nenhuma divisão separaria as chaves: encadeia um balde de overflow
+            BaldeHash overflow;
+            inicializaBalde(&overflow, profundidade);
+            overflow.chaves[0] = id;
+            overflow.pr[0] = byteOffset;
+            overflow.nroChaves = 1;
+
+            long long offsetOverflow = sessao->cab.proxByteOffset;
+            sessao->cab.proxByteOffset += TAM_PAGINA_HASH;
+            sessao->cab.nroBaldes++;
+            escreverBaldeHash(sessao->fp, offsetOverflow, &overflow);
+
+            balde.proxBalde = offsetOverflow;
+            escreverBaldeHash(sessao->fp, offsetUltimo, &balde);
+            sessao->cab.nroChaves++;
+            return 1;
+        }
+
+        // Cadeia cheia com hashes distintos: divide e tenta de novo
+        if (!dividirBalde(sessao, entrada)) return -1;
+    }
+}
+
+/**
+ * @brief Remove uma chave com o diretório em memória
+ */
+static int removerNaSessao(SessaoHash *sessao, int id) {
+    BaldeHash balde;
+    long long offsetBalde;
+    int pos = localizarNaCadeia(sessao->fp, sessao->diretorio[entradaDiretorio(sessao->cab.profundidadeGlobal, id)],
+                                id, sessao->cab.nroBaldes, &balde, &offsetBalde);
+    if (pos == -1) return 0;
+
+    // A última chave do balde ocupa o lugar da removida
+    int ultima = balde.nroChaves - 1;
+    balde.chaves[pos] = balde.chaves[ultima];
+    balde.pr[pos] = balde.pr[ultima];
+    balde.chaves[ultima] = -1;
+    balde.pr[ultima] = -1;
+    balde.nroChaves--;
+    escreverBaldeHash(sessao->fp, offsetBalde, &balde);
+    sessao->cab.nroChaves--;
+    return 1;
+}
+
+/**
+ * @brief Atualiza o byte offset de uma chave com o diretório em memória
+ */
+static int atualizarNaSessao(SessaoHash *sessao, int id, long long newOffset) {
+    BaldeHash balde;
+    long long offsetBalde;
+    int pos = localizarNaCadeia(sessao->fp, sessao->diretorio[entradaDiretorio(sessao->cab.profundidadeGlobal, id)],
+                                id, sessao->cab.nroBaldes, &balde, &offsetBalde);
+    if (pos == -1) return 0;
+
+    balde.pr[pos] = newOffset;
+    escreverBaldeHash(sessao->fp, offsetBalde, &balde);
+    return 1;
+}
+
+// ================= FUNÇÕES PRINCIPAIS =================
+
+/**
+ * @brief Indica se o arquivo é um índice hash (e não uma árvore-B)
+ *
+ * O identificador ocupa os bytes 40..43 do cabeçalho, que na árvore-B
+ * são sempre lixo ('$').
+ *
+ * @param filename Nome do arquivo de índice
+ * @return true se o cabeçalho traz o identificador do índice hash
+ */
+bool ehIndiceHash(const char *filename) {
+    FILE *fp = wal_fopen(filename, "rb");
+    if (!fp) return false;
+
+    char identificador[4];
+    bool ehHash = fseek(fp, TAM_CABECALHO_HASH - 4, SEEK_SET) == 0 &&
+                  fread(identificador, sizeof(char), 4, fp) == 4 &&
+                  memcmp(identificador, IDENTIFICADOR_HASH, 4) == 0;
+    fclose(fp);
+    return ehHash;
+}
+
+/**
+ * @brief Constrói um índice hash a partir de um arquivo de dados
+ *
+ * Mesma varredura de buildBTreeFromDataFile: todo registro não removido
+ * é inserido com o byte offset em que começa. O diretório fica em
+ * memória durante toda a construção.
+ *
+ * @param dataFilename Nome do arquivo de dados
+ * @param hashFilename Nome do arquivo de índice a ser criado
+ */
+void buildHashFromDataFile(const char *dataFilename, const char *hashFilename) {
+    FILE *dataFile = wal_fopen(dataFilename, "rb");
+    if (!dataFile) {
+        printf("Falha no processamento do arquivo.\n");
+        return;
+    }
+
+    char status;
+    if (fread(&status, sizeof(char), 1, dataFile) != 1 || status != '1') {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(dataFile);
+        return;
+    }
+
+    FILE *hashFile = wal_fopen(hashFilename, "wb+");
+    if (!hashFile) {
+        printf("Falha no processamento do arquivo.\n");
+        fclose(dataFile);
+        return;
+    }
+
+    inicializaIndiceHash(hashFile);
+    SessaoHash sessao;
+    if (!carregarSessao(hashFile, &sessao) || fseek(dataFile, 276, SEEK_SET) != 0) {
+        printf("Falha no processamento do arquivo.\n");
+        free(sessao.diretorio);
+        fclose(dataFile);
+        fclose(hashFile);
+        return;
+    }
+
+    Record record;
+    bool falha = false;
+    while (!falha) {
+        long long recordOffset = ftell(dataFile);
+        if (!readRecord(dataFile, &record)) break;
+
+        // Um ID repetido no arquivo de dados fica indexado pela primeira ocorrência
+        bool fim = (record.id == -1);
+        if (!fim && record.removido == '0') {
+            falha = inserirNaSessao(&sessao, record.id, recordOffset) == -1;
+        }
+
+        if (record.country) free(record.country);
+        if (record.attackType) free(record.attackType);
+        if (record.targetIndustry) free(record.targetIndustry);
+        if (record.defenseStrategy) free(record.defenseStrategy);
+        if (fim) break;
+    }
+
+    // Marca o arquivo como consistente; após uma falha ele fica inconsistente
+    if (falha) {
+        printf("Falha no processamento do arquivo.\n");
+    } else {
+        sessao.cab.status = '1';
+    }
+    descarregarSessao(&sessao);
+    free(sessao.diretorio);
+
+    fclose(dataFile);
+    fclose(hashFile);
+}
+
+/**
+ * @brief Busca e imprime um registro usando o índice hash
+ * @param dataFilename Nome do arquivo de dados
+ * @param hashFilename Nome do arquivo de índice
+ * @param id ID do registro a ser buscado
+ */
+void printRecordFromHash(const char *dataFilename, const char *hashFilename, int id) {
+    FILE *hashFile = wal_fopen(hashFilename, "rb");
+    if (!hashFile) {
+        printf("Falha no processamento do arquivo.\n");
+        return;
+    }
+
+    long long offset = hash_search(hashFile, id);
+    fclose(hashFile);
+
+    printIndexedRecord(dataFilename, offset);
+}
+
+/**
+ * @brief Insere uma chave no índice hash
+ *
+ * Carrega o diretório, insere e regrava diretório e cabeçalho. Para
+ * várias chaves, prefira uma sessão aberta com hash_open.
+ *
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ * @return 1 se inserida, 0 se a chave já existe ou em caso de falha
+ */
+int hash_insert(FILE *fp, int id, long long byteOffset) {
+    SessaoHash sessao;
+    int inserida = 0;
+    if (carregarSessao(fp, &sessao)) {
+        inserida = inserirNaSessao(&sessao, id, byteOffset) == 1;
+        descarregarSessao(&sessao);
+    }
+    free(sessao.diretorio);
+    return inserida;
+}
+
+/**
+ * @brief Remove uma chave do índice hash
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int hash_remove(FILE *fp, int id) {
+    SessaoHash sessao;
+    int removido = 0;
+    if (carregarSessao(fp, &sessao)) {
+        removido = removerNaSessao(&sessao, id);
+        if (removido) descarregarSessao(&sessao);
+    }
+    free(sessao.diretorio);
+    return removido;
+}
+
+/**
+ * @brief Busca uma chave no índice hash
+ *
+ * Lê o cabeçalho, uma única entrada do diretório e o balde apontado por
+ * ela, além dos baldes de overflow encadeados se a chave não estiver nele.
+ *
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long hash_search(FILE *fp, int id) {
+    CabecalhoHash cab;
+    lerCabecalhoHash(fp, &cab);
+    if (cab.status != '1' || memcmp(cab.identificador, IDENTIFICADOR_HASH, 4) != 0) return -1;
+    if (cab.profundidadeGlobal < 0 || cab.profundidadeGlobal > PROFUNDIDADE_MAX_HASH) return -1;
+
+    long long offsetBalde;
+    long long posicao = cab.offsetDiretorio + (long long)sizeof(long long) * entradaDiretorio(cab.profundidadeGlobal, id);
+    if (fseek(fp, posicao, SEEK_SET) != 0 || fread(&offsetBalde, sizeof(long long), 1, fp) != 1) return -1;
+
+    BaldeHash balde;
+    int pos = localizarNaCadeia(fp, offsetBalde, id, cab.nroBaldes, &balde, &offsetBalde);
+    return (pos == -1) ? -1 : balde.pr[pos];
+}
+
+/**
+ * @brief Atualiza o byte offset de uma chave existente no índice hash
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int hash_update_offset(FILE *fp, int id, long long newOffset) {
+    SessaoHash sessao;
+    int atualizado = 0;
+    if (carregarSessao(fp, &sessao)) {
+        atualizado = atualizarNaSessao(&sessao, id, newOffset);
+    }
+    free(sessao.diretorio);
+    return atualizado;
+}
+
+/**
+ * @brief Comparador de byte offsets para qsort
+ */
+static int compararOffsets(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Traduz em lote os byte offsets do índice hash após a compactação do arquivo de dados
+ *
+ * Cada balde é lido e regravado uma única vez, na ordem em que está no
+ * arquivo, mesmo que várias entradas do diretório apontem para ele; os
+ * baldes de overflow vêm logo após o balde a que estão encadeados. Chaves
+ * cujo registro não está no mapa ficam com offset -1.
+ *
+ * @param fp Ponteiro para o arquivo do índice
+ * @param antigos Offsets antigos, em ordem crescente
+ * @param novos Offsets novos correspondentes
+ * @param n Número de entradas do mapa
+ * @return Número de offsets alterados, -1 se o índice estiver inconsistente
+ */
+int hash_remap_offsets(FILE *fp, const long long antigos[], const long long novos[], int n) {
+    SessaoHash sessao;
+    if (!carregarSessao(fp, &sessao) || sessao.cab.status != '1') {
+        free(sessao.diretorio);
+        return -1;
+    }
+
+    sessao.cab.status = '0';
+    escreverCabecalhoHash(fp, &sessao.cab);
+
+    // Baldes distintos, em ordem de offset
+    int tamanho = 1 << sessao.cab.profundidadeGlobal;
+    qsort(sessao.diretorio, tamanho, sizeof(long long), compararOffsets);
+
+    int alterados = 0;
+    for (int i = 0; i < tamanho; i++) {
+        if (i > 0 && sessao.diretorio[i] == sessao.diretorio[i - 1]) continue;
+
+        // Baldes de overflow pertencem a uma única cadeia e são visitados com ela
+        long long offsetBalde = sessao.diretorio[i];
+        for (int passos = 0; offsetBalde != -1 && passos <= sessao.cab.nroBaldes; passos++) {
+            BaldeHash balde;
+            lerBaldeHash(fp, offsetBalde, &balde);
+            bool sujo = false;
+            for (int j = 0; j < balde.nroChaves && j < TAM_BALDE_HASH; j++) {
+                long long novo = remapearOffset(antigos, novos, n, balde.pr[j]);
+                if (novo != balde.pr[j]) {
+                    balde.pr[j] = novo;
+                    sujo = true;
+                    alterados++;
+                }
+            }
+            if (sujo) escreverBaldeHash(fp, offsetBalde, &balde);
+            offsetBalde = balde.proxBalde;
+        }
+    }
+
+    // O diretório foi ordenado apenas em memória; o do disco não muda
+    sessao.cab.status = '1';
+    escreverCabecalhoHash(fp, &sessao.cab);
+    free(sessao.diretorio);
+    return alterados;
+}
+
+// ================= SESSÃO DE ÍNDICE =================
+
+/**
+ * @brief Abre uma sessão sobre o índice hash, carregando o diretório
+ *
+ * Como na sessão da árvore-B, o arquivo fica marcado como inconsistente
+ * no disco até hash_close.
+ *
+ * @param hashFilename Nome do arquivo de índice
+ * @return Sessão aberta ou NULL em caso de falha
+ */
+SessaoHash *hash_open(const char *hashFilename) {
+    if (!hashFilename) return NULL;
+
+    FILE *fp = wal_fopen(hashFilename, "rb+");
+    if (!fp) return NULL;
+
+    SessaoHash *sessao = malloc(sizeof(SessaoHash));
+    if (!sessao) {
+        fclose(fp);
+        return NULL;
+    }
+
+    if (!carregarSessao(fp, sessao) || sessao->cab.status != '1') {
+        free(sessao->diretorio);
+        free(sessao);
+        fclose(fp);
+        return NULL;
+    }
+
+    sessao->cab.status = '0';
+    escreverCabecalhoHash(fp, &sessao->cab);
+    return sessao;
+}
+
+/**
+ * @brief Insere uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro
+ * @return 1 se inserida, 0 se a chave já existe ou em caso de falha
+ */
+int hash_session_insert(SessaoHash *sessao, int id, long long byteOffset) {
+    if (!sessao) return 0;
+    return inserirNaSessao(sessao, id, byteOffset) == 1;
+}
+
+/**
+ * @brief Remove uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int hash_session_remove(SessaoHash *sessao, int id) {
+    if (!sessao) return 0;
+    return removerNaSessao(sessao, id);
+}
+
+/**
+ * @brief Busca uma chave usando a sessão
+ *
+ * Com o diretório em memória, a busca lê apenas o balde (e seus baldes
+ * de overflow, se houver).
+ *
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long hash_session_search(SessaoHash *sessao, int id) {
+    if (!sessao) return -1;
+    BaldeHash balde;
+    long long offsetBalde;
+    int pos = localizarNaCadeia(sessao->fp, sessao->diretorio[entradaDiretorio(sessao->cab.profundidadeGlobal, id)],
+                                id, sessao->cab.nroBaldes, &balde, &offsetBalde);
+    return (pos == -1) ? -1 : balde.pr[pos];
+}
+
+/**
+ * @brief Atualiza o byte offset de uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int hash_session_update_offset(SessaoHash *sessao, int id, long long newOffset) {
+    if (!sessao) return 0;
+    return atualizarNaSessao(sessao, id, newOffset);
+}
+
+/**
+ * @brief Grava diretório e cabeçalho (consistente) e fecha a sessão
+ * @param sessao Sessão aberta (liberada por esta função)
+ */
+void hash_close(SessaoHash *sessao) {
+    if (!sessao) return;
+
+    sessao->cab.status = '1';
+    descarregarSessao(sessao);
+
+    fclose(sessao->fp);
+    free(sessao->diretorio);
+    free(sessao);
+}
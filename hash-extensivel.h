@@ -0,0 +1,219 @@
+/**
+ * @file hash-extensivel.h
+ * @brief Cabeçalho para o índice de hashing extensível por idAttack
+ *
+ * Alternativa à árvore-B para buscas exatas: um diretório de 2^p
+ * byte offsets aponta para baldes de tamanho fixo. Uma busca lê uma
+ * entrada do diretório e um balde, independentemente do tamanho do
+ * arquivo de dados; com o diretório em memória (sessão), lê apenas o balde.
+ *
+ * Layout do arquivo: cabeçalho de 44 bytes (identificador "HEXT" nos
+ * bytes 40..43, onde a árvore-B guarda apenas lixo), seguido de baldes
+ * e diretórios acrescentados ao final conforme o índice cresce. Cada
+ * chave aparece uma única vez no índice.
+ */
+
+#ifndef HASH_EXTENSIVEL_H
+#define HASH_EXTENSIVEL_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define TAM_CABECALHO_HASH 44
+#define TAM_BALDE_HASH 8                 // Chaves por balde
+#define TAM_PAGINA_HASH (2 * (int)sizeof(int) + TAM_BALDE_HASH * ((int)sizeof(int) + (int)sizeof(long long)) + (int)sizeof(long long))
+#define PROFUNDIDADE_MAX_HASH 24
+#define IDENTIFICADOR_HASH "HEXT"
+
+/**
+ * @brief Estrutura do cabeçalho do índice hash
+ */
+typedef struct {
+    char status;                 // Status do arquivo ('0' inconsistente, '1' consistente)
+    int profundidadeGlobal;      // O diretório tem 2^profundidadeGlobal entradas
+    int nroBaldes;               // Número de baldes
+    int nroChaves;               // Número de chaves no índice
+    long long offsetDiretorio;   // Byte offset do diretório
+    long long proxByteOffset;    // Próximo byte offset livre ao final do arquivo
+    char lixo[11];               // Preenchimento
+    char identificador[4];       // IDENTIFICADOR_HASH
+} CabecalhoHash;
+
+/**
+ * @brief Estrutura de um balde do índice hash
+ */
+typedef struct {
+    int profundidadeLocal;           // Bits do hash comuns a todas as chaves do balde
+    int nroChaves;                   // Número de chaves presentes no balde
+    int chaves[TAM_BALDE_HASH];      // IDs dos registros
+    long long pr[TAM_BALDE_HASH];    // Byte offsets dos registros
+    long long proxBalde;             // Balde de overflow encadeado (-1 se não houver)
+} BaldeHash;
+
+/**
+ * @brief Sessão aberta sobre um índice hash, com o diretório em memória
+ */
+typedef struct {
+    FILE *fp;                    // Arquivo de índice aberto em modo "rb+"
+    CabecalhoHash cab;           // Cabeçalho mantido em memória
+    long long *diretorio;        // Diretório (2^profundidadeGlobal entradas)
+    int tamanhoEmDisco;          // Entradas do diretório na área atual do arquivo
+    bool diretorioSujo;          // Diretório alterado e ainda não gravado
+} SessaoHash;
+
+// ================= FUNÇÕES PRINCIPAIS =================
+
+/**
+ * @brief Constrói um índice hash a partir de um arquivo de dados
+ * @param dataFilename Nome do arquivo de dados
+ * @param hashFilename Nome do arquivo de índice a ser criado
+ */
+void buildHashFromDataFile(const char *dataFilename, const char *hashFilename);
+
+/**
+ * @brief Busca e imprime um registro usando o índice hash
+ * @param dataFilename Nome do arquivo de dados
+ * @param hashFilename Nome do arquivo de índice
+ * @param id ID do registro a ser buscado
+ */
+void printRecordFromHash(const char *dataFilename, const char *hashFilename, int id);
+
+/**
+ * @brief Indica se o arquivo é um índice hash (e não uma árvore-B)
+ * @param filename Nome do arquivo de índice
+ * @return true se o cabeçalho traz o identificador do índice hash
+ */
+bool ehIndiceHash(const char *filename);
+
+/**
+ * @brief Insere uma chave no índice hash
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro no arquivo de dados
+ * @return 1 se inserida, 0 se a chave já existe ou em caso de falha
+ */
+int hash_insert(FILE *fp, int id, long long byteOffset);
+
+/**
+ * @brief Remove uma chave do índice hash
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int hash_remove(FILE *fp, int id);
+
+/**
+ * @brief Busca uma chave no índice hash (uma entrada do diretório e um balde)
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long hash_search(FILE *fp, int id);
+
+/**
+ * @brief Atualiza o byte offset de uma chave existente no índice hash
+ * @param fp Ponteiro para o arquivo do índice
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int hash_update_offset(FILE *fp, int id, long long newOffset);
+
+/**
+ * @brief Traduz todos os byte offsets do índice pelo mapa da compactação do arquivo de dados
+ * @param fp Ponteiro para o arquivo do índice
+ * @param antigos Offsets antigos, em ordem crescente
+ * @param novos Offsets novos correspondentes
+ * @param n Número de entradas do mapa
+ * @return Número de offsets alterados, -1 se o índice estiver inconsistente
+ */
+int hash_remap_offsets(FILE *fp, const long long antigos[], const long long novos[], int n);
+
+// ================= SESSÃO DE ÍNDICE =================
+
+/**
+ * @brief Abre uma sessão sobre o índice hash, carregando o diretório
+ * @param hashFilename Nome do arquivo de índice
+ * @return Sessão aberta ou NULL se o arquivo não existir, não for hash ou estiver inconsistente
+ */
+SessaoHash *hash_open(const char *hashFilename);
+
+/**
+ * @brief Insere uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro (chave)
+ * @param byteOffset Byte offset do registro
+ * @return 1 se inserida, 0 se a chave já existe ou em caso de falha
+ */
+int hash_session_insert(SessaoHash *sessao, int id, long long byteOffset);
+
+/**
+ * @brief Remove uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int hash_session_remove(SessaoHash *sessao, int id);
+
+/**
+ * @brief Busca uma chave usando a sessão (lê apenas o balde e seus baldes de overflow)
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long hash_session_search(SessaoHash *sessao, int id);
+
+/**
+ * @brief Atualiza o byte offset de uma chave usando a sessão
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int hash_session_update_offset(SessaoHash *sessao, int id, long long newOffset);
+
+/**
+ * @brief Grava diretório e cabeçalho (consistente) e fecha a sessão
+ * @param sessao Sessão aberta (liberada por esta função)
+ */
+void hash_close(SessaoHash *sessao);
+
+// ================= FUNÇÕES DE I/O BÁSICAS =================
+
+/**
+ * @brief Inicializa o cabeçalho, o primeiro balde e o diretório de um índice vazio
+ * @param fp Ponteiro para o arquivo
+ */
+void inicializaIndiceHash(FILE *fp);
+
+/**
+ * @brief Escreve o cabeçalho do índice hash
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ */
+void escreverCabecalhoHash(FILE *fp, CabecalhoHash *cab);
+
+/**
+ * @brief Lê o cabeçalho do índice hash
+ * @param fp Ponteiro para o arquivo
+ * @param cab Ponteiro para o cabeçalho
+ */
+void lerCabecalhoHash(FILE *fp, CabecalhoHash *cab);
+
+/**
+ * @brief Escreve um balde no byte offset indicado
+ * @param fp Ponteiro para o arquivo
+ * @param offset Byte offset do balde
+ * @param balde Ponteiro para o balde
+ */
+void escreverBaldeHash(FILE *fp, long long offset, BaldeHash *balde);
+
+/**
+ * @brief Lê o balde do byte offset indicado
+ * @param fp Ponteiro para o arquivo
+ * @param offset Byte offset do balde
+ * @param balde Ponteiro para o balde
+ */
+void lerBaldeHash(FILE *fp, long long offset, BaldeHash *balde);
+
+#endif // HASH_EXTENSIVEL_H
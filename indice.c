@@ -0,0 +1,209 @@
+/**
+ * @file indice.c
+ * @brief Despacho das operações de índice para a árvore-B ou o hash extensível
+ */
+
+#include "indice.h"
+#include "wal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Busca e imprime um registro usando o índice informado
+ *
+ * Arquivos que não trazem o identificador do hash (inclusive os que não
+ * existem) seguem pelo caminho da árvore-B.
+ *
+ * @param dataFilename Nome do arquivo de dados
+ * @param indexFilename Nome do arquivo de índice
+ * @param id ID do registro a ser buscado
+ */
+void printRecordFromIndex(const char *dataFilename, const char *indexFilename, int id) {
+    if (ehIndiceHash(indexFilename)) {
+        printRecordFromHash(dataFilename, indexFilename, id);
+    } else {
+        printRecordFromBTree(dataFilename, indexFilename, id);
+    }
+}
+
+/**
+ * @brief Abre uma sessão sobre o índice, reconhecendo seu tipo
+ * @param indexFilename Nome do arquivo de índice
+ * @return Sessão aberta ou NULL em caso de falha
+ */
+SessaoIndice *indice_open(const char *indexFilename) {
+    if (!indexFilename) return NULL;
+
+    SessaoIndice *sessao = malloc(sizeof(SessaoIndice));
+    if (!sessao) return NULL;
+    sessao->arvore = NULL;
+    sessao->hash = NULL;
+
+    if (ehIndiceHash(indexFilename)) {
+        sessao->hash = hash_open(indexFilename);
+    } else {
+        sessao->arvore = btree_open(indexFilename);
+    }
+
+    if (!sessao->arvore && !sessao->hash) {
+        free(sessao);
+        return NULL;
+    }
+    return sessao;
+}
+
+/**
+ * @brief Insere uma chave no índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param byteOffset Byte offset do registro
+ * @return 1 se inserida, 0 caso contrário (o hash recusa um ID que já indexa)
+ */
+int indice_insert(SessaoIndice *sessao, int id, long long byteOffset) {
+    if (!sessao) return 0;
+    if (sessao->hash) return hash_session_insert(sessao->hash, id, byteOffset);
+    btree_session_insert(sessao->arvore, id, byteOffset);
+    return 1;
+}
+
+/**
+ * @brief Insere um lote de chaves no índice
+ *
+ * As chaves entram na ordem dada, da qual depende a forma da árvore-B. Um
+ * lote já crescente vai para btree_insert_batch, que reaproveita o caminho
+ * até a folha e monta a mesma árvore que as inserções uma a uma; fora disso,
+ * e no hash, a inserção é chave a chave.
+ *
+ * @param sessao Sessão aberta
+ * @param ids IDs dos registros
+ * @param offsets Byte offsets correspondentes
+ * @param n Número de chaves do lote
+ * @return 1 se todas as chaves foram inseridas, 0 caso contrário
+ */
+int indice_insert_batch(SessaoIndice *sessao, const int ids[], const long long offsets[], int n) {
+    if (!sessao) return 0;
+    bool crescente = true;
+    for (int i = 1; i < n && crescente; i++) crescente = ids[i - 1] < ids[i];
+
+    int todas = 1;
+    if (sessao->hash) {
+        for (int i = 0; i < n; i++) {
+            if (!hash_session_insert(sessao->hash, ids[i], offsets[i])) todas = 0;
+        }
+    } else if (crescente) {
+        btree_insert_batch(sessao->arvore, ids, offsets, n);
+    } else {
+        for (int i = 0; i < n; i++) btree_session_insert(sessao->arvore, ids[i], offsets[i]);
+    }
+    return todas;
+}
+
+/**
+ * @brief Remove uma chave do índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int indice_remove(SessaoIndice *sessao, int id) {
+    if (!sessao) return 0;
+    if (sessao->hash) return hash_session_remove(sessao->hash, id);
+    return btree_session_remove(sessao->arvore, id);
+}
+
+/**
+ * @brief Remove um conjunto de chaves do índice
+ *
+ * Na árvore-B as chaves saem todas em uma única poda (btree_session_remove_many);
+ * no hash cada chave custa um acesso ao seu balde, então são removidas uma a uma.
+ *
+ * @param sessao Sessão aberta
+ * @param ids IDs dos registros (em qualquer ordem)
+ * @param n Número de IDs
+ * @return Número de chaves removidas
+ */
+int indice_remove_many(SessaoIndice *sessao, const int ids[], int n) {
+    if (!sessao) return 0;
+    if (!sessao->hash) return btree_session_remove_many(sessao->arvore, ids, n);
+
+    int removidas = 0;
+    for (int i = 0; i < n; i++) removidas += hash_session_remove(sessao->hash, ids[i]);
+    return removidas;
+}
+
+/**
+ * @brief Busca uma chave no índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long indice_search(SessaoIndice *sessao, int id) {
+    if (!sessao) return -1;
+    if (sessao->hash) return hash_session_search(sessao->hash, id);
+    return btree_session_search(sessao->arvore, id);
+}
+
+/**
+ * @brief Byte offset da chave mais próxima de um ID, para inserções perto dos vizinhos
+ *
+ * Só a árvore-B guarda as chaves em ordem; com o índice hash não há vizinho.
+ *
+ * @param sessao Sessão aberta
+ * @param id ID de referência
+ * @return Byte offset da chave vizinha ou -1 se não houver
+ */
+long long indice_search_neighbor(SessaoIndice *sessao, int id) {
+    if (!sessao || sessao->hash) return -1;
+    return btree_session_search_neighbor(sessao->arvore, id);
+}
+
+/**
+ * @brief Atualiza o byte offset de uma chave do índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int indice_update_offset(SessaoIndice *sessao, int id, long long newOffset) {
+    if (!sessao) return 0;
+    if (sessao->hash) return hash_session_update_offset(sessao->hash, id, newOffset);
+    return btree_session_update_offset(sessao->arvore, id, newOffset);
+}
+
+/**
+ * @brief Fecha a sessão, deixando o índice consistente
+ * @param sessao Sessão aberta (liberada por esta função)
+ */
+void indice_close(SessaoIndice *sessao) {
+    if (!sessao) return;
+    if (sessao->hash) {
+        hash_close(sessao->hash);
+    } else {
+        btree_close(sessao->arvore);
+    }
+    free(sessao);
+}
+
+/**
+ * @brief Traduz todos os byte offsets do índice pelo mapa da compactação do arquivo de dados
+ *
+ * Passada única sobre as páginas (árvore-B) ou os baldes (hash), sem
+ * buscas por chave.
+ *
+ * @param indexFilename Nome do arquivo de índice
+ * @param antigos Offsets antigos, em ordem crescente
+ * @param novos Offsets novos correspondentes
+ * @param n Número de entradas do mapa
+ * @return Número de offsets alterados, -1 em caso de falha
+ */
+int indice_remap_offsets(const char *indexFilename, const long long antigos[], const long long novos[], int n) {
+    if (!indexFilename) return -1;
+
+    bool hash = ehIndiceHash(indexFilename);
+    FILE *fp = wal_fopen(indexFilename, "rb+");
+    if (!fp) return -1;
+
+    int alterados = hash ? hash_remap_offsets(fp, antigos, novos, n)
+                         : btree_remap_offsets(fp, antigos, novos, n);
+    fclose(fp);
+    return alterados;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file indice.h
+ * @brief Interface comum aos índices por idAttack (árvore-B ou hash extensível)
+ *
+ * O tipo do índice é reconhecido pelo cabeçalho do arquivo, de modo que
+ * as opções 8 a 11 funcionam com qualquer um dos dois.
+ */
+
+#ifndef INDICE_H
+#define INDICE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "arvore-b.h"
+#include "hash-extensivel.h"
+
+/**
+ * @brief Sessão aberta sobre um índice de qualquer tipo
+ */
+typedef struct {
+    SessaoArvoreB *arvore;    // Sessão da árvore-B (NULL se o índice for hash)
+    SessaoHash *hash;         // Sessão do índice hash (NULL se o índice for árvore-B)
+} SessaoIndice;
+
+/**
+ * @brief Busca e imprime um registro usando o índice informado
+ * @param dataFilename Nome do arquivo de dados
+ * @param indexFilename Nome do arquivo de índice
+ * @param id ID do registro a ser buscado
+ */
+void printRecordFromIndex(const char *dataFilename, const char *indexFilename, int id);
+
+/**
+ * @brief Abre uma sessão sobre o índice, reconhecendo seu tipo
+ * @param indexFilename Nome do arquivo de índice
+ * @return Sessão aberta ou NULL em caso de falha
+ */
+SessaoIndice *indice_open(const char *indexFilename);
+
+/**
+ * @brief Insere uma chave no índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param byteOffset Byte offset do registro
+ * @return 1 se inserida, 0 caso contrário (o hash recusa um ID que já indexa)
+ */
+int indice_insert(SessaoIndice *sessao, int id, long long byteOffset);
+
+/**
+ * @brief Insere um lote de chaves no índice, na ordem dada
+ * @param sessao Sessão aberta
+ * @param ids IDs dos registros
+ * @param offsets Byte offsets correspondentes
+ * @param n Número de chaves do lote
+ * @return 1 se todas as chaves foram inseridas, 0 caso contrário
+ */
+int indice_insert_batch(SessaoIndice *sessao, const int ids[], const long long offsets[], int n);
+
+/**
+ * @brief Remove uma chave do índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return 1 se removido com sucesso, 0 caso contrário
+ */
+int indice_remove(SessaoIndice *sessao, int id);
+
+/**
+ * @brief Remove um conjunto de chaves do índice
+ * @param sessao Sessão aberta
+ * @param ids IDs dos registros (em qualquer ordem)
+ * @param n Número de IDs
+ * @return Número de chaves removidas
+ */
+int indice_remove_many(SessaoIndice *sessao, const int ids[], int n);
+
+/**
+ * @brief Busca uma chave no índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @return Byte offset do registro ou -1 se não encontrado
+ */
+long long indice_search(SessaoIndice *sessao, int id);
+
+/**
+ * @brief Byte offset da chave mais próxima de um ID (só com árvore-B)
+ * @param sessao Sessão aberta
+ * @param id ID de referência
+ * @return Byte offset da chave vizinha ou -1 se não houver
+ */
+long long indice_search_neighbor(SessaoIndice *sessao, int id);
+
+/**
+ * @brief Atualiza o byte offset de uma chave do índice
+ * @param sessao Sessão aberta
+ * @param id ID do registro
+ * @param newOffset Novo byte offset
+ * @return 1 se atualizado com sucesso, 0 caso contrário
+ */
+int indice_update_offset(SessaoIndice *sessao, int id, long long newOffset);
+
+/**
+ * @brief Fecha a sessão, deixando o índice consistente
+ * @param sessao Sessão aberta (liberada por esta função)
+ */
+void indice_close(SessaoIndice *sessao);
+
+/**
+ * @brief Traduz todos os byte offsets do índice pelo mapa da compactação do arquivo de dados
+ * @param indexFilename Nome do arquivo de índice
+ * @param antigos Offsets antigos, em ordem crescente
+ * @param novos Offsets novos correspondentes
+ * @param n Número de entradas do mapa
+ * @return Número de offsets alterados, -1 em caso de falha
+ */
+int indice_remap_offsets(const char *indexFilename, const long long antigos[], const long long novos[], int n);
+
+#endif // INDICE_H
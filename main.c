@@ -5,6 +5,9 @@
 #include "binary_operations.h"
 #include "utils.h"
 #include "arvore-b.h"
+#include "arvore-bmais.h"
+#include "indice.h"
+#include "wal.h"
 
 /**
  * @brief Função principal para lidar com a entrada do usuário e executar opções.
@@ -83,6 +86,9 @@ int main() {
                 int repeatCount;
                 scanf("%d", &repeatCount);
 
+                // O lote inteiro passa pelo log de refazer e é confirmado de uma vez
+                wal_iniciar(binaryFile);
+
                 for (int r = 0; r < repeatCount; r++) {
                     int numCriteria;
                     scanf("%d", &numCriteria);
@@ -101,10 +107,12 @@ int main() {
                         }
                     }
 
-                    removed = deleteRecordByCriteria(binaryFile, numCriteria, criteria, values);
+                    removed = deleteRecordByCriteria(binaryFile, numCriteria, criteria, values, NULL);
                    
                 }
 
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
+
                 if (removed >= 0) {
                     binarioNaTela(binaryFile);
                 } else {
@@ -123,6 +131,10 @@ int main() {
                 int repeatCount;
                 scanf("%d", &repeatCount);
 
+                // Uma única sessão atende todo o lote: o arquivo é aberto e o cabeçalho gravado uma vez
+                wal_iniciar(binaryFile);
+                SessaoInsercao *sessao = openInsertSession(binaryFile);
+
                 for (int r = 0; r < repeatCount; r++) {
                     int id, year;
                     float financialLoss;
@@ -152,14 +164,17 @@ int main() {
                     scan_quote_string(targetIndustry);
                     scan_quote_string(defenseStrategy);
 
-                    // Chama a função de inserção para cada registro
-                    insertRecord(binaryFile, id, year, financialLoss,
+                    // Insere cada registro pela sessão
+                    insertRecordInSession(sessao, id, year, financialLoss,
                         (strcmp(country, "NULO") == 0 ? NULL : country),
                         (strcmp(attackType, "NULO") == 0 ? NULL : attackType),
                         (strcmp(targetIndustry, "NULO") == 0 ? NULL : targetIndustry),
                         (strcmp(defenseStrategy, "NULO") == 0 ? NULL : defenseStrategy));
                 }
 
+                closeInsertSession(sessao);
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
+
                 // Após inserção, exiba o binário na tela
                 binarioNaTela(binaryFile);
 
@@ -175,6 +190,8 @@ int main() {
                 int repeatCount;
                 scanf("%d", &repeatCount);
 
+                wal_iniciar(binaryFile);
+
                 for (int r = 0; r < repeatCount; r++) {
                     int numPairs;
                     scanf("%d", &numPairs);
@@ -213,9 +230,10 @@ int main() {
                     }
 
                     // Chama a função de atualização
-                    updateRecords(binaryFile, repeatCount, numPairs, criteria, values, numUpdates, updateFields, updateValues, NULL, 0);
+                    updateRecords(binaryFile, repeatCount, numPairs, criteria, values, numUpdates, updateFields, updateValues, NULL);
                 }
 
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
                 binarioNaTela(binaryFile);
 
                 return 0;
@@ -276,8 +294,8 @@ int main() {
 
                     // Decide qual tipo de busca usar
                     if (idAttack == 1) {
-                        // Usa busca por árvore-B para idAttack
-                        printRecordFromBTree(dataFile, btreeFile, idValue);
+                        // Usa o índice (árvore-B ou hash) para idAttack
+                        printRecordFromIndex(dataFile, btreeFile, idValue);
                     } else {
                         // Usa busca sequencial para outros critérios
                         sequentialSearch(dataFile, numCriteria, criteria, values);
@@ -296,19 +314,20 @@ int main() {
                 scanf("%s", btreeFile);
                 scanf("%d", &id);  // CORRIGIDO: %d ao invés de %lld
 
-                FILE *btreeFilePointer = fopen(btreeFile, "rb+");
-                if (!btreeFilePointer) {
+                // Sessão mantém o filtro de Bloom da árvore-B junto com a remoção
+                SessaoIndice *sessao = indice_open(btreeFile);
+                if (!sessao) {
                     printf("Falha ao abrir o arquivo de índice.\n");
                     return 0;
                 }
 
-                if (btree_remove(btreeFilePointer, id)) {
+                if (indice_remove(sessao, id)) {
                     printf("Registro removido com sucesso.\n");
                 } else {
                     printf("Registro inexistente.\n");
                 }
 
-                fclose(btreeFilePointer);
+                indice_close(sessao);
                 return 0;
                 break;
             }
@@ -324,6 +343,20 @@ int main() {
                 int repeatCount;
                 scanf("%d", &repeatCount);
 
+                int *ids = malloc((repeatCount > 0 ? repeatCount : 1) * sizeof(int));
+                long long *offsets = malloc((repeatCount > 0 ? repeatCount : 1) * sizeof(long long));
+                if (!ids || !offsets) {
+                    free(ids);
+                    free(offsets);
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                // Uma única sessão de inserção atende todo o lote; os offsets alimentam o índice depois.
+                // Dados e índice compartilham o log de refazer do lote
+                wal_iniciar(dataFile);
+                SessaoInsercao *sessao = openInsertSession(dataFile);
+
                 for (int r = 0; r < repeatCount; r++) {
                     int id, year;
                     float financialLoss;
@@ -353,18 +386,35 @@ int main() {
                     scan_quote_string(targetIndustry);
                     scan_quote_string(defenseStrategy);
 
-                    // Insere o registro no arquivo de dados e obtém o offset
-                    long long recordOffset = insertRecord(dataFile, id, year, financialLoss,
+                    // Insere o registro no arquivo de dados e guarda o offset
+                    ids[r] = id;
+                    offsets[r] = insertRecordInSession(sessao, id, year, financialLoss,
                         (strcmp(country, "NULO") == 0 ? NULL : country),
                         (strcmp(attackType, "NULO") == 0 ? NULL : attackType),
                         (strcmp(targetIndustry, "NULO") == 0 ? NULL : targetIndustry),
                         (strcmp(defenseStrategy, "NULO") == 0 ? NULL : defenseStrategy));
+                }
 
-                    // Se a inserção foi bem-sucedida, adiciona na árvore-B
-                    if (recordOffset != -1) {
-                        insertBtreeEntry(btreeFile, id, recordOffset);
+                closeInsertSession(sessao);
+
+                // Uma única sessão do índice recebe o lote de uma vez, na ordem das inserções; as que falharam ficam de fora
+                int inseridos = 0;
+                for (int r = 0; r < repeatCount; r++) {
+                    if (offsets[r] != -1) {
+                        ids[inseridos] = ids[r];
+                        offsets[inseridos] = offsets[r];
+                        inseridos++;
                     }
                 }
+                SessaoIndice *indice = indice_open(btreeFile);
+                if (indice ? !indice_insert_batch(indice, ids, offsets, inseridos) : inseridos > 0) {
+                    printf("Falha no processamento do arquivo.\n");
+                }
+
+                indice_close(indice);
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
+                free(ids);
+                free(offsets);
 
                 // Após inserção, exibe o binário na tela
                 binarioNaTela(dataFile);
@@ -374,6 +424,11 @@ int main() {
                 return 0;
                 break;
             }
+            case 27:
+                // Opção 27: Como a 11, mas as realocações deixam esboços encaminhando para a
+                // nova posição em vez de atualizar o índice (desfeitos pelas opções 22 e 23)
+                setForwarding(true);
+                // fall through
             case 11: {
                 // Opção 11: Atualização de registros com atualização da árvore-B (updateWBTree)
                 char dataFile[100], btreeFile[100];
@@ -383,6 +438,10 @@ int main() {
                 int repeatCount;
                 scanf("%d", &repeatCount);
 
+                // Uma única sessão do índice atende todas as atualizações, sob o log de refazer do lote
+                wal_iniciar(dataFile);
+                SessaoIndice *indice = indice_open(btreeFile);
+
                 for (int r = 0; r < repeatCount; r++) {
                     int numPairs;
                     scanf("%d", &numPairs);
@@ -421,9 +480,12 @@ int main() {
                     }
 
                     // Chama a função de atualização com atualização da árvore-B
-                    updateRecords(dataFile, repeatCount, numPairs, criteria, values, numUpdates, updateFields, updateValues, btreeFile, 1);
+                    updateRecords(dataFile, repeatCount, numPairs, criteria, values, numUpdates, updateFields, updateValues, indice);
                 }
 
+                indice_close(indice);
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
+
                 binarioNaTela(dataFile);
                 binarioNaTela(btreeFile); // Exibe o conteúdo da árvore-B
 
@@ -457,7 +519,7 @@ int main() {
                 char binaryFile[100];
                 scanf("%s", binaryFile);
 
-                FILE *file = fopen(binaryFile, "rb");
+                FILE *file = wal_fopen(binaryFile, "rb");
                 if (!file) {
                     printf("Falha no processamento do arquivo.\n");
                     return 0;
@@ -484,7 +546,303 @@ int main() {
                 return 0;
                 break;
             }
-            
+
+            case 16: {
+                // Opção 16: Constrói o índice árvore-B+ a partir do arquivo de dados
+                char dataFile[100], bplusFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", bplusFile);
+                buildBPlusTreeFromDataFile(dataFile, bplusFile);
+
+                binarioNaTela(bplusFile); // Exibe o conteúdo da árvore-B+
+                return 0;
+                break;
+            }
+
+            case 17: {
+                // Opção 17: Busca por intervalo de idAttack percorrendo as folhas da árvore-B+
+                char dataFile[100], bplusFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", bplusFile);
+
+                int repeatCount;
+                scanf("%d", &repeatCount);
+
+                for (int r = 0; r < repeatCount; r++) {
+                    int lo, hi;
+                    scanf("%d %d", &lo, &hi);
+                    printRecordsInRangeFromBPlusTree(dataFile, bplusFile, lo, hi);
+                }
+
+                return 0;
+                break;
+            }
+
+
+            case 18: {
+                // Opção 18: Compacta a árvore-B, regravando as páginas em ordem de chave
+                char btreeFile[100];
+                int fatorPreenchimento, layout;
+                scanf("%s", btreeFile);
+                scanf("%d %d", &fatorPreenchimento, &layout);
+
+                if (btree_compact(btreeFile, fatorPreenchimento, layout) != 1) {
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                binarioNaTela(btreeFile); // Exibe o conteúdo da árvore-B compactada
+                return 0;
+                break;
+            }
+
+            case 19: {
+                // Opção 19: Remove da árvore-B todas as chaves de um intervalo de idAttack
+                // Como a opção 9, atua só sobre o índice: os registros do arquivo de dados
+                // continuam ativos (para excluí-los junto com as chaves, use a opção 21)
+                char btreeFile[100];
+                int lo, hi;
+                scanf("%s", btreeFile);
+                scanf("%d %d", &lo, &hi);
+
+                // As páginas regravadas pela poda passam pelo log de refazer do lote
+                wal_iniciar(btreeFile);
+                FILE *btreeFilePointer = wal_fopen(btreeFile, "rb+");
+                if (!btreeFilePointer) {
+                    wal_encerrar();
+                    printf("Falha ao abrir o arquivo de índice.\n");
+                    return 0;
+                }
+
+                int removidas = btree_remove_range(btreeFilePointer, lo, hi);
+                fclose(btreeFilePointer);
+                if (!wal_encerrar() || removidas < 0) {
+                    printf("Falha no processamento do arquivo.\n");
+                } else if (removidas > 0) {
+                    printf("%d registros removidos.\n", removidas);
+                } else {
+                    printf("Registro inexistente.\n");
+                }
+                return 0;
+                break;
+            }
+
+            case 20: {
+                // Opção 20: Constrói o índice hash extensível a partir do arquivo de dados
+                char dataFile[100], hashFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", hashFile);
+                buildHashFromDataFile(dataFile, hashFile);
+
+                binarioNaTela(hashFile); // Exibe o conteúdo do índice hash
+                return 0;
+                break;
+            }            
+
+            case 21: {
+                // Opção 21: Exclui registros com múltiplos critérios mantendo o índice (árvore-B ou hash)
+                char dataFile[100], indexFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", indexFile);
+
+                int repeatCount;
+                scanf("%d", &repeatCount);
+
+                // Uma única sessão do índice atende todo o lote de remoções, sob o log de refazer do lote
+                wal_iniciar(dataFile);
+                SessaoIndice *indice = indice_open(indexFile);
+                if (!indice) {
+                    wal_encerrar();
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                int removed = 0;
+                for (int r = 0; r < repeatCount; r++) {
+                    int numCriteria;
+                    scanf("%d", &numCriteria);
+
+                    char criteria[3][256];
+                    char values[3][256];
+                    for (int i = 0; i < numCriteria; i++) {
+                        scanf("%s", criteria[i]);
+                        if (strcmp(criteria[i], "country") == 0 ||
+                            strcmp(criteria[i], "targetIndustry") == 0 ||
+                            strcmp(criteria[i], "defenseMechanism") == 0 ||
+                            strcmp(criteria[i], "attackType") == 0) {
+                            scan_quote_string(values[i]);
+                        } else {
+                            scanf("%s", values[i]);
+                        }
+                    }
+
+                    // Com idAttack entre os critérios, localiza pelo índice; senão, varre o arquivo
+                    removed = deleteRecordByCriteria(dataFile, numCriteria, criteria, values, indice);
+                }
+
+                indice_close(indice);
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
+
+                if (removed >= 0) {
+                    binarioNaTela(dataFile);
+                    binarioNaTela(indexFile);
+                } else {
+                    printf("Falha ao remover registro(s).\n");
+                }
+
+                fflush(stdout);
+                return 0;
+                break;
+            }
+
+            case 22: {
+                // Opção 22: Compacta o arquivo de dados (VACUUM) e traduz os offsets do índice
+                char dataFile[100], indexFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", indexFile);
+
+                if (vacuumDataFile(dataFile, indexFile) < 0) {
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                binarioNaTela(dataFile);
+                binarioNaTela(indexFile);
+                return 0;
+                break;
+            }
+
+            case 23: {
+                // Opção 23: Um passo de compactação incremental do arquivo de dados, mantendo o índice
+                char dataFile[100], indexFile[100];
+                int maxRegistros;
+                double limiarRemovidos, limiarLixo;
+                scanf("%s", dataFile);
+                scanf("%s", indexFile);
+                scanf("%d %lf %lf", &maxRegistros, &limiarRemovidos, &limiarLixo);
+
+                SessaoIndice *indice = indice_open(indexFile);
+                if (!indice) {
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                // Sem limiares o passo é executado sempre; com eles, só se algum for alcançado
+                int movidos;
+                if (limiarRemovidos <= 0 && limiarLixo <= 0) {
+                    movidos = compactDataFileStep(dataFile, indice, maxRegistros);
+                } else {
+                    setCompactionThresholds(limiarRemovidos, limiarLixo, maxRegistros);
+                    movidos = compactDataFileIfNeeded(dataFile, indice);
+                }
+                indice_close(indice);
+
+                if (movidos < 0) {
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                binarioNaTela(dataFile);
+                binarioNaTela(indexFile);
+                return 0;
+                break;
+            }
+
+            case 24: {
+                // Opção 24: Gera o arquivo binário reservando folga de crescimento em cada registro
+                double folgaPercentual;
+                int folgaBytes;
+                scanf("%s", inputFile);
+                scanf("%s", binaryFile);
+                scanf("%lf %d", &folgaPercentual, &folgaBytes);
+
+                setGrowthSlack(folgaPercentual, folgaBytes);
+                if (generateBinaryFile(inputFile, binaryFile) == 0) {
+                    binarioNaTela(binaryFile);
+                }
+                return 0;
+                break;
+            }
+
+            case 25: {
+                // Opção 25: Reescreve o arquivo de dados em ordem de idAttack (CLUSTER) e traduz o índice
+                char dataFile[100], indexFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", indexFile);
+
+                if (clusterDataFile(dataFile, indexFile) < 0) {
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                binarioNaTela(dataFile);
+                binarioNaTela(indexFile);
+                return 0;
+                break;
+            }
+
+            case 26: {
+                // Opção 26: Inserção com índice preferindo espaço livre perto do registro de ID vizinho
+                char dataFile[100], indexFile[100];
+                scanf("%s", dataFile);
+                scanf("%s", indexFile);
+
+                int repeatCount;
+                scanf("%d", &repeatCount);
+
+                // O índice fica aberto durante as inserções: cada uma procura o vizinho antes de gravar
+                wal_iniciar(dataFile);
+                SessaoIndice *indice = indice_open(indexFile);
+                SessaoInsercao *sessao = indice ? openInsertSession(dataFile) : NULL;
+                if (!sessao) {
+                    indice_close(indice);
+                    wal_encerrar();
+                    printf("Falha no processamento do arquivo.\n");
+                    return 0;
+                }
+
+                for (int r = 0; r < repeatCount; r++) {
+                    int id, year;
+                    float financialLoss;
+                    char country[256], attackType[256], targetIndustry[256], defenseStrategy[256];
+
+                    scanf("%d", &id);
+
+                    // Leitura dos campos year e financialLoss (podem ser NULO)
+                    char yearStr[32], lossStr[32];
+                    scanf("%s", yearStr);
+                    year = strcmp(yearStr, "NULO") == 0 ? -1 : atoi(yearStr);
+                    scanf("%s", lossStr);
+                    financialLoss = strcmp(lossStr, "NULO") == 0 ? -1.0f : atof(lossStr);
+
+                    // Leitura dos campos string (podem ser NULO)
+                    scan_quote_string(country);
+                    scan_quote_string(attackType);
+                    scan_quote_string(targetIndustry);
+                    scan_quote_string(defenseStrategy);
+
+                    long long vizinho = indice_search_neighbor(indice, id);
+                    long long offset = insertRecordNearInSession(sessao, vizinho, id, year, financialLoss,
+                        (strcmp(country, "NULO") == 0 ? NULL : country),
+                        (strcmp(attackType, "NULO") == 0 ? NULL : attackType),
+                        (strcmp(targetIndustry, "NULO") == 0 ? NULL : targetIndustry),
+                        (strcmp(defenseStrategy, "NULO") == 0 ? NULL : defenseStrategy));
+                    if (offset != -1 && !indice_insert(indice, id, offset)) {
+                        printf("Falha no processamento do arquivo.\n");
+                    }
+                }
+
+                closeInsertSession(sessao);
+                indice_close(indice);
+                if (!wal_encerrar()) printf("Falha no processamento do arquivo.\n");
+
+                binarioNaTela(dataFile);
+                binarioNaTela(indexFile);
+
+                fflush(stdout);
+                return 0;
+                break;
+            }
             default:
                 // Opção inválida
                 printf("Invalid choice. Please try again.\n");
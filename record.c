@@ -108,11 +108,12 @@ int readRecord(FILE *file, Record *record) {
 
     // Lê caracteres até encontrar um caractere diferente de '$'
     char c;
-    while (fread(&c, sizeof(char), 1, file) == 1 && c == '$') {
+    size_t lido;
+    while ((lido = fread(&c, sizeof(char), 1, file)) == 1 && c == '$') {
         // Continua lendo enquanto for '$'
     }
-    if (c != '$') {
-        // Volta 1 byte se encontrou um caractere diferente de '$'
+    if (lido == 1) {
+        // Volta 1 byte se encontrou um caractere diferente de '$' (no fim do arquivo, nada foi lido)
         fseek(file, -1, SEEK_CUR);
     }
     
@@ -123,6 +124,40 @@ int readRecord(FILE *file, Record *record) {
 
 
 
+/**
+ * @brief Lê o registro em um byte offset dado por um índice, seguindo os encaminhamentos.
+ *
+ * Um registro realocado no modo de encaminhamento deixa no lugar antigo um
+ * esboço (removido REGISTRO_ENCAMINHADO, nova posição em prox), para o qual
+ * os índices continuam apontando até a próxima compactação.
+ *
+ * @param file Ponteiro para o arquivo binário.
+ * @param offset Byte offset de partida; recebe o offset do registro lido.
+ * @param record Ponteiro para a estrutura onde os dados serão armazenados.
+ * @return 1 em caso de sucesso, 0 em caso de falha.
+ */
+int readRecordFollowing(FILE *file, long long *offset, Record *record) {
+    for (int saltos = 0; saltos <= MAX_ENCAMINHAMENTOS; saltos++) {
+        if (fseek(file, *offset, SEEK_SET) != 0 || !readRecord(file, record)) {
+            return 0;
+        }
+        if (record->removido != REGISTRO_ENCAMINHADO) {
+            return 1;
+        }
+
+        *offset = record->prox;
+        free(record->country);
+        free(record->attackType);
+        free(record->targetIndustry);
+        free(record->defenseStrategy);
+    }
+    return 0;
+}
+
+
+
+
+
 /**
  * @brief Escreve um array de tamanho variável em um arquivo binário.
  *
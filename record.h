@@ -5,6 +5,15 @@
 
 #define MAX_FIELD 256 // Added definition for MAX_FIELD
 
+// Posição dos campos fixos a partir do início do registro
+#define OFFSET_ID 13              // removido (1) + tamanhoRegistro (4) + prox (8)
+#define OFFSET_YEAR 17
+#define OFFSET_FINANCIAL_LOSS 21
+
+// Registro realocado no modo de encaminhamento: o lugar antigo vira um esboço cujo prox aponta para a nova posição
+#define REGISTRO_ENCAMINHADO '2'
+#define MAX_ENCAMINHAMENTOS 1024  // Esboços seguidos por readRecordFollowing antes de desistir
+
 typedef struct {
     char removido;
     int tamanhoRegistro;
@@ -20,6 +29,7 @@ typedef struct {
 
 void printRecord(Record record);
 int readRecord(FILE *file, Record *record);
+int readRecordFollowing(FILE *file, long long *offset, Record *record);
 void writeVariableArray(FILE *file, const char *array, char index);
 int readVariableArray(FILE *file, char *buffer, int expectedIndex);
 void writeRecord(FILE *file, const Record *record);
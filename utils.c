@@ -287,3 +287,26 @@ void fillWithTrash(FILE *file, int count) {
     }
 }
 
+
+/**
+ * @brief Traduz um byte offset antigo pelo mapa gerado na compactação do arquivo de dados.
+ *
+ * Os offsets antigos estão em ordem crescente (ordem de varredura do arquivo),
+ * de modo que a busca é binária.
+ *
+ * @param antigos Offsets antigos, em ordem crescente.
+ * @param novos Offsets novos correspondentes.
+ * @param n Número de entradas do mapa.
+ * @param antigo Offset a traduzir.
+ * @return Offset novo ou -1 se o offset não pertence a um registro ativo.
+ */
+long long remapearOffset(const long long antigos[], const long long novos[], int n, long long antigo) {
+    int lo = 0, hi = n - 1;
+    while (lo <= hi) {
+        int meio = lo + (hi - lo) / 2;
+        if (antigos[meio] == antigo) return novos[meio];
+        if (antigos[meio] < antigo) lo = meio + 1;
+        else hi = meio - 1;
+    }
+    return -1;
+}
@@ -14,5 +14,6 @@ long find_last_removed(FILE *fp, long header_topo);
 int calculateRecordSize(const Record *record);
 int matchRecord(const Record *record, int numCriteria, char criteria[3][256], char values[3][256]);
 void fillWithTrash(FILE *file, int fillBytes); // Declaration of fillWithTrash
+long long remapearOffset(const long long antigos[], const long long novos[], int n, long long antigo);
 
 #endif // UTILS_H
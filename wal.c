@@ -0,0 +1,849 @@
+/**
+ * @file wal.c
+ * @brief Log de refazer com confirmação em grupo para o arquivo de dados e o índice
+ *
+ * Os arquivos do lote são expostos como FILE (fopencookie), de modo que o
+ * código que lê e grava registros, páginas da árvore-B e baldes do hash não
+ * muda: os fflush espalhados por ele passam a copiar bytes para as páginas
+ * em memória, e só wal_confirmar e o checkpoint chegam ao disco.
+ */
+
+#define _GNU_SOURCE
+#include "wal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define NRO_BALDES_WAL 4096   // Baldes da tabela de páginas de cada arquivo
+#define LIMITE_PAGINAS_WAL 1024  // Imagens de página em memória antes de descarregar um grupo no log
+
+/**
+ * @brief Página de um arquivo do lote
+ *
+ * Depois de descarregada no log, a imagem sai da memória e as leituras
+ * a buscam no log, até que uma nova escrita a traga de volta.
+ */
+typedef struct PaginaWal {
+    long long numero;                  // Número da página (offset / TAM_PAGINA_WAL)
+    bool pendente;                     // Alterada desde a última gravação no log
+    long long offsetLog;               // Posição no log da última imagem gravada (-1 se nenhuma)
+    int bytesLog;                      // Bytes válidos dessa imagem
+    unsigned char *dados;              // Imagem em memória (NULL se está só no log)
+    struct PaginaWal *proxima;         // Próxima página no mesmo balde
+} PaginaWal;
+
+/**
+ * @brief Arquivo do lote
+ */
+typedef struct {
+    char *nome;
+    int fd;
+    int id;                            // Identificador do arquivo no log
+    long long tamanho;                 // Tamanho lógico, com as escritas do lote
+    long long tamanhoDisco;            // Tamanho no disco
+    PaginaWal *baldes[NRO_BALDES_WAL];
+    bool noLog;                        // Registro 'A' já gravado no log atual
+    bool truncado;                     // Truncado no lote; o disco só é truncado no checkpoint
+    bool truncamentoPendente;          // Truncamento ainda não confirmado no log
+} ArquivoWal;
+
+/**
+ * @brief Lote ativo
+ */
+typedef struct {
+    FILE *log;
+    char *nomeLog;
+    ArquivoWal *arquivos[MAX_ARQUIVOS_WAL];
+    int nroArquivos;
+    int nroPendentes;                  // Páginas alteradas desde a última gravação no log
+    int nroResidentes;                 // Páginas com a imagem em memória
+    long long tamanhoLog;
+    uint32_t soma;                     // FNV-1a dos registros do grupo em andamento
+    int paginasGrupo;                  // Páginas já gravadas no grupo em andamento
+    bool gruposAbertos;                // Grupos descarregados depois do último fim de operação
+    bool confirmado;                   // Fim de operação no log ainda não aplicado pelo checkpoint
+    bool falhou;                       // Uma escrita do lote se perdeu: a operação não pode ser confirmada
+} LogRefazer;
+
+/**
+ * @brief Posição de um FILE aberto sobre um arquivo do lote
+ */
+typedef struct {
+    ArquivoWal *arquivo;
+    long long posicao;
+} CursorWal;
+
+static LogRefazer *logAtivo = NULL;
+
+// ================= FUNÇÕES AUXILIARES =================
+
+/**
+ * @brief Acumula bytes na soma FNV-1a
+ */
+static uint32_t somarBytes(uint32_t soma, const void *bytes, size_t n) {
+    const unsigned char *p = bytes;
+    for (size_t i = 0; i < n; i++) {
+        soma ^= p[i];
+        soma *= 16777619u;
+    }
+    return soma;
+}
+
+/**
+ * @brief Nome do log: "<dados>.wal"
+ */
+static char *nomeArquivoLog(const char *binaryFile) {
+    size_t tamanho = strlen(binaryFile) + 5;
+    char *nome = malloc(tamanho);
+    if (nome) snprintf(nome, tamanho, "%s.wal", binaryFile);
+    return nome;
+}
+
+/**
+ * @brief Grava bytes de um registro do grupo no log, acumulando a soma
+ */
+static bool gravarNoLog(LogRefazer *wal, const void *bytes, size_t n) {
+    wal->soma = somarBytes(wal->soma, bytes, n);
+    wal->tamanhoLog += n;
+    return fwrite(bytes, 1, n, wal->log) == n;
+}
+
+/**
+ * @brief Bytes válidos da página, limitados pelo tamanho lógico do arquivo
+ */
+static int bytesValidos(long long numero, long long tamanho) {
+    long long resto = tamanho - numero * TAM_PAGINA_WAL;
+    if (resto <= 0) return 0;
+    return resto < TAM_PAGINA_WAL ? (int)resto : TAM_PAGINA_WAL;
+}
+
+/**
+ * @brief Grava todos os bytes em uma posição do descritor
+ */
+static bool gravarEm(int fd, const void *bytes, size_t n, long long offset) {
+    const unsigned char *p = bytes;
+    while (n > 0) {
+        ssize_t gravados = pwrite(fd, p, n, offset);
+        if (gravados <= 0) return false;
+        p += gravados;
+        n -= gravados;
+        offset += gravados;
+    }
+    return true;
+}
+
+// ================= GRUPOS NO LOG =================
+
+/**
+ * @brief Grava o registro 'A' do arquivo, se ainda não estiver no log atual
+ */
+static bool citarArquivo(LogRefazer *wal, ArquivoWal *arquivo) {
+    if (arquivo->noLog) return true;
+    int tamanhoNome = strlen(arquivo->nome);
+    arquivo->noLog = true;
+    return gravarNoLog(wal, "A", 1) &&
+           gravarNoLog(wal, &arquivo->id, sizeof(int)) &&
+           gravarNoLog(wal, &tamanhoNome, sizeof(int)) &&
+           gravarNoLog(wal, arquivo->nome, tamanhoNome);
+}
+
+/**
+ * @brief Grava no log os truncamentos e as páginas pendentes, fechados por um registro 'C'
+ *
+ * Cada página guarda onde sua imagem ficou no log, para ser lida de lá
+ * depois que sair da memória.
+ */
+static bool gravarGrupo(LogRefazer *wal) {
+    bool ok = true;
+    for (int i = 0; i < wal->nroArquivos; i++) {
+        ArquivoWal *arquivo = wal->arquivos[i];
+
+        // O truncamento vem antes das páginas: elas nunca passam do novo tamanho
+        if (arquivo->truncamentoPendente) {
+            ok = ok && citarArquivo(wal, arquivo) &&
+                 gravarNoLog(wal, "T", 1) &&
+                 gravarNoLog(wal, &arquivo->id, sizeof(int)) &&
+                 gravarNoLog(wal, &arquivo->tamanho, sizeof(long long));
+            arquivo->truncamentoPendente = false;
+        }
+
+        for (int b = 0; b < NRO_BALDES_WAL; b++) {
+            for (PaginaWal *pag = arquivo->baldes[b]; pag; pag = pag->proxima) {
+                if (!pag->pendente) continue;
+
+                ok = ok && citarArquivo(wal, arquivo);
+                int validos = bytesValidos(pag->numero, arquivo->tamanho);
+                ok = ok && gravarNoLog(wal, "P", 1) &&
+                     gravarNoLog(wal, &arquivo->id, sizeof(int)) &&
+                     gravarNoLog(wal, &pag->numero, sizeof(long long)) &&
+                     gravarNoLog(wal, &arquivo->tamanho, sizeof(long long)) &&
+                     gravarNoLog(wal, &validos, sizeof(int));
+                pag->offsetLog = wal->tamanhoLog;
+                pag->bytesLog = validos;
+                ok = ok && gravarNoLog(wal, pag->dados, validos);
+                pag->pendente = false;
+                wal->paginasGrupo++;
+            }
+        }
+    }
+
+    // Registro de confirmação: fecha o grupo com sua soma, fora dela
+    uint32_t soma = wal->soma;
+    ok = ok && fwrite("C", 1, 1, wal->log) == 1 &&
+         fwrite(&wal->paginasGrupo, sizeof(int), 1, wal->log) == 1 &&
+         fwrite(&soma, sizeof(uint32_t), 1, wal->log) == 1;
+    wal->tamanhoLog += 1 + sizeof(int) + sizeof(uint32_t);
+
+    wal->nroPendentes = 0;
+    wal->paginasGrupo = 0;
+    wal->soma = 2166136261u;
+    return ok;
+}
+
+/**
+ * @brief Descarrega no log o grupo em andamento e tira da memória as imagens de página
+ *
+ * O grupo não leva o registro de fim de operação: se o lote for
+ * interrompido antes dele, a recuperação o descarta.
+ */
+static bool descarregarGrupo(LogRefazer *wal) {
+    if (wal->falhou) return false;
+    if (!gravarGrupo(wal) || fflush(wal->log) != 0) {
+        wal->falhou = true;
+        return false;
+    }
+    wal->gruposAbertos = true;
+
+    for (int i = 0; i < wal->nroArquivos; i++) {
+        for (int b = 0; b < NRO_BALDES_WAL; b++) {
+            for (PaginaWal *pag = wal->arquivos[i]->baldes[b]; pag; pag = pag->proxima) {
+                free(pag->dados);
+                pag->dados = NULL;
+            }
+        }
+    }
+    wal->nroResidentes = 0;
+    return true;
+}
+
+// ================= PÁGINAS EM MEMÓRIA =================
+
+/**
+ * @brief Página do lote, se houver
+ */
+static PaginaWal *buscarPagina(ArquivoWal *arquivo, long long numero) {
+    PaginaWal *pag = arquivo->baldes[numero % NRO_BALDES_WAL];
+    while (pag && pag->numero != numero) pag = pag->proxima;
+    return pag;
+}
+
+/**
+ * @brief Copia bytes da imagem de uma página, em memória ou no log
+ */
+static bool lerImagem(PaginaWal *pag, void *destino, int inicio, size_t n) {
+    if (pag->dados) {
+        memcpy(destino, pag->dados + inicio, n);
+        return true;
+    }
+
+    // Além dos bytes gravados no log, a página é zerada
+    size_t doLog = inicio < pag->bytesLog ? (size_t)(pag->bytesLog - inicio) : 0;
+    if (doLog > n) doLog = n;
+    if (doLog > 0 && pread(fileno(logAtivo->log), destino, doLog, pag->offsetLog + inicio) != (ssize_t)doLog) {
+        return false;
+    }
+    memset((unsigned char *)destino + doLog, 0, n - doLog);
+    return true;
+}
+
+/**
+ * @brief Imagem de página em memória; sem memória, descarrega antes o grupo em andamento
+ */
+static unsigned char *alocarImagem(void) {
+    if (logAtivo->nroResidentes >= LIMITE_PAGINAS_WAL && !descarregarGrupo(logAtivo)) return NULL;
+    unsigned char *dados = malloc(TAM_PAGINA_WAL);
+    if (!dados && logAtivo->nroResidentes > 0 && descarregarGrupo(logAtivo)) dados = malloc(TAM_PAGINA_WAL);
+    if (dados) logAtivo->nroResidentes++;
+    return dados;
+}
+
+/**
+ * @brief Página com a imagem em memória, carregada do log ou do disco se preciso
+ */
+static PaginaWal *obterPagina(ArquivoWal *arquivo, long long numero) {
+    PaginaWal *pag = buscarPagina(arquivo, numero);
+    if (pag && pag->dados) return pag;
+
+    unsigned char *dados = alocarImagem();
+    if (!dados) return NULL;
+
+    if (pag) {
+        if (!lerImagem(pag, dados, 0, TAM_PAGINA_WAL)) {
+            free(dados);
+            logAtivo->nroResidentes--;
+            return NULL;
+        }
+        pag->dados = dados;
+        return pag;
+    }
+
+    pag = malloc(sizeof(PaginaWal));
+    memset(dados, 0, TAM_PAGINA_WAL);
+    int noDisco = bytesValidos(numero, arquivo->tamanhoDisco);
+    if (!pag || (noDisco > 0 && pread(arquivo->fd, dados, noDisco, numero * TAM_PAGINA_WAL) != noDisco)) {
+        free(pag);
+        free(dados);
+        logAtivo->nroResidentes--;
+        return NULL;
+    }
+    pag->numero = numero;
+    pag->pendente = false;
+    pag->offsetLog = -1;
+    pag->bytesLog = 0;
+    pag->dados = dados;
+
+    int balde = numero % NRO_BALDES_WAL;
+    pag->proxima = arquivo->baldes[balde];
+    arquivo->baldes[balde] = pag;
+    return pag;
+}
+
+/**
+ * @brief Libera as páginas do arquivo
+ */
+static void liberarPaginas(ArquivoWal *arquivo) {
+    for (int i = 0; i < NRO_BALDES_WAL; i++) {
+        PaginaWal *pag = arquivo->baldes[i];
+        while (pag) {
+            PaginaWal *proxima = pag->proxima;
+            free(pag->dados);
+            free(pag);
+            pag = proxima;
+        }
+        arquivo->baldes[i] = NULL;
+    }
+}
+
+// ================= FILE SOBRE AS PÁGINAS =================
+
+static ssize_t lerCursor(void *cookie, char *buffer, size_t n) {
+    CursorWal *cursor = cookie;
+    ArquivoWal *arquivo = cursor->arquivo;
+    size_t lidos = 0;
+
+    while (lidos < n && cursor->posicao < arquivo->tamanho) {
+        long long numero = cursor->posicao / TAM_PAGINA_WAL;
+        int inicio = cursor->posicao % TAM_PAGINA_WAL;
+        size_t parte = TAM_PAGINA_WAL - inicio;
+        if (parte > n - lidos) parte = n - lidos;
+        if ((long long)parte > arquivo->tamanho - cursor->posicao) parte = arquivo->tamanho - cursor->posicao;
+
+        PaginaWal *pag = buscarPagina(arquivo, numero);
+        if (pag) {
+            if (!lerImagem(pag, buffer + lidos, inicio, parte)) break;
+        } else if (cursor->posicao >= arquivo->tamanhoDisco) {
+            // Além do que resta no disco (truncado no lote) não há dados
+            memset(buffer + lidos, 0, parte);
+        } else {
+            // Páginas que o lote não alterou estão iguais no disco
+            if ((long long)parte > arquivo->tamanhoDisco - cursor->posicao) parte = arquivo->tamanhoDisco - cursor->posicao;
+            ssize_t r = pread(arquivo->fd, buffer + lidos, parte, cursor->posicao);
+            if (r <= 0) break;
+            parte = r;
+        }
+        lidos += parte;
+        cursor->posicao += parte;
+    }
+    return lidos;
+}
+
+static ssize_t gravarCursor(void *cookie, const char *buffer, size_t n) {
+    CursorWal *cursor = cookie;
+    ArquivoWal *arquivo = cursor->arquivo;
+    size_t gravados = 0;
+
+    while (gravados < n) {
+        long long numero = cursor->posicao / TAM_PAGINA_WAL;
+        int inicio = cursor->posicao % TAM_PAGINA_WAL;
+        size_t parte = TAM_PAGINA_WAL - inicio;
+        if (parte > n - gravados) parte = n - gravados;
+
+        // Uma escrita perdida deixaria a operação pela metade: o lote não será confirmado
+        PaginaWal *pag = obterPagina(arquivo, numero);
+        if (!pag) {
+            logAtivo->falhou = true;
+            break;
+        }
+        memcpy(pag->dados + inicio, buffer + gravados, parte);
+        if (!pag->pendente) {
+            pag->pendente = true;
+            logAtivo->nroPendentes++;
+        }
+
+        gravados += parte;
+        cursor->posicao += parte;
+        if (cursor->posicao > arquivo->tamanho) arquivo->tamanho = cursor->posicao;
+    }
+    return gravados > 0 ? (ssize_t)gravados : -1;
+}
+
+static int posicionarCursor(void *cookie, off64_t *offset, int origem) {
+    CursorWal *cursor = cookie;
+    long long base = 0;
+    if (origem == SEEK_CUR) base = cursor->posicao;
+    else if (origem == SEEK_END) base = cursor->arquivo->tamanho;
+    if (base + *offset < 0) return -1;
+
+    cursor->posicao = base + *offset;
+    *offset = cursor->posicao;
+    return 0;
+}
+
+static int fecharCursor(void *cookie) {
+    // As páginas pertencem ao lote e continuam em memória até o checkpoint
+    free(cookie);
+    return 0;
+}
+
+/**
+ * @brief Arquivo do lote com o nome dado, aberto na primeira vez em que é pedido
+ */
+static ArquivoWal *obterArquivo(const char *nome) {
+    for (int i = 0; i < logAtivo->nroArquivos; i++) {
+        if (strcmp(logAtivo->arquivos[i]->nome, nome) == 0) return logAtivo->arquivos[i];
+    }
+    if (logAtivo->nroArquivos == MAX_ARQUIVOS_WAL) return NULL;
+
+    // Um log de outro lote interrompido, alcançado pelo nome deste arquivo, é refeito antes
+    char *vinculo = nomeArquivoLog(nome);
+    if (!vinculo) return NULL;
+    bool proprio = strcmp(vinculo, logAtivo->nomeLog) == 0;
+    if (!proprio && wal_recuperar(nome) < 0) {
+        free(vinculo);
+        return NULL;
+    }
+
+    int fd = open(nome, O_RDWR);
+    if (fd < 0) {
+        free(vinculo);
+        return NULL;
+    }
+    struct stat info;
+    ArquivoWal *arquivo = calloc(1, sizeof(ArquivoWal));
+    if (!arquivo || fstat(fd, &info) != 0 || !(arquivo->nome = strdup(nome))) {
+        free(arquivo);
+        free(vinculo);
+        close(fd);
+        return NULL;
+    }
+
+    arquivo->fd = fd;
+    arquivo->id = logAtivo->nroArquivos;
+    arquivo->tamanho = info.st_size;
+    arquivo->tamanhoDisco = info.st_size;
+    logAtivo->arquivos[logAtivo->nroArquivos++] = arquivo;
+
+    // Os demais arquivos ganham "<arquivo>.wal" como outro nome do log, de modo
+    // que abrir só o índice também encontra o que houver a refazer
+    if (!proprio) link(logAtivo->nomeLog, vinculo);
+    free(vinculo);
+    return arquivo;
+}
+
+// ================= LOTE =================
+
+/**
+ * @brief Inicia um lote com log de refazer para o arquivo de dados
+ * @param binaryFile Nome do arquivo de dados
+ * @return true se o log foi criado
+ */
+bool wal_iniciar(const char *binaryFile) {
+    if (logAtivo || !binaryFile) return false;
+
+    // Um log deixado por um lote interrompido é refeito antes de qualquer leitura
+    if (wal_recuperar(binaryFile) < 0) return false;
+
+    LogRefazer *wal = calloc(1, sizeof(LogRefazer));
+    if (!wal) return false;
+    wal->nomeLog = nomeArquivoLog(binaryFile);
+    wal->log = wal->nomeLog ? fopen(wal->nomeLog, "wb+") : NULL;
+    if (!wal->log) {
+        free(wal->nomeLog);
+        free(wal);
+        return false;
+    }
+
+    fwrite(IDENTIFICADOR_WAL, 1, 4, wal->log);
+    wal->tamanhoLog = 4;
+    wal->soma = 2166136261u;
+    logAtivo = wal;
+    return true;
+}
+
+/**
+ * @brief Abre um arquivo do lote
+ * @param nome Nome do arquivo
+ * @param modo Modo de abertura
+ * @return Arquivo aberto ou NULL em caso de falha
+ */
+FILE *wal_fopen(const char *nome, const char *modo) {
+    if (!logAtivo) {
+        // Fora de um lote, o arquivo só é aberto depois de refeito o que ficou no log
+        if (wal_recuperar(nome) < 0) return NULL;
+        return fopen(nome, modo);
+    }
+    bool recriar = strcmp(modo, "wb") == 0 || strcmp(modo, "wb+") == 0;
+    if (!recriar && strcmp(modo, "rb") != 0 && strcmp(modo, "rb+") != 0) {
+        return fopen(nome, modo);
+    }
+
+    // Um arquivo inexistente é criado vazio já; esvaziar um existente passa pelo log
+    if (recriar) {
+        int fd = open(nome, O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) return NULL;
+        close(fd);
+    }
+
+    ArquivoWal *arquivo = obterArquivo(nome);
+    if (arquivo && recriar && !wal_truncar(nome, 0)) arquivo = NULL;
+    CursorWal *cursor = arquivo ? malloc(sizeof(CursorWal)) : NULL;
+    if (!cursor) return NULL;
+    cursor->arquivo = arquivo;
+    cursor->posicao = 0;
+
+    cookie_io_functions_t funcoes = {
+        .read = lerCursor,
+        .write = gravarCursor,
+        .seek = posicionarCursor,
+        .close = fecharCursor
+    };
+    FILE *fp = fopencookie(cursor, modo, funcoes);
+    if (!fp) free(cursor);
+    return fp;
+}
+
+/**
+ * @brief Trunca um arquivo do lote
+ * @param nome Nome do arquivo
+ * @param tamanho Novo tamanho
+ * @return true em caso de sucesso
+ */
+bool wal_truncar(const char *nome, long long tamanho) {
+    if (!logAtivo) return truncate(nome, tamanho) == 0;
+
+    ArquivoWal *arquivo = obterArquivo(nome);
+    if (!arquivo) return false;
+    if (tamanho >= arquivo->tamanho) return true;
+
+    // Páginas além do novo fim são descartadas; a última fica zerada depois dele
+    for (int b = 0; b < NRO_BALDES_WAL; b++) {
+        PaginaWal **anterior = &arquivo->baldes[b];
+        while (*anterior) {
+            PaginaWal *pag = *anterior;
+            if (pag->numero * TAM_PAGINA_WAL >= tamanho) {
+                if (pag->pendente) logAtivo->nroPendentes--;
+                if (pag->dados) logAtivo->nroResidentes--;
+                *anterior = pag->proxima;
+                free(pag->dados);
+                free(pag);
+            } else {
+                if (pag->numero == tamanho / TAM_PAGINA_WAL) {
+                    int inicio = tamanho % TAM_PAGINA_WAL;
+                    if (pag->dados) memset(pag->dados + inicio, 0, TAM_PAGINA_WAL - inicio);
+                    else if (pag->bytesLog > inicio) pag->bytesLog = inicio;
+                }
+                anterior = &pag->proxima;
+            }
+        }
+    }
+
+    arquivo->tamanho = tamanho;
+    if (tamanho < arquivo->tamanhoDisco) arquivo->tamanhoDisco = tamanho;
+    arquivo->truncado = true;
+    arquivo->truncamentoPendente = true;
+    return true;
+}
+
+/**
+ * @brief Confirma a operação: grava o grupo pendente e o registro de fim de operação (um único fsync do log)
+ * @return true se a operação está no disco
+ */
+bool wal_confirmar(void) {
+    LogRefazer *wal = logAtivo;
+    if (!wal || wal->falhou) return false;
+
+    bool truncamentos = false;
+    for (int i = 0; i < wal->nroArquivos; i++) {
+        if (wal->arquivos[i]->truncamentoPendente) truncamentos = true;
+    }
+    if (wal->nroPendentes == 0 && !truncamentos && !wal->gruposAbertos) return true;
+
+    bool ok = true;
+    if (wal->nroPendentes > 0 || truncamentos) ok = gravarGrupo(wal);
+
+    // Só com o registro 'F' os grupos da operação passam a valer na recuperação
+    ok = ok && fwrite("F", 1, 1, wal->log) == 1;
+    wal->tamanhoLog += 1;
+    ok = ok && fflush(wal->log) == 0 && fsync(fileno(wal->log)) == 0;
+
+    if (ok) {
+        wal->gruposAbertos = false;
+        wal->confirmado = true;
+    } else {
+        wal->falhou = true;
+    }
+    return ok;
+}
+
+/**
+ * @brief Confirma a operação, aplica as páginas aos arquivos e esvazia o log
+ *
+ * Páginas descarregadas no log durante a operação são lidas de lá.
+ *
+ * @return true em caso de sucesso
+ */
+bool wal_checkpoint(void) {
+    LogRefazer *wal = logAtivo;
+    if (!wal || !wal_confirmar()) return false;
+
+    bool ok = true;
+    unsigned char imagem[TAM_PAGINA_WAL];
+    for (int i = 0; i < wal->nroArquivos; i++) {
+        ArquivoWal *arquivo = wal->arquivos[i];
+        for (int b = 0; b < NRO_BALDES_WAL; b++) {
+            for (PaginaWal *pag = arquivo->baldes[b]; pag; pag = pag->proxima) {
+                int validos = bytesValidos(pag->numero, arquivo->tamanho);
+                ok = ok && lerImagem(pag, imagem, 0, validos) &&
+                     gravarEm(arquivo->fd, imagem, validos, pag->numero * TAM_PAGINA_WAL);
+            }
+        }
+        if (arquivo->truncado) {
+            ok = ok && ftruncate(arquivo->fd, arquivo->tamanho) == 0;
+            arquivo->truncado = false;
+        }
+        ok = ok && fsync(arquivo->fd) == 0;
+        liberarPaginas(arquivo);
+        arquivo->tamanhoDisco = arquivo->tamanho;
+        arquivo->noLog = false;
+    }
+    wal->nroResidentes = 0;
+
+    // Só com os arquivos no disco o log pode ser esvaziado
+    if (ok) {
+        ok = fflush(wal->log) == 0 && ftruncate(fileno(wal->log), 0) == 0 &&
+             fseek(wal->log, 0, SEEK_SET) == 0 &&
+             fwrite(IDENTIFICADOR_WAL, 1, 4, wal->log) == 4 &&
+             fflush(wal->log) == 0 && fsync(fileno(wal->log)) == 0;
+        wal->tamanhoLog = 4;
+        wal->confirmado = false;
+    }
+    return ok;
+}
+
+/**
+ * @brief Encerra o lote: checkpoint, remoção do log e liberação das páginas
+ *
+ * Um lote que perdeu uma escrita não é confirmado: seus grupos ficam sem o
+ * registro de fim de operação e o log é descartado, sem tocar nos arquivos.
+ *
+ * @return true em caso de sucesso (ou se não havia lote)
+ */
+bool wal_encerrar(void) {
+    LogRefazer *wal = logAtivo;
+    if (!wal) return true;
+
+    bool ok = wal_checkpoint();
+    bool descartar = ok || (wal->falhou && !wal->confirmado);
+    fclose(wal->log);
+
+    for (int i = 0; i < wal->nroArquivos; i++) {
+        if (descartar) {
+            char *vinculo = nomeArquivoLog(wal->arquivos[i]->nome);
+            if (vinculo && strcmp(vinculo, wal->nomeLog) != 0) remove(vinculo);
+            free(vinculo);
+        }
+        liberarPaginas(wal->arquivos[i]);
+        close(wal->arquivos[i]->fd);
+        free(wal->arquivos[i]->nome);
+        free(wal->arquivos[i]);
+    }
+    if (descartar) remove(wal->nomeLog);
+    free(wal->nomeLog);
+    free(wal);
+    logAtivo = NULL;
+    return ok;
+}
+
+// ================= RECUPERAÇÃO =================
+
+/**
+ * @brief Lê um registro do log; 'A', 'T' e 'P' são aplicados se aplicar for verdadeiro
+ *
+ * Um registro 'F' só é aceito entre grupos, logo após um 'C'.
+ *
+ * @param log Log aberto, posicionado no início do registro
+ * @param aplicar Se falso, o registro é apenas validado
+ * @param fds Descritores dos arquivos citados (por id)
+ * @param nomes Nomes dos arquivos citados (por id), guardados na primeira vez
+ * @param soma Soma do grupo em andamento
+ * @param paginas Páginas do grupo em andamento
+ * @return Tipo do registro lido ou 0 se o log termina (ou está truncado) aqui
+ */
+static char lerRegistroLog(FILE *log, bool aplicar, int fds[], char *nomes[], uint32_t *soma, int *paginas) {
+    char tipo;
+    if (fread(&tipo, 1, 1, log) != 1) return 0;
+
+    if (tipo == 'C') {
+        int nroPaginas;
+        uint32_t somaGravada;
+        if (fread(&nroPaginas, sizeof(int), 1, log) != 1 ||
+            fread(&somaGravada, sizeof(uint32_t), 1, log) != 1 ||
+            nroPaginas != *paginas || somaGravada != *soma) {
+            return 0;
+        }
+        return 'C';
+    }
+    if (tipo == 'F') {
+        return (*paginas == 0 && *soma == 2166136261u) ? 'F' : 0;
+    }
+
+    *soma = somarBytes(*soma, &tipo, 1);
+    int id;
+    if (fread(&id, sizeof(int), 1, log) != 1 || id < 0 || id >= MAX_ARQUIVOS_WAL) return 0;
+    *soma = somarBytes(*soma, &id, sizeof(int));
+
+    if (tipo == 'A') {
+        int tamanhoNome;
+        if (fread(&tamanhoNome, sizeof(int), 1, log) != 1 || tamanhoNome <= 0 || tamanhoNome > 4096) return 0;
+        char *nome = malloc(tamanhoNome + 1);
+        if (!nome || fread(nome, 1, tamanhoNome, log) != (size_t)tamanhoNome) {
+            free(nome);
+            return 0;
+        }
+        nome[tamanhoNome] = '\0';
+        *soma = somarBytes(*soma, &tamanhoNome, sizeof(int));
+        *soma = somarBytes(*soma, nome, tamanhoNome);
+        if (aplicar && fds[id] < 0) fds[id] = open(nome, O_RDWR);
+        if (!nomes[id]) nomes[id] = nome;
+        else free(nome);
+        return 'A';
+    }
+
+    if (tipo == 'T') {
+        long long tamanho;
+        if (fread(&tamanho, sizeof(long long), 1, log) != 1 || tamanho < 0) return 0;
+        *soma = somarBytes(*soma, &tamanho, sizeof(long long));
+        if (aplicar && (fds[id] < 0 || ftruncate(fds[id], tamanho) != 0)) return 0;
+        return 'T';
+    }
+
+    if (tipo == 'P') {
+        long long numero, tamanho;
+        int validos;
+        unsigned char dados[TAM_PAGINA_WAL];
+        if (fread(&numero, sizeof(long long), 1, log) != 1 ||
+            fread(&tamanho, sizeof(long long), 1, log) != 1 ||
+            fread(&validos, sizeof(int), 1, log) != 1 ||
+            validos < 0 || validos > TAM_PAGINA_WAL ||
+            fread(dados, 1, validos, log) != (size_t)validos) {
+            return 0;
+        }
+        *soma = somarBytes(*soma, &numero, sizeof(long long));
+        *soma = somarBytes(*soma, &tamanho, sizeof(long long));
+        *soma = somarBytes(*soma, &validos, sizeof(int));
+        *soma = somarBytes(*soma, dados, validos);
+        (*paginas)++;
+        if (aplicar && (fds[id] < 0 || !gravarEm(fds[id], dados, validos, numero * TAM_PAGINA_WAL))) return 0;
+        return 'P';
+    }
+    return 0;
+}
+
+/**
+ * @brief Refaz os grupos confirmados de um log deixado por um lote interrompido
+ *
+ * Uma primeira passada encontra o último registro de fim de operação ('F')
+ * precedido de grupos íntegros; a segunda reaplica as páginas até ali. Grupos
+ * descarregados por uma operação que não chegou ao fim são descartados. As imagens são de páginas inteiras,
+ * então reaplicar o que já chegou aos arquivos não muda nada. O log é
+ * alcançado pelo nome de qualquer arquivo do lote; depois de refeito, todos
+ * os seus nomes são removidos.
+ *
+ * @param nome Nome de um arquivo do lote (o de dados ou o índice)
+ * @return Número de páginas reaplicadas, 0 se não havia log, -1 em caso de falha
+ */
+int wal_recuperar(const char *nome) {
+    char *nomeLog = nomeArquivoLog(nome);
+    if (!nomeLog) return -1;
+    FILE *log = fopen(nomeLog, "rb");
+    if (!log) {
+        free(nomeLog);
+        return 0;
+    }
+
+    char identificador[4];
+    int fds[MAX_ARQUIVOS_WAL];
+    char *nomes[MAX_ARQUIVOS_WAL] = {NULL};
+    for (int i = 0; i < MAX_ARQUIVOS_WAL; i++) fds[i] = -1;
+
+    long long fimConfirmado = -1;
+    int aplicadas = 0;
+    if (fread(identificador, 1, 4, log) == 4 && memcmp(identificador, IDENTIFICADOR_WAL, 4) == 0) {
+        // Primeira passada: só valida
+        uint32_t soma = 2166136261u;
+        int paginas = 0, daOperacao = 0, total = 0;
+        char tipo;
+        while ((tipo = lerRegistroLog(log, false, fds, nomes, &soma, &paginas)) != 0) {
+            if (tipo == 'C') {
+                daOperacao += paginas;
+                soma = 2166136261u;
+                paginas = 0;
+            } else if (tipo == 'F') {
+                fimConfirmado = ftell(log);
+                total += daOperacao;
+                daOperacao = 0;
+            }
+        }
+
+        // Segunda passada: aplica até o último grupo confirmado
+        fseek(log, 4, SEEK_SET);
+        soma = 2166136261u;
+        paginas = 0;
+        while (fimConfirmado > 0 && ftell(log) < fimConfirmado) {
+            tipo = lerRegistroLog(log, true, fds, nomes, &soma, &paginas);
+            if (tipo == 0) {
+                aplicadas = -1;
+                break;
+            }
+            if (tipo == 'C') {
+                soma = 2166136261u;
+                paginas = 0;
+            }
+        }
+        if (aplicadas == 0) aplicadas = total;
+    }
+    fclose(log);
+
+    for (int i = 0; i < MAX_ARQUIVOS_WAL; i++) {
+        if (fds[i] < 0) continue;
+        if (fsync(fds[i]) != 0) aplicadas = -1;
+        close(fds[i]);
+    }
+
+    // Com as páginas no disco (ou sem nada confirmado), o log não é mais necessário
+    for (int i = 0; i < MAX_ARQUIVOS_WAL; i++) {
+        if (!nomes[i]) continue;
+        char *vinculo = aplicadas >= 0 ? nomeArquivoLog(nomes[i]) : NULL;
+        if (vinculo && strcmp(vinculo, nomeLog) != 0) remove(vinculo);
+        free(vinculo);
+        free(nomes[i]);
+    }
+    if (aplicadas >= 0) remove(nomeLog);
+    free(nomeLog);
+    return aplicadas;
+}
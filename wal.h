@@ -0,0 +1,119 @@
+/**
+ * @file wal.h
+ * @brief Log de refazer (write-ahead log) compartilhado pelo arquivo de dados e pelo índice
+ *
+ * Durante um lote (wal_iniciar .. wal_encerrar), os arquivos abertos com
+ * wal_fopen não são escritos diretamente: as escritas vão para páginas de
+ * TAM_PAGINA_WAL bytes, e as leituras enxergam essas páginas. Quando mais
+ * de LIMITE_PAGINAS_WAL imagens estão em memória (ou falta memória), as
+ * páginas alteradas são descarregadas em "<dados>.wal" como um grupo,
+ * fechado por um registro 'C', e passam a ser lidas de lá.
+ *
+ * O lote corresponde a uma operação inteira. wal_confirmar grava o último
+ * grupo e o registro de fim de operação, com um único fsync do log; o
+ * checkpoint aplica então as páginas aos arquivos, sincroniza-os e esvazia
+ * o log. wal_recuperar só reaplica grupos seguidos de um registro de fim de
+ * operação: um lote interrompido antes dele não deixa rastro nos arquivos,
+ * nem um lote que perdeu uma escrita por falta de memória, que wal_encerrar
+ * descarta. Os outros arquivos do lote ganham "<arquivo>.wal" como outro
+ * nome (link) do log, e wal_fopen refaz o log antes de abrir qualquer um
+ * deles.
+ *
+ * Formato de "<dados>.wal": identificador "WAL1" seguido de registros
+ *  - 'A': id (int), tamanho do nome (int), nome — arquivo citado pelas páginas;
+ *  - 'T': id (int), novo tamanho (long long) — truncamento do arquivo;
+ *  - 'P': id (int), número da página (long long), tamanho lógico do
+ *         arquivo (long long), bytes válidos (int), bytes — imagem da página;
+ *  - 'C': número de páginas do grupo (int), soma de verificação (unsigned
+ *         int, FNV-1a dos registros do grupo) — fim do grupo;
+ *  - 'F': sem campos, logo após um 'C' — fim da operação.
+ */
+
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define TAM_PAGINA_WAL 4096
+#define MAX_ARQUIVOS_WAL 8
+#define IDENTIFICADOR_WAL "WAL1"
+
+/**
+ * @brief Inicia um lote com log de refazer para o arquivo de dados
+ *
+ * Antes, refaz o que houver confirmado em um log deixado por um lote
+ * interrompido.
+ *
+ * @param binaryFile Nome do arquivo de dados (o log é "<dados>.wal")
+ * @return true se o log foi criado; com false, wal_fopen abre os arquivos diretamente
+ */
+bool wal_iniciar(const char *binaryFile);
+
+/**
+ * @brief Abre um arquivo do lote
+ *
+ * Com um lote ativo e modo "rb", "rb+", "wb" ou "wb+", devolve um FILE cujas
+ * leituras e escritas passam pelas páginas do log; com "wb" e "wb+", o arquivo
+ * é criado vazio se não existir, e o esvaziamento de um existente é um
+ * truncamento do lote. Senão, equivale a fopen, precedido de wal_recuperar
+ * quando não há lote ativo. fileno()
+ * não se aplica ao FILE devolvido, e a glibc não avança a posição que guarda
+ * ao gravar por ele: depois de uma escrita, ftell e fseek(SEEK_CUR) só valem
+ * após um fflush ou um fseek(SEEK_SET).
+ *
+ * @param nome Nome do arquivo
+ * @param modo Modo de abertura
+ * @return Arquivo aberto ou NULL em caso de falha
+ */
+FILE *wal_fopen(const char *nome, const char *modo);
+
+/**
+ * @brief Trunca um arquivo do lote
+ *
+ * Com um lote ativo, o truncamento vale para as leituras do lote, vai ao log
+ * na confirmação e só chega ao arquivo no checkpoint; senão, o arquivo é
+ * truncado diretamente. Um FILE aberto sobre o arquivo deve ter sido
+ * esvaziado (fflush) antes.
+ *
+ * @param nome Nome do arquivo
+ * @param tamanho Novo tamanho
+ * @return true em caso de sucesso
+ */
+bool wal_truncar(const char *nome, long long tamanho);
+
+/**
+ * @brief Confirma a operação: grupo pendente e registro de fim de operação (um único fsync do log)
+ *
+ * Só deve ser chamada com a operação concluída e os arquivos consistentes;
+ * wal_encerrar já a chama.
+ *
+ * @return true se a operação está no disco (ou não havia nada a confirmar);
+ *         false também se o lote perdeu uma escrita
+ */
+bool wal_confirmar(void);
+
+/**
+ * @brief Confirma a operação, aplica as páginas aos arquivos e esvazia o log
+ * @return true em caso de sucesso
+ */
+bool wal_checkpoint(void);
+
+/**
+ * @brief Encerra o lote: checkpoint, remoção do log e liberação das páginas
+ *
+ * Deve ser chamada depois de fechados os arquivos abertos com wal_fopen. Se
+ * uma escrita do lote se perdeu, nada é aplicado aos arquivos.
+ *
+ * @return true em caso de sucesso ou se não havia lote ativo
+ */
+bool wal_encerrar(void);
+
+/**
+ * @brief Refaz os grupos confirmados de um log deixado por um lote interrompido
+ * @param nome Nome de um arquivo do lote (o log é "<nome>.wal")
+ * @return Número de páginas reaplicadas, 0 se não havia log, -1 em caso de falha
+ */
+int wal_recuperar(const char *binaryFile);
+
+#endif // WAL_H